@@ -0,0 +1,343 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Assets archive
+*
+*   Memory mapped assets archive and LZ4 block decompression.
+*
+**********************************************************************************************/
+
+#include "asset_pack.h"
+
+#include <stdio.h>      // Required for: FILE, fopen(), fread(), fclose()
+#include <stdlib.h>     // Required for: malloc(), free()
+#include <string.h>     // Required for: memcmp(), memcpy(), strcmp()
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+    #include <fcntl.h>      // Required for: open()
+    #include <sys/mman.h>   // Required for: mmap(), munmap()
+    #include <sys/stat.h>   // Required for: fstat()
+    #include <unistd.h>     // Required for: close()
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const unsigned char *packData = NULL;    // Archive data, mapped or in memory
+static size_t packSize = 0;
+static const AssetPackEntry *packEntries = NULL;
+static int packEntryCount = 0;
+static bool packMapped = false;                 // Archive data is a file mapping, otherwise owned memory
+
+#if defined(_WIN32)
+static HANDLE packFile = INVALID_HANDLE_VALUE;
+static HANDLE packMapping = NULL;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static bool MapAssetPackFile(const char *fileName);     // Map archive file into memory (read whole file if mapping not supported)
+static void UnmapAssetPackFile(void);                   // Unmap archive file
+static bool ValidateAssetPack(void);                    // Validate archive header and index, sets entries
+static const AssetPackEntry *FindAssetPackEntry(const char *name);  // Find archive entry by name (binary search)
+
+//----------------------------------------------------------------------------------
+// Assets Archive Functions Definition
+//----------------------------------------------------------------------------------
+
+// Open assets archive, memory mapped if supported
+// NOTE: Entries are not touched, pages are loaded on first access to every entry
+bool OpenAssetPack(const char *fileName)
+{
+    CloseAssetPack();
+
+    if (!MapAssetPackFile(fileName)) return false;
+
+    if (!ValidateAssetPack())
+    {
+        CloseAssetPack();
+        return false;
+    }
+
+    return true;
+}
+
+// Open assets archive from memory, takes ownership of data (malloc)
+// NOTE: Used on web, where the archive is fetched in a single request
+bool OpenAssetPackFromMemory(unsigned char *data, int dataSize)
+{
+    CloseAssetPack();
+
+    if ((data == NULL) || (dataSize <= 0))
+    {
+        free(data);
+        return false;
+    }
+
+    packData = data;
+    packSize = (size_t)dataSize;
+    packMapped = false;
+
+    if (!ValidateAssetPack())
+    {
+        CloseAssetPack();
+        return false;
+    }
+
+    return true;
+}
+
+// Close assets archive, entries data pointing into it gets invalid
+void CloseAssetPack(void)
+{
+    if (packData != NULL)
+    {
+        if (packMapped) UnmapAssetPackFile();
+        else free((void *)packData);
+    }
+
+    packData = NULL;
+    packSize = 0;
+    packEntries = NULL;
+    packEntryCount = 0;
+    packMapped = false;
+}
+
+// Check if an assets archive is open
+bool IsAssetPackOpen(void)
+{
+    return (packData != NULL);
+}
+
+// Load archive entry data, can be called from any thread
+// NOTE: Stored entries point into the archive (no copy), compressed entries are decompressed into a new buffer
+bool LoadAssetPackData(const char *name, AssetPackData *data)
+{
+    *data = (AssetPackData){ 0 };
+
+    const AssetPackEntry *entry = FindAssetPackEntry(name);
+    if (entry == NULL) return false;
+
+    if (entry->flags & ASSET_PACK_FLAG_LZ4)
+    {
+        unsigned char *buffer = (unsigned char *)malloc(entry->rawSize);
+        if (buffer == NULL) return false;
+
+        if (DecompressLZ4(packData + entry->offset, (int)entry->size, buffer, (int)entry->rawSize) != (int)entry->rawSize)
+        {
+            free(buffer);
+            return false;
+        }
+
+        data->data = buffer;
+        data->buffer = buffer;
+    }
+    else data->data = packData + entry->offset;
+
+    data->dataSize = (int)entry->rawSize;
+
+    return true;
+}
+
+// Unload archive entry data
+void UnloadAssetPackData(AssetPackData *data)
+{
+    free(data->buffer);
+    *data = (AssetPackData){ 0 };
+}
+
+// Decompress LZ4 block, returns decompressed size or -1 on invalid data
+// NOTE: Every read and write is bounds checked, archive data is not trusted
+int DecompressLZ4(const unsigned char *src, int srcSize, unsigned char *dst, int dstSize)
+{
+    const unsigned char *ip = src;
+    const unsigned char *ipEnd = src + srcSize;
+    unsigned char *op = dst;
+    unsigned char *opEnd = dst + dstSize;
+
+    while (ip < ipEnd)
+    {
+        const unsigned int token = *ip++;
+
+        // Literals
+        size_t literalLength = token >> 4;
+        if (literalLength == 15)
+        {
+            unsigned int value = 255;
+            while (value == 255)
+            {
+                if (ip >= ipEnd) return -1;
+                value = *ip++;
+                literalLength += value;
+            }
+        }
+
+        if (((size_t)(ipEnd - ip) < literalLength) || ((size_t)(opEnd - op) < literalLength)) return -1;
+        memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == ipEnd) break;     // Last sequence has literals only
+
+        // Match
+        if ((ipEnd - ip) < 2) return -1;
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if ((offset == 0) || (offset > (size_t)(op - dst))) return -1;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15)
+        {
+            unsigned int value = 255;
+            while (value == 255)
+            {
+                if (ip >= ipEnd) return -1;
+                value = *ip++;
+                matchLength += value;
+            }
+        }
+        matchLength += 4;
+
+        if ((size_t)(opEnd - op) < matchLength) return -1;
+
+        // NOTE: Match can overlap output (offset < length), copied byte by byte
+        const unsigned char *match = op - offset;
+        for (size_t i = 0; i < matchLength; i++) op[i] = match[i];
+        op += matchLength;
+    }
+
+    return (int)(op - dst);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Map archive file into memory (read whole file if mapping not supported)
+static bool MapAssetPackFile(const char *fileName)
+{
+#if defined(_WIN32)
+    packFile = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (packFile == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size = { 0 };
+    if (GetFileSizeEx(packFile, &size) && (size.QuadPart > 0)) packMapping = CreateFileMappingA(packFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (packMapping != NULL) packData = (const unsigned char *)MapViewOfFile(packMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (packData == NULL)
+    {
+        UnmapAssetPackFile();
+        return false;
+    }
+
+    packSize = (size_t)size.QuadPart;
+    packMapped = true;
+#elif defined(__EMSCRIPTEN__)
+    // NOTE: No file mapping on web, archive is read from the virtual file system
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *data = (size > 0)? (unsigned char *)malloc(size) : NULL;
+    if ((data != NULL) && (fread(data, 1, size, file) != (size_t)size))
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    if (data == NULL) return false;
+
+    packData = data;
+    packSize = (size_t)size;
+    packMapped = false;
+#else
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat info = { 0 };
+    void *data = MAP_FAILED;
+    if ((fstat(file, &info) == 0) && (info.st_size > 0)) data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);    // NOTE: Mapping keeps its own reference to the file
+
+    if (data == MAP_FAILED) return false;
+
+    packData = (const unsigned char *)data;
+    packSize = (size_t)info.st_size;
+    packMapped = true;
+#endif
+
+    return true;
+}
+
+// Unmap archive file
+static void UnmapAssetPackFile(void)
+{
+#if defined(_WIN32)
+    if (packData != NULL) UnmapViewOfFile(packData);
+    if (packMapping != NULL) CloseHandle(packMapping);
+    if (packFile != INVALID_HANDLE_VALUE) CloseHandle(packFile);
+    packMapping = NULL;
+    packFile = INVALID_HANDLE_VALUE;
+#elif !defined(__EMSCRIPTEN__)
+    if (packData != NULL) munmap((void *)packData, packSize);
+#endif
+
+    packData = NULL;
+}
+
+// Validate archive header and index, sets entries
+// NOTE: Every entry range is checked once here, so lookups do not need to
+static bool ValidateAssetPack(void)
+{
+    AssetPackHeader header = { 0 };
+    if (packSize < sizeof(AssetPackHeader)) return false;
+    memcpy(&header, packData, sizeof(AssetPackHeader));
+
+    if ((memcmp(header.magic, "STPK", 4) != 0) || (header.version != ASSET_PACK_VERSION)) return false;
+    if ((header.indexOffset%sizeof(unsigned int)) != 0) return false;
+    if ((header.indexOffset > packSize) || (header.entryCount > (packSize - header.indexOffset)/sizeof(AssetPackEntry))) return false;
+
+    const AssetPackEntry *entries = (const AssetPackEntry *)(packData + header.indexOffset);
+
+    for (unsigned int i = 0; i < header.entryCount; i++)
+    {
+        const AssetPackEntry *entry = &entries[i];
+
+        if (entry->name[MAX_ASSET_PACK_NAME_LENGTH - 1] != '\0') return false;
+        if ((entry->offset > packSize) || (entry->size > packSize - entry->offset)) return false;
+        if (!(entry->flags & ASSET_PACK_FLAG_LZ4) && (entry->size != entry->rawSize)) return false;
+        if ((i > 0) && (strcmp(entries[i - 1].name, entry->name) >= 0)) return false;
+    }
+
+    packEntries = entries;
+    packEntryCount = (int)header.entryCount;
+
+    return true;
+}
+
+// Find archive entry by name (binary search)
+static const AssetPackEntry *FindAssetPackEntry(const char *name)
+{
+    int low = 0;
+    int high = packEntryCount - 1;
+
+    while (low <= high)
+    {
+        const int middle = low + (high - low)/2;
+        const int order = strcmp(packEntries[middle].name, name);
+
+        if (order == 0) return &packEntries[middle];
+        else if (order < 0) low = middle + 1;
+        else high = middle - 1;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,81 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Assets archive
+*
+*   Single indexed archive with all resources, built by StopThePumpPack at build time.
+*   Archive is memory mapped (read into memory on web) and entries are returned in place,
+*   entries data is aligned to ASSET_PACK_ALIGNMENT. Entries can be stored LZ4 compressed
+*   (block format), those are decompressed into a new buffer on load.
+*
+*   Archive layout (little endian):
+*       AssetPackHeader
+*       AssetPackEntry[entryCount]      // Sorted by name, looked up with binary search
+*       Entries data                    // Every entry aligned to ASSET_PACK_ALIGNMENT
+*
+*   NOTE: Implementation includes <windows.h> on Windows, so it must not include raylib.h
+*
+**********************************************************************************************/
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define ASSET_PACK_VERSION          1
+#define ASSET_PACK_ALIGNMENT        64          // Entries data alignment (bytes)
+#define MAX_ASSET_PACK_NAME_LENGTH  80          // Including null terminator
+
+#define ASSET_PACK_FLAG_LZ4         1           // Entry data is LZ4 compressed (block format)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Archive header
+typedef struct AssetPackHeader {
+    char magic[4];                  // "STPK"
+    unsigned int version;           // ASSET_PACK_VERSION
+    unsigned int entryCount;
+    unsigned int indexOffset;       // Entries index offset from archive start
+} AssetPackHeader;
+
+// Archive index entry
+typedef struct AssetPackEntry {
+    char name[MAX_ASSET_PACK_NAME_LENGTH];  // Resource path as requested by the game, i.e. "resources/coin.wav"
+    unsigned int offset;            // Data offset from archive start
+    unsigned int size;              // Stored data size
+    unsigned int rawSize;           // Uncompressed data size
+    unsigned int flags;             // ASSET_PACK_FLAG_*
+} AssetPackEntry;
+
+// Archive entry data
+typedef struct AssetPackData {
+    const unsigned char *data;      // Entry data, points into the archive if entry is stored uncompressed
+    int dataSize;
+    unsigned char *buffer;          // Decompressed data buffer (owned), NULL if data points into the archive
+} AssetPackData;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Assets Archive Functions Declaration
+//----------------------------------------------------------------------------------
+bool OpenAssetPack(const char *fileName);                           // Open assets archive, memory mapped if supported
+bool OpenAssetPackFromMemory(unsigned char *data, int dataSize);    // Open assets archive from memory, takes ownership of data (malloc)
+void CloseAssetPack(void);                                          // Close assets archive, entries data pointing into it gets invalid
+bool IsAssetPackOpen(void);                                         // Check if an assets archive is open
+bool LoadAssetPackData(const char *name, AssetPackData *data);      // Load archive entry data, can be called from any thread
+void UnloadAssetPackData(AssetPackData *data);                      // Unload archive entry data
+
+int DecompressLZ4(const unsigned char *src, int srcSize, unsigned char *dst, int dstSize);  // Decompress LZ4 block, returns decompressed size or -1 on invalid data
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,944 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Assets registry
+*
+*   Ref-counted registry for models, sounds, fonts and music shared by all screens.
+*   Every asset is loaded once on first acquire and unloaded when its last reference is released,
+*   so screens can acquire/release on Init/Unload without reloading data on every entry.
+*
+*   Assets can be preloaded from any thread: file data is loaded and decoded on CPU side and
+*   kept pending until acquired on the main thread, where only GPU/audio device upload is left.
+*
+*   Assets can also be requested asynchronously: loader threads decode them while the main thread
+*   keeps rendering, and UpdateAssetLoading() uploads decoded assets within a per-frame time budget.
+*   If loader threads can not be started (i.e. web without pthreads), requests are decoded on the
+*   main thread by UpdateAssetLoading(), one asset at a time.
+*
+*   Asset files are read from the assets archive when one is open (stored entries are used in
+*   place, no copy), falling back to loose files otherwise.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"       // Required for: rlGetTextureIdDefault()
+#include "screens.h"
+#include "voxel_mesh.h" // Required for: LoadVoxelModel(), LoadVoxelMeshLods(), LoadModelFromVoxelMeshLods()
+#include "threads.h"    // Required for: Thread, Mutex, Condition
+#include "asset_pack.h" // Required for: LoadAssetPackData()
+#include "sdf_font.h"   // Required for: LoadFontSdfFromMemory(), GenFontSdfFromImage(), UploadFontSdf()
+
+#include <string.h>     // Required for: strncpy(), strcmp(), strlen(), memcpy(), memmove()
+#include <stdlib.h>     // Required for: free()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_ASSETS              32
+#define MAX_ASSET_PATH_LENGTH  256
+#define MAX_PRELOADED_ASSETS     8
+#define MAX_ASSET_LOADER_THREADS 2
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Asset loading state, asynchronous requests go from queued to ready (or failed)
+typedef enum AssetState {
+    ASSET_STATE_READY = 0,          // Asset data loaded and uploaded
+    ASSET_STATE_QUEUED,             // Waiting for a loader thread
+    ASSET_STATE_DECODING,           // Being decoded on CPU side
+    ASSET_STATE_DECODED,            // Decoded, waiting for upload on main thread
+    ASSET_STATE_FAILED              // Loading failed, asset data is empty
+} AssetState;
+
+// Asset file data, read from the assets archive or from a loose file
+typedef struct AssetFileData {
+    const unsigned char *data;
+    int dataSize;
+    unsigned char *fileData;        // Loose file data (LoadFileData()), NULL if read from archive
+    AssetPackData packData;         // Archive entry data
+} AssetFileData;
+
+// Preloaded asset data, decoded on CPU side and waiting to be acquired
+typedef struct PreloadedAsset {
+    AssetType type;
+    char fileName[MAX_ASSET_PATH_LENGTH];
+    bool used;
+    Mesh meshes[VOXEL_LOD_COUNT];   // ASSET_MODEL (.vox only), levels of detail
+    int meshCount;
+    Wave wave;                      // ASSET_SOUND, in mixer format
+    Image image;                    // ASSET_FONT (image fonts, SDF fonts atlas)
+    Font font;                      // ASSET_FONT (SDF fonts only), glyphs and recs, texture not loaded
+    AssetFileData file;             // ASSET_MUSIC, compressed file data streamed by the music decoder
+} PreloadedAsset;
+
+typedef struct AssetEntry {
+    AssetType type;
+    char fileName[MAX_ASSET_PATH_LENGTH];
+    int refCount;                   // Number of live references, slot is free when 0
+    AssetState state;
+    long long cpuBytes;             // Resident data size on CPU side (estimated at load)
+    long long gpuBytes;             // Resident data size on GPU side (estimated at load)
+    Model model;                    // Asset data, only the member matching type is valid
+    MixerSound sound;
+    Font font;
+    Music music;
+    AssetFileData musicFile;        // Music file data, must outlive the music stream
+    PreloadedAsset decoded;         // Decoded data of asynchronous request, waiting for upload
+} AssetEntry;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static AssetEntry assets[MAX_ASSETS] = { 0 };
+static PreloadedAsset preloaded[MAX_PRELOADED_ASSETS] = { 0 };
+static Mutex *assetsMutex = NULL;           // Guards registry and preloaded assets, preloads run on worker threads
+
+// Asynchronous loading, requests queue is guarded by registry mutex
+static Thread *loaderThreads[MAX_ASSET_LOADER_THREADS] = { 0 };
+static int loaderThreadCount = 0;
+static bool loaderStarted = false;
+static bool loaderShutdown = false;
+static Condition *loaderRequested = NULL;   // Signaled when a request is queued or on shutdown
+static Condition *loaderDecoded = NULL;     // Signaled when a request has been decoded
+static AssetHandle loadQueue[MAX_ASSETS] = { 0 };
+static int loadQueueCount = 0;
+static int loadRequestedCount = 0;          // Requests since loading was last idle, for progress (main thread only)
+static int loadCompletedCount = 0;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static bool LoadAssetEntry(AssetEntry *entry, PreloadedAsset *preload);   // Load asset data (from preloaded data if available) and compute its memory footprint
+static bool DecodeAsset(AssetType type, const char *fileName, PreloadedAsset *preload);    // Decode asset data on CPU side, safe to call from any thread
+static void StartAssetLoader(void);                 // Start loader threads (registry mutex must exist)
+static void StopAssetLoader(void);                  // Stop loader threads, queued requests are left queued
+static void AssetLoaderThread(void *userData);      // Loader thread function, decodes queued requests
+static void DecodeAssetRequest(AssetHandle handle); // Decode request, marks it decoded (registry mutex must be unlocked)
+static void UploadAssetRequest(AssetHandle handle); // Upload decoded request on main thread
+static void FinishAssetRequest(AssetHandle handle); // Finish request synchronously, waiting for or doing its decoding
+static bool RemoveQueuedRequest(AssetHandle handle);    // Remove request from loading queue (registry mutex must be locked)
+static bool IsAssetFileExtension(const char *fileName, const char *ext);  // Check file extension, no raylib static buffers used
+static bool LoadAssetFileData(const char *fileName, AssetFileData *file);  // Load asset file data, from assets archive if available
+static void UnloadAssetFileData(AssetFileData *file);  // Unload asset file data
+static bool TakePreloadedAsset(AssetType type, const char *fileName, PreloadedAsset *preload);  // Take preloaded asset data out of pending list
+static void UnloadPreloadedAsset(PreloadedAsset *preload);  // Unload preloaded asset data
+static void UnloadAssetEntry(AssetEntry *entry);    // Unload asset data and clear slot
+static long long GetMeshDataSize(Mesh mesh);        // Get size of mesh vertex data arrays
+static long long GetImageDataSize(Image image);     // Get size of image pixel data
+
+//----------------------------------------------------------------------------------
+// Assets Functions Definition
+//----------------------------------------------------------------------------------
+
+// Acquire asset reference, loading it if not resident yet
+// NOTE: Must be called from main thread, first call creates the registry mutex.
+// If the asset was requested asynchronously and is still loading, loading is finished synchronously
+AssetHandle AcquireAsset(AssetType type, const char *fileName)
+{
+    int freeSlot = -1;
+
+    if (assetsMutex == NULL) assetsMutex = LoadMutex();
+
+    LockMutex(assetsMutex);
+
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        if (assets[i].refCount > 0)
+        {
+            if ((assets[i].type == type) && TextIsEqual(assets[i].fileName, fileName))
+            {
+                assets[i].refCount++;
+                UnlockMutex(assetsMutex);
+
+                if (assets[i].state != ASSET_STATE_READY) FinishAssetRequest(i);
+                if (assets[i].state == ASSET_STATE_FAILED)
+                {
+                    ReleaseAsset(i);
+                    return ASSET_INVALID;
+                }
+
+                return i;
+            }
+        }
+        else if (freeSlot == -1) freeSlot = i;
+    }
+
+    PreloadedAsset preload = { 0 };
+    TakePreloadedAsset(type, fileName, &preload);
+
+    if (freeSlot >= 0)
+    {
+        // NOTE: Slot is reserved before unlocking, so preloads see it as loading
+        assets[freeSlot].type = type;
+        strncpy(assets[freeSlot].fileName, fileName, MAX_ASSET_PATH_LENGTH - 1);
+        assets[freeSlot].fileName[MAX_ASSET_PATH_LENGTH - 1] = '\0';
+        assets[freeSlot].refCount = 1;
+    }
+
+    UnlockMutex(assetsMutex);
+
+    if (freeSlot == -1)
+    {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Registry full, asset could not be loaded", fileName);
+        UnloadPreloadedAsset(&preload);
+        return ASSET_INVALID;
+    }
+
+    AssetEntry *entry = &assets[freeSlot];
+
+    // NOTE: Data not preloaded is decoded here, so it is also read from the assets archive
+    const bool preloaded = preload.used;
+    if (!preloaded) DecodeAsset(type, fileName, &preload);
+
+    if (!LoadAssetEntry(entry, preload.used? &preload : NULL))
+    {
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Failed to load asset", fileName);
+        LockMutex(assetsMutex);
+        UnloadAssetEntry(entry);
+        UnlockMutex(assetsMutex);
+        return ASSET_INVALID;
+    }
+
+    TraceLog(LOG_INFO, "ASSETS: [%s] Asset loaded%s (CPU: %lld bytes, GPU: %lld bytes)", fileName, preloaded? " from preload" : "", entry->cpuBytes, entry->gpuBytes);
+
+    return freeSlot;
+}
+
+// Request asset reference, loaded asynchronously by loader threads
+// NOTE: Must be called from main thread. Returned handle is valid but asset data is empty until
+// IsAssetReady(), uploads happen on UpdateAssetLoading() calls
+AssetHandle RequestAsset(AssetType type, const char *fileName)
+{
+    int freeSlot = -1;
+
+    if (assetsMutex == NULL) assetsMutex = LoadMutex();
+    if (!loaderStarted) StartAssetLoader();
+
+    LockMutex(assetsMutex);
+
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        if (assets[i].refCount > 0)
+        {
+            if ((assets[i].type == type) && TextIsEqual(assets[i].fileName, fileName))
+            {
+                assets[i].refCount++;
+                UnlockMutex(assetsMutex);
+                return i;
+            }
+        }
+        else if (freeSlot == -1) freeSlot = i;
+    }
+
+    if (freeSlot == -1)
+    {
+        UnlockMutex(assetsMutex);
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Registry full, asset could not be requested", fileName);
+        return ASSET_INVALID;
+    }
+
+    AssetEntry *entry = &assets[freeSlot];
+    entry->type = type;
+    strncpy(entry->fileName, fileName, MAX_ASSET_PATH_LENGTH - 1);
+    entry->fileName[MAX_ASSET_PATH_LENGTH - 1] = '\0';
+    entry->refCount = 1;
+
+    // NOTE: Data preloaded meanwhile is taken over, only upload is left
+    if (TakePreloadedAsset(type, fileName, &entry->decoded)) entry->state = ASSET_STATE_DECODED;
+    else
+    {
+        entry->state = ASSET_STATE_QUEUED;
+        loadQueue[loadQueueCount++] = freeSlot;
+        SignalCondition(loaderRequested);
+    }
+
+    UnlockMutex(assetsMutex);
+
+    // Progress restarts when a request arrives with loading idle
+    if (loadCompletedCount == loadRequestedCount)
+    {
+        loadRequestedCount = 0;
+        loadCompletedCount = 0;
+    }
+    loadRequestedCount++;
+
+    return freeSlot;
+}
+
+// Update asynchronous loading, uploads decoded assets until time budget (seconds) is spent
+// NOTE: Must be called from main thread, at least one asset is uploaded per call if available.
+// Returns the number of requested assets still loading
+int UpdateAssetLoading(float timeBudget)
+{
+    if (assetsMutex == NULL) return 0;
+
+    const double startTime = GetTime();
+
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        // NOTE: Without loader threads, requests are decoded here, within the same budget
+        if ((loaderThreadCount == 0) && (assets[i].refCount > 0) && (assets[i].state == ASSET_STATE_QUEUED))
+        {
+            LockMutex(assetsMutex);
+            RemoveQueuedRequest(i);
+            assets[i].state = ASSET_STATE_DECODING;
+            UnlockMutex(assetsMutex);
+
+            DecodeAssetRequest(i);
+        }
+
+        LockMutex(assetsMutex);
+        bool decoded = (assets[i].refCount > 0) && (assets[i].state == ASSET_STATE_DECODED);
+        UnlockMutex(assetsMutex);
+
+        if (decoded)
+        {
+            UploadAssetRequest(i);
+            if ((GetTime() - startTime) >= timeBudget) break;
+        }
+    }
+
+    return loadRequestedCount - loadCompletedCount;
+}
+
+// Wait for all requested assets to be loaded, finishing them synchronously
+// NOTE: Must be called from main thread, used when an asset is required before loading completes
+void WaitAssetLoading(void)
+{
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        if ((assets[i].refCount > 0) && (assets[i].state != ASSET_STATE_READY) && (assets[i].state != ASSET_STATE_FAILED)) FinishAssetRequest(i);
+    }
+}
+
+// Get asynchronous loading progress [0.0f..1.0f], 1.0f when nothing is loading
+float GetAssetLoadingProgress(void)
+{
+    if (loadRequestedCount == 0) return 1.0f;
+
+    return (float)loadCompletedCount/(float)loadRequestedCount;
+}
+
+// Check if asset is loaded and its data available (false if loading or failed)
+bool IsAssetReady(AssetHandle handle)
+{
+    if ((handle < 0) || (handle >= MAX_ASSETS) || (assets[handle].refCount <= 0)) return false;
+
+    LockMutex(assetsMutex);
+    bool ready = (assets[handle].state == ASSET_STATE_READY);
+    UnlockMutex(assetsMutex);
+
+    return ready;
+}
+
+// Preload asset data on CPU side, can be called from any thread
+// NOTE: Only data not requiring GPU/audio device is loaded (.vox meshes, waves, image fonts),
+// upload is completed by next AcquireAsset() on main thread. Returns false if nothing to preload.
+bool PreloadAsset(AssetType type, const char *fileName)
+{
+    if (assetsMutex == NULL) return false;
+
+    LockMutex(assetsMutex);
+
+    bool pending = false;
+    int freeSlot = -1;
+
+    for (int i = 0; i < MAX_ASSETS; i++) if ((assets[i].refCount > 0) && (assets[i].type == type) && TextIsEqual(assets[i].fileName, fileName)) pending = true;
+
+    for (int i = 0; i < MAX_PRELOADED_ASSETS; i++)
+    {
+        if (preloaded[i].used)
+        {
+            if ((preloaded[i].type == type) && TextIsEqual(preloaded[i].fileName, fileName)) pending = true;
+        }
+        else if (freeSlot == -1) freeSlot = i;
+    }
+
+    UnlockMutex(assetsMutex);
+
+    if (pending || (freeSlot == -1)) return false;
+
+    PreloadedAsset preload = { 0 };
+    if (!DecodeAsset(type, fileName, &preload)) return false;
+
+    LockMutex(assetsMutex);
+
+    // NOTE: Slot could have been taken by another preload meanwhile
+    if (preloaded[freeSlot].used)
+    {
+        UnlockMutex(assetsMutex);
+        UnloadPreloadedAsset(&preload);
+        return false;
+    }
+
+    preloaded[freeSlot] = preload;
+    UnlockMutex(assetsMutex);
+
+    TraceLog(LOG_DEBUG, "ASSETS: [%s] Asset preloaded", fileName);
+
+    return true;
+}
+
+// Release asset reference, asset is unloaded when no references are left
+// NOTE: Releasing the last reference of an asset still loading finishes its loading first
+void ReleaseAsset(AssetHandle handle)
+{
+    if ((handle < 0) || (handle >= MAX_ASSETS) || (assets[handle].refCount <= 0)) return;
+
+    if ((assets[handle].refCount == 1) && (assets[handle].state != ASSET_STATE_READY) && (assets[handle].state != ASSET_STATE_FAILED)) FinishAssetRequest(handle);
+
+    LockMutex(assetsMutex);
+
+    assets[handle].refCount--;
+
+    if (assets[handle].refCount == 0)
+    {
+        TraceLog(LOG_INFO, "ASSETS: [%s] Asset unloaded", assets[handle].fileName);
+        UnloadAssetEntry(&assets[handle]);
+    }
+
+    UnlockMutex(assetsMutex);
+}
+
+// Get model from asset handle
+Model GetAssetModel(AssetHandle handle)
+{
+    Model model = { 0 };
+
+    if ((handle >= 0) && (handle < MAX_ASSETS) && (assets[handle].refCount > 0) && (assets[handle].type == ASSET_MODEL) && (assets[handle].state == ASSET_STATE_READY)) model = assets[handle].model;
+    else TraceLog(LOG_WARNING, "ASSETS: Invalid model handle requested: %i", handle);
+
+    return model;
+}
+
+// Get mixer sound from asset handle
+MixerSound GetAssetSound(AssetHandle handle)
+{
+    MixerSound sound = { 0 };
+
+    if ((handle >= 0) && (handle < MAX_ASSETS) && (assets[handle].refCount > 0) && (assets[handle].type == ASSET_SOUND) && (assets[handle].state == ASSET_STATE_READY)) sound = assets[handle].sound;
+    else TraceLog(LOG_WARNING, "ASSETS: Invalid sound handle requested: %i", handle);
+
+    return sound;
+}
+
+// Get font from asset handle
+Font GetAssetFont(AssetHandle handle)
+{
+    Font font = { 0 };
+
+    if ((handle >= 0) && (handle < MAX_ASSETS) && (assets[handle].refCount > 0) && (assets[handle].type == ASSET_FONT) && (assets[handle].state == ASSET_STATE_READY)) font = assets[handle].font;
+    else TraceLog(LOG_WARNING, "ASSETS: Invalid font handle requested: %i", handle);
+
+    return font;
+}
+
+// Get music stream from asset handle
+Music GetAssetMusic(AssetHandle handle)
+{
+    Music music = { 0 };
+
+    if ((handle >= 0) && (handle < MAX_ASSETS) && (assets[handle].refCount > 0) && (assets[handle].type == ASSET_MUSIC) && (assets[handle].state == ASSET_STATE_READY)) music = assets[handle].music;
+    else TraceLog(LOG_WARNING, "ASSETS: Invalid music handle requested: %i", handle);
+
+    return music;
+}
+
+// Unload all resident assets, regardless of their references
+// NOTE: Must be called before closing the window and audio device, with no preloads running.
+// Loader threads are stopped, requests still loading are discarded
+void UnloadAssets(void)
+{
+    StopAssetLoader();
+
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        if (assets[i].refCount > 0)
+        {
+            if (assets[i].refCount > 1) TraceLog(LOG_DEBUG, "ASSETS: [%s] Unloaded with %i references alive", assets[i].fileName, assets[i].refCount);
+            UnloadAssetEntry(&assets[i]);
+        }
+    }
+
+    for (int i = 0; i < MAX_PRELOADED_ASSETS; i++) if (preloaded[i].used) UnloadPreloadedAsset(&preloaded[i]);
+
+    loadQueueCount = 0;
+    loadRequestedCount = 0;
+    loadCompletedCount = 0;
+
+    if (assetsMutex != NULL) UnloadMutex(assetsMutex);
+    assetsMutex = NULL;
+}
+
+// Get memory currently used by resident assets
+AssetMemoryStats GetAssetMemoryStats(void)
+{
+    AssetMemoryStats stats = { 0 };
+
+    for (int i = 0; i < MAX_ASSETS; i++)
+    {
+        if (assets[i].refCount > 0)
+        {
+            stats.assetCount++;
+            stats.cpuBytes += assets[i].cpuBytes;
+            stats.gpuBytes += assets[i].gpuBytes;
+        }
+    }
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Load asset data (from preloaded data if available) and compute its memory footprint
+// NOTE: Preloaded data ownership is transferred to the asset
+static bool LoadAssetEntry(AssetEntry *entry, PreloadedAsset *preload)
+{
+    bool loaded = false;
+
+    entry->cpuBytes = 0;
+    entry->gpuBytes = 0;
+
+    switch (entry->type)
+    {
+        case ASSET_MODEL:
+        {
+            // NOTE: .vox models use the greedy voxel mesher and its baked mesh cache, model meshes are levels of detail
+            if (preload != NULL) entry->model = LoadModelFromVoxelMeshLods(preload->meshes, preload->meshCount);
+            else if (IsFileExtension(entry->fileName, ".vox")) entry->model = LoadVoxelModel(entry->fileName);
+            else entry->model = LoadModel(entry->fileName);
+            loaded = (entry->model.meshCount > 0);
+
+            // NOTE: Mesh data is kept on CPU side after upload, so it counts on both sides
+            for (int i = 0; i < entry->model.meshCount; i++)
+            {
+                long long meshSize = GetMeshDataSize(entry->model.meshes[i]);
+                entry->cpuBytes += meshSize;
+                entry->gpuBytes += meshSize;
+            }
+
+            for (int i = 0; i < entry->model.materialCount; i++)
+            {
+                Texture2D texture = entry->model.materials[i].maps[MATERIAL_MAP_DIFFUSE].texture;
+                if ((texture.id > 0) && (texture.id != rlGetTextureIdDefault())) entry->gpuBytes += GetPixelDataSize(texture.width, texture.height, texture.format);
+            }
+        } break;
+        case ASSET_SOUND:
+        {
+            if (preload != NULL)
+            {
+                entry->sound = LoadMixerSound(preload->wave);
+                UnloadWave(preload->wave);
+            }
+            else
+            {
+                Wave wave = LoadWave(entry->fileName);
+                entry->sound = LoadMixerSound(wave);
+                UnloadWave(wave);
+            }
+            loaded = (entry->sound.frameCount > 0);
+
+            // NOTE: Sound data is decoded to PCM at load time and lives in the mixer arena
+            entry->cpuBytes = (long long)entry->sound.frameCount*MIXER_CHANNELS*sizeof(short);
+        } break;
+        case ASSET_FONT:
+        {
+            // NOTE: SDF fonts are decoded with their atlas, only the atlas texture is left to upload.
+            // Image fonts load as LoadFont() does, glyphs separated by key color starting at space
+            if ((preload != NULL) && (preload->font.glyphCount > 0))
+            {
+                entry->font = preload->font;
+                UploadFontSdf(&entry->font, preload->image);
+                UnloadImage(preload->image);
+            }
+            else if (preload != NULL)
+            {
+                entry->font = LoadFontFromImage(preload->image, MAGENTA, 32);
+                UnloadImage(preload->image);
+            }
+            else entry->font = LoadFont(entry->fileName);
+            loaded = (entry->font.texture.id > 0);
+
+            entry->cpuBytes = (long long)entry->font.glyphCount*(sizeof(GlyphInfo) + sizeof(Rectangle));
+            for (int i = 0; i < entry->font.glyphCount; i++) entry->cpuBytes += GetImageDataSize(entry->font.glyphs[i].image);
+            entry->gpuBytes = GetPixelDataSize(entry->font.texture.width, entry->font.texture.height, entry->font.texture.format);
+        } break;
+        case ASSET_MUSIC:
+        {
+            // NOTE: Music is decoded while streaming, preloaded file data stays resident with the stream
+            if (preload != NULL)
+            {
+                entry->music = LoadMusicStreamFromMemory(GetFileExtension(entry->fileName), preload->file.data, preload->file.dataSize);
+                entry->musicFile = preload->file;
+                entry->cpuBytes = preload->file.dataSize;
+            }
+            else entry->music = LoadMusicStream(entry->fileName);
+            loaded = (entry->music.frameCount > 0);
+        } break;
+        default: break;
+    }
+
+    return loaded;
+}
+
+// Decode asset data on CPU side, safe to call from any thread
+// NOTE: Only data not requiring GPU/audio device is loaded (.vox meshes, waves, image fonts, music file data).
+// Files are loaded through *FromMemory() functions, file name based loaders use raylib static text buffers
+static bool DecodeAsset(AssetType type, const char *fileName, PreloadedAsset *preload)
+{
+    *preload = (PreloadedAsset){ 0 };
+    preload->type = type;
+    strncpy(preload->fileName, fileName, MAX_ASSET_PATH_LENGTH - 1);
+
+    // NOTE: Loose .vox files go through the baked mesh cache, archived ones are meshed from archive data
+    if ((type == ASSET_MODEL) && IsAssetFileExtension(fileName, ".vox") && !IsAssetPackOpen())
+    {
+        preload->meshCount = LoadVoxelMeshLods(fileName, preload->meshes);
+        preload->used = (preload->meshCount > 0);
+    }
+    else if ((type == ASSET_SOUND) || (type == ASSET_MUSIC) || ((type == ASSET_MODEL) && IsAssetFileExtension(fileName, ".vox")) ||
+        ((type == ASSET_FONT) && (IsAssetFileExtension(fileName, ".png") || IsAssetFileExtension(fileName, ".sdf"))))
+    {
+        AssetFileData file = { 0 };
+
+        if (LoadAssetFileData(fileName, &file))
+        {
+            switch (type)
+            {
+                case ASSET_MODEL: preload->meshCount = GenMeshVoxelLodsFromMemory(file.data, file.dataSize, preload->meshes, NULL); preload->used = (preload->meshCount > 0); break;
+                case ASSET_SOUND:
+                {
+                    // NOTE: Waves are converted to mixer format here, so only a copy into the mixer arena is left
+                    preload->wave = LoadWaveFromMemory(GetFileExtension(fileName), file.data, file.dataSize);
+                    preload->used = FormatMixerWave(&preload->wave);
+                    if (!preload->used) UnloadWave(preload->wave);
+                } break;
+                case ASSET_FONT:
+                {
+                    if (IsAssetFileExtension(fileName, ".sdf"))
+                    {
+                        preload->font = LoadFontSdfFromMemory(file.data, file.dataSize, &preload->image);
+                        preload->used = (preload->font.glyphCount > 0);
+                    }
+                    else
+                    {
+                        preload->image = LoadImageFromMemory(GetFileExtension(fileName), file.data, file.dataSize);
+                        preload->used = (preload->image.data != NULL);
+                    }
+                } break;
+                case ASSET_MUSIC:
+                {
+                    preload->file = file;
+                    preload->used = true;
+                    file = (AssetFileData){ 0 };    // Ownership transferred
+                } break;
+                default: break;
+            }
+
+            UnloadAssetFileData(&file);
+        }
+    }
+
+    // NOTE: SDF fonts are baked at build time into the assets archive, without a baked font (loose files)
+    // it is generated from the image font of the same name, file name composed locally for loader threads
+    if ((type == ASSET_FONT) && !preload->used && IsAssetFileExtension(fileName, ".sdf") && (strlen(fileName) < MAX_ASSET_PATH_LENGTH))
+    {
+        char imageFileName[MAX_ASSET_PATH_LENGTH] = { 0 };
+        const int nameLength = (int)(GetFileExtension(fileName) - fileName);
+        AssetFileData file = { 0 };
+
+        memcpy(imageFileName, fileName, nameLength);
+        memcpy(imageFileName + nameLength, ".png", 5);
+
+        if (LoadAssetFileData(imageFileName, &file))
+        {
+            TraceLog(LOG_INFO, "ASSETS: [%s] SDF font not baked, generating it from %s", fileName, imageFileName);
+
+            Image image = LoadImageFromMemory(".png", file.data, file.dataSize);
+            preload->font = GenFontSdfFromImage(image, MAGENTA, 32, &preload->image);
+            preload->used = (preload->font.glyphCount > 0);
+
+            UnloadImage(image);
+            UnloadAssetFileData(&file);
+        }
+    }
+
+    return preload->used;
+}
+
+// Start loader threads (registry mutex must exist)
+// NOTE: Loader threads leave a processor free for the main thread when possible
+static void StartAssetLoader(void)
+{
+    loaderStarted = true;
+    loaderShutdown = false;
+    loaderRequested = LoadCondition();
+    loaderDecoded = LoadCondition();
+
+    int threadCount = GetProcessorCount() - 1;
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > MAX_ASSET_LOADER_THREADS) threadCount = MAX_ASSET_LOADER_THREADS;
+
+    loaderThreadCount = 0;
+    for (int i = 0; i < threadCount; i++)
+    {
+        Thread *thread = StartThread(AssetLoaderThread, NULL);
+        if (thread != NULL) loaderThreads[loaderThreadCount++] = thread;
+    }
+
+    if (loaderThreadCount == 0) TraceLog(LOG_INFO, "ASSETS: Loader threads not available, assets decoded on main thread");
+    else TraceLog(LOG_INFO, "ASSETS: Loader started with %i threads", loaderThreadCount);
+}
+
+// Stop loader threads, queued requests are left queued
+static void StopAssetLoader(void)
+{
+    if (!loaderStarted) return;
+
+    LockMutex(assetsMutex);
+    loaderShutdown = true;
+    BroadcastCondition(loaderRequested);
+    UnlockMutex(assetsMutex);
+
+    for (int i = 0; i < loaderThreadCount; i++) JoinThread(loaderThreads[i]);
+    loaderThreadCount = 0;
+
+    UnloadCondition(loaderRequested);
+    UnloadCondition(loaderDecoded);
+    loaderRequested = NULL;
+    loaderDecoded = NULL;
+    loaderStarted = false;
+}
+
+// Loader thread function, decodes queued requests in request order
+static void AssetLoaderThread(void *userData)
+{
+    (void)userData;
+
+    LockMutex(assetsMutex);
+
+    while (!loaderShutdown)
+    {
+        if (loadQueueCount == 0)
+        {
+            WaitCondition(loaderRequested, assetsMutex);
+            continue;
+        }
+
+        AssetHandle handle = loadQueue[0];
+        RemoveQueuedRequest(handle);
+        assets[handle].state = ASSET_STATE_DECODING;
+        UnlockMutex(assetsMutex);
+
+        DecodeAssetRequest(handle);
+
+        LockMutex(assetsMutex);
+    }
+
+    UnlockMutex(assetsMutex);
+}
+
+// Decode request, marks it decoded (registry mutex must be unlocked)
+// NOTE: Entry type and file name do not change while the request is loading
+static void DecodeAssetRequest(AssetHandle handle)
+{
+    PreloadedAsset decoded = { 0 };
+    DecodeAsset(assets[handle].type, assets[handle].fileName, &decoded);
+
+    LockMutex(assetsMutex);
+    assets[handle].decoded = decoded;
+    assets[handle].state = ASSET_STATE_DECODED;
+    if (loaderDecoded != NULL) BroadcastCondition(loaderDecoded);
+    UnlockMutex(assetsMutex);
+}
+
+// Upload decoded request on main thread
+// NOTE: Assets not decoded on CPU side (i.e. non .vox models) are fully loaded here
+static void UploadAssetRequest(AssetHandle handle)
+{
+    AssetEntry *entry = &assets[handle];
+    PreloadedAsset decoded = entry->decoded;
+    entry->decoded = (PreloadedAsset){ 0 };
+
+    bool loaded = LoadAssetEntry(entry, decoded.used? &decoded : NULL);
+
+    LockMutex(assetsMutex);
+    entry->state = loaded? ASSET_STATE_READY : ASSET_STATE_FAILED;
+    UnlockMutex(assetsMutex);
+
+    if (loaded) TraceLog(LOG_INFO, "ASSETS: [%s] Asset loaded asynchronously (CPU: %lld bytes, GPU: %lld bytes)", entry->fileName, entry->cpuBytes, entry->gpuBytes);
+    else TraceLog(LOG_WARNING, "ASSETS: [%s] Failed to load asset", entry->fileName);
+
+    loadCompletedCount++;
+}
+
+// Finish request synchronously, waiting for or doing its decoding
+static void FinishAssetRequest(AssetHandle handle)
+{
+    LockMutex(assetsMutex);
+
+    if (assets[handle].state == ASSET_STATE_QUEUED)
+    {
+        // NOTE: Request not taken by a loader thread yet, decoded right here
+        RemoveQueuedRequest(handle);
+        assets[handle].state = ASSET_STATE_DECODING;
+        UnlockMutex(assetsMutex);
+
+        DecodeAssetRequest(handle);
+
+        LockMutex(assetsMutex);
+    }
+
+    while (assets[handle].state == ASSET_STATE_DECODING) WaitCondition(loaderDecoded, assetsMutex);
+
+    bool decoded = (assets[handle].state == ASSET_STATE_DECODED);
+    UnlockMutex(assetsMutex);
+
+    if (decoded) UploadAssetRequest(handle);
+}
+
+// Remove request from loading queue (registry mutex must be locked)
+static bool RemoveQueuedRequest(AssetHandle handle)
+{
+    for (int i = 0; i < loadQueueCount; i++)
+    {
+        if (loadQueue[i] == handle)
+        {
+            memmove(&loadQueue[i], &loadQueue[i + 1], (loadQueueCount - i - 1)*sizeof(AssetHandle));
+            loadQueueCount--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Load asset file data, from assets archive if available
+// NOTE: Archive entries are looked up by the same path used for loose files
+static bool LoadAssetFileData(const char *fileName, AssetFileData *file)
+{
+    *file = (AssetFileData){ 0 };
+
+    if (IsAssetPackOpen())
+    {
+        if (LoadAssetPackData(fileName, &file->packData))
+        {
+            file->data = file->packData.data;
+            file->dataSize = file->packData.dataSize;
+            return true;
+        }
+
+        TraceLog(LOG_WARNING, "ASSETS: [%s] Not found in assets archive, loading loose file", fileName);
+    }
+
+    file->fileData = LoadFileData(fileName, &file->dataSize);
+    file->data = file->fileData;
+
+    return (file->data != NULL);
+}
+
+// Unload asset file data
+static void UnloadAssetFileData(AssetFileData *file)
+{
+    if (file->fileData != NULL) UnloadFileData(file->fileData);
+    UnloadAssetPackData(&file->packData);
+
+    *file = (AssetFileData){ 0 };
+}
+
+// Check file extension, no raylib static buffers used (case sensitive)
+static bool IsAssetFileExtension(const char *fileName, const char *ext)
+{
+    const char *fileExt = GetFileExtension(fileName);
+
+    return (fileExt != NULL) && (strcmp(fileExt, ext) == 0);
+}
+
+// Unload asset data and clear slot
+static void UnloadAssetEntry(AssetEntry *entry)
+{
+    switch (entry->type)
+    {
+        case ASSET_MODEL: if (entry->model.meshCount > 0) UnloadModel(entry->model); break;
+        case ASSET_SOUND: if (entry->sound.frameCount > 0) UnloadMixerSound(entry->sound); break;
+        case ASSET_FONT: if (entry->font.texture.id > 0) UnloadFont(entry->font); break;
+        case ASSET_MUSIC:
+        {
+            if (entry->music.frameCount > 0) UnloadMusicStream(entry->music);
+            UnloadAssetFileData(&entry->musicFile);
+        } break;
+        default: break;
+    }
+
+    UnloadPreloadedAsset(&entry->decoded);
+
+    memset(entry, 0, sizeof(AssetEntry));
+}
+
+// Take preloaded asset data out of pending list (registry mutex must be locked)
+static bool TakePreloadedAsset(AssetType type, const char *fileName, PreloadedAsset *preload)
+{
+    for (int i = 0; i < MAX_PRELOADED_ASSETS; i++)
+    {
+        if (preloaded[i].used && (preloaded[i].type == type) && TextIsEqual(preloaded[i].fileName, fileName))
+        {
+            *preload = preloaded[i];
+            preloaded[i] = (PreloadedAsset){ 0 };
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Unload preloaded asset data
+static void UnloadPreloadedAsset(PreloadedAsset *preload)
+{
+    if (preload->used)
+    {
+        switch (preload->type)
+        {
+            case ASSET_MODEL: for (int i = 0; i < preload->meshCount; i++) UnloadMesh(preload->meshes[i]); break;
+            case ASSET_SOUND: UnloadWave(preload->wave); break;
+            case ASSET_FONT:
+            {
+                UnloadImage(preload->image);
+                if (preload->font.glyphCount > 0)
+                {
+                    UnloadFontData(preload->font.glyphs, preload->font.glyphCount);
+                    RL_FREE(preload->font.recs);
+                }
+            } break;
+            case ASSET_MUSIC: UnloadAssetFileData(&preload->file); break;
+            default: break;
+        }
+    }
+
+    *preload = (PreloadedAsset){ 0 };
+}
+
+// Get size of mesh vertex data arrays
+static long long GetMeshDataSize(Mesh mesh)
+{
+    long long size = 0;
+
+    if (mesh.vertices != NULL) size += (long long)mesh.vertexCount*3*sizeof(float);
+    if (mesh.texcoords != NULL) size += (long long)mesh.vertexCount*2*sizeof(float);
+    if (mesh.texcoords2 != NULL) size += (long long)mesh.vertexCount*2*sizeof(float);
+    if (mesh.normals != NULL) size += (long long)mesh.vertexCount*3*sizeof(float);
+    if (mesh.tangents != NULL) size += (long long)mesh.vertexCount*4*sizeof(float);
+    if (mesh.colors != NULL) size += (long long)mesh.vertexCount*4*sizeof(unsigned char);
+    if (mesh.indices != NULL) size += (long long)mesh.triangleCount*3*sizeof(unsigned short);
+
+    return size;
+}
+
+// Get size of image pixel data
+static long long GetImageDataSize(Image image)
+{
+    if (image.data == NULL) return 0;
+
+    return GetPixelDataSize(image.width, image.height, image.format);
+}
@@ -0,0 +1,393 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Audio mixer
+*
+*   Voices pool mixed in a raylib audio stream callback, sounds arena and music streaming thread.
+*
+*   NOTE: Mixer callback runs on the audio device thread while raylib holds its audio lock, it
+*   must not call raylib audio functions. Music is streamed by its own thread for that reason
+*   (raylib music decoding goes through the same lock), with a separate mutex, so decoding
+*   never delays the mixer.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "audio_mixer.h"
+#include "threads.h"    // Required for: StartThread(), LoadMutex()
+
+#include <stdlib.h>     // Required for: RL_CALLOC(), RL_FREE()
+#include <string.h>     // Required for: memcpy(), memset()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MIXER_MUSIC_INTERVAL    0.01        // Music streaming thread polling interval (seconds)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Sound slot, frames range in the arena
+typedef struct MixerSoundSlot {
+    unsigned int offset;        // First frame in arena
+    unsigned int frameCount;
+    bool used;
+} MixerSoundSlot;
+
+// Mixer voice
+typedef struct MixerVoice {
+    int sound;                  // Sound slot played
+    unsigned int position;      // Next frame to be mixed
+    double playTime;            // Play request time, for latency measurement
+    bool active;
+    bool started;               // First frames already mixed
+} MixerVoice;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static bool mixerReady = false;
+static AudioStream mixerStream = { 0 };     // 32 bit float stream, filled by MixAudio()
+static Mutex *mixerMutex = NULL;            // Voices, sounds and latency stats, locked by audio thread while mixing
+
+static short *arena = NULL;                 // Sounds PCM data, 16 bit samples in mixer format
+static unsigned int arenaUsed = 0;          // Frames used, sounds are packed from arena start
+static MixerSoundSlot sounds[MAX_MIXER_SOUNDS] = { 0 };
+static MixerVoice voices[MAX_MIXER_VOICES] = { 0 };
+
+static int latencyCount = 0;
+static double latencySum = 0.0;
+static double latencyMax = 0.0;
+static unsigned int periodFrames = 0;
+
+static Music mixerMusic = { 0 };
+static Mutex *musicMutex = NULL;            // Music and streaming thread shutdown
+static Thread *musicThread = NULL;          // Music streaming thread, NULL if not available
+static bool musicShutdown = false;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static void MixAudio(void *bufferData, unsigned int frames);    // Mix active voices into stream buffer (audio thread)
+static void MusicStreamingThread(void *userData);              // Stream music until shutdown
+static bool IsMixerFormat(Wave wave);                           // Check if wave is in mixer format
+
+//----------------------------------------------------------------------------------
+// Audio Mixer Functions Definition
+//----------------------------------------------------------------------------------
+
+// Initialize mixer stream and music streaming thread (call after InitAudioDevice())
+bool InitAudioMixer(void)
+{
+    if (mixerReady) return true;
+
+    if (!IsAudioDeviceReady())
+    {
+        TraceLog(LOG_WARNING, "MIXER: Audio device not ready, sounds are not played");
+        return false;
+    }
+
+    arena = (short *)RL_CALLOC(MIXER_ARENA_FRAMES*MIXER_CHANNELS, sizeof(short));
+    arenaUsed = 0;
+    memset(sounds, 0, sizeof(sounds));
+    memset(voices, 0, sizeof(voices));
+
+    latencyCount = 0;
+    latencySum = 0.0;
+    latencyMax = 0.0;
+    periodFrames = 0;
+
+    mixerMutex = LoadMutex();
+    musicMutex = LoadMutex();
+    mixerMusic = (Music){ 0 };
+    musicShutdown = false;
+
+    // NOTE: Stream callback is pulled by the audio device, once per device period
+    mixerStream = LoadAudioStream(MIXER_SAMPLE_RATE, 32, MIXER_CHANNELS);
+    if (!IsAudioStreamReady(mixerStream) || (arena == NULL))
+    {
+        TraceLog(LOG_WARNING, "MIXER: Failed to load mixer stream, sounds are not played");
+        if (IsAudioStreamReady(mixerStream)) UnloadAudioStream(mixerStream);
+        RL_FREE(arena);
+        arena = NULL;
+        UnloadMutex(mixerMutex);
+        UnloadMutex(musicMutex);
+        mixerMutex = NULL;
+        musicMutex = NULL;
+        return false;
+    }
+
+    SetAudioStreamCallback(mixerStream, MixAudio);
+    PlayAudioStream(mixerStream);
+
+    musicThread = StartThread(MusicStreamingThread, NULL);
+    if (musicThread == NULL) TraceLog(LOG_INFO, "MIXER: Music streaming thread not available, music streamed from frame loop");
+
+    mixerReady = true;
+    TraceLog(LOG_INFO, "MIXER: Initialized (%i voices, %i Hz, sounds arena: %i frames)", MAX_MIXER_VOICES, MIXER_SAMPLE_RATE, MIXER_ARENA_FRAMES);
+
+    return true;
+}
+
+// Close mixer, stopping voices and music streaming (call before CloseAudioDevice())
+// NOTE: Music stream is not unloaded, sounds loaded are released with the arena
+void CloseAudioMixer(void)
+{
+    if (!mixerReady) return;
+
+    if (musicThread != NULL)
+    {
+        LockMutex(musicMutex);
+        musicShutdown = true;
+        UnlockMutex(musicMutex);
+
+        JoinThread(musicThread);
+        musicThread = NULL;
+    }
+
+    const MixerLatency latency = GetAudioMixerLatency();
+    if (latency.playCount > 0)
+    {
+        TraceLog(LOG_INFO, "MIXER: Sound latency estimate (play to mix + 1 period): %.2f ms average, %.2f ms max (%i sounds, %u frames per device period)",
+            latency.averageTime, latency.maxTime, latency.playCount, latency.periodFrames);
+    }
+
+    // NOTE: Stream is removed from raylib mixing list under its audio lock, callback is not called afterwards
+    StopAudioStream(mixerStream);
+    UnloadAudioStream(mixerStream);
+    mixerStream = (AudioStream){ 0 };
+
+    RL_FREE(arena);
+    arena = NULL;
+    arenaUsed = 0;
+
+    UnloadMutex(mixerMutex);
+    UnloadMutex(musicMutex);
+    mixerMutex = NULL;
+    musicMutex = NULL;
+    mixerMusic = (Music){ 0 };
+
+    mixerReady = false;
+}
+
+// Stream music from the frame loop, only when streaming thread is not available
+void UpdateAudioMixer(void)
+{
+    if (!mixerReady || (musicThread != NULL)) return;
+
+    if (mixerMusic.frameCount > 0) UpdateMusicStream(mixerMusic);
+}
+
+// Convert wave to mixer format (CPU only, can be called from any thread)
+bool FormatMixerWave(Wave *wave)
+{
+    if ((wave->data == NULL) || (wave->frameCount == 0)) return false;
+
+    if (!IsMixerFormat(*wave)) WaveFormat(wave, MIXER_SAMPLE_RATE, 16, MIXER_CHANNELS);
+
+    return IsMixerFormat(*wave);
+}
+
+// Load sound into mixer arena from wave data, wave is not unloaded
+// NOTE: Waves not in mixer format are converted on a copy, loader threads convert them beforehand
+MixerSound LoadMixerSound(Wave wave)
+{
+    MixerSound sound = { 0 };
+
+    if (!mixerReady || (wave.data == NULL) || (wave.frameCount == 0)) return sound;
+
+    Wave formatted = wave;
+    if (!IsMixerFormat(wave))
+    {
+        formatted = WaveCopy(wave);
+        if (!FormatMixerWave(&formatted))
+        {
+            UnloadWave(formatted);
+            return sound;
+        }
+    }
+
+    LockMutex(mixerMutex);
+
+    int slot = -1;
+    for (int i = 0; (i < MAX_MIXER_SOUNDS) && (slot < 0); i++) if (!sounds[i].used) slot = i;
+
+    if (slot < 0) TraceLog(LOG_WARNING, "MIXER: Maximum number of sounds reached (%i)", MAX_MIXER_SOUNDS);
+    else if (arenaUsed + formatted.frameCount > MIXER_ARENA_FRAMES) TraceLog(LOG_WARNING, "MIXER: Sounds arena full, sound not loaded (%u frames)", formatted.frameCount);
+    else
+    {
+        memcpy(arena + (size_t)arenaUsed*MIXER_CHANNELS, formatted.data, (size_t)formatted.frameCount*MIXER_CHANNELS*sizeof(short));
+
+        sounds[slot] = (MixerSoundSlot){ arenaUsed, formatted.frameCount, true };
+        arenaUsed += formatted.frameCount;
+
+        sound.id = slot;
+        sound.frameCount = formatted.frameCount;
+    }
+
+    UnlockMutex(mixerMutex);
+
+    if (formatted.data != wave.data) UnloadWave(formatted);
+
+    return sound;
+}
+
+// Unload sound from mixer arena, stopping its voices
+// NOTE: Sounds after the unloaded one are moved down, so the arena never keeps holes; voices
+// play from frame positions relative to their sound, they are not affected by the move
+void UnloadMixerSound(MixerSound sound)
+{
+    if (!mixerReady || (sound.frameCount == 0) || (sound.id < 0) || (sound.id >= MAX_MIXER_SOUNDS)) return;
+
+    LockMutex(mixerMutex);
+
+    if (sounds[sound.id].used)
+    {
+        for (int i = 0; i < MAX_MIXER_VOICES; i++) if (voices[i].sound == sound.id) voices[i].active = false;
+
+        const MixerSoundSlot freed = sounds[sound.id];
+        const unsigned int freedEnd = freed.offset + freed.frameCount;
+
+        memmove(arena + (size_t)freed.offset*MIXER_CHANNELS, arena + (size_t)freedEnd*MIXER_CHANNELS, (size_t)(arenaUsed - freedEnd)*MIXER_CHANNELS*sizeof(short));
+        for (int i = 0; i < MAX_MIXER_SOUNDS; i++) if (sounds[i].used && (sounds[i].offset > freed.offset)) sounds[i].offset -= freed.frameCount;
+
+        sounds[sound.id] = (MixerSoundSlot){ 0 };
+        arenaUsed -= freed.frameCount;
+    }
+
+    UnlockMutex(mixerMutex);
+}
+
+// Play sound on a free voice (the one played the longest if none)
+void PlayMixerSound(MixerSound sound)
+{
+    if (!mixerReady || (sound.frameCount == 0) || (sound.id < 0) || (sound.id >= MAX_MIXER_SOUNDS)) return;
+
+    LockMutex(mixerMutex);
+
+    if (sounds[sound.id].used)
+    {
+        int voice = -1;
+        for (int i = 0; (i < MAX_MIXER_VOICES) && (voice < 0); i++) if (!voices[i].active) voice = i;
+
+        if (voice < 0)
+        {
+            voice = 0;
+            for (int i = 1; i < MAX_MIXER_VOICES; i++) if (voices[i].position > voices[voice].position) voice = i;
+        }
+
+        voices[voice] = (MixerVoice){ sound.id, 0, GetTime(), true, false };
+    }
+
+    UnlockMutex(mixerMutex);
+}
+
+// Set music stream to be streamed by the mixer, empty music to stop streaming
+// NOTE: Music must be set empty before unloading it, it is not played or stopped by the mixer
+void SetMixerMusic(Music music)
+{
+    if (!mixerReady) return;
+
+    LockMutex(musicMutex);
+    mixerMusic = music;
+    UnlockMutex(musicMutex);
+}
+
+// Get latency estimated on the audio thread
+// NOTE: Estimate is play request to mixing time plus one device period, the time the mixed frames
+// take to be output; device and driver buffering beyond one period is not included, so actual
+// output latency must be measured on the device (i.e. loopback recording)
+MixerLatency GetAudioMixerLatency(void)
+{
+    MixerLatency latency = { 0 };
+
+    if (!mixerReady) return latency;
+
+    LockMutex(mixerMutex);
+
+    latency.playCount = latencyCount;
+    latency.averageTime = (latencyCount > 0)? (float)(latencySum/latencyCount*1000.0) : 0.0f;
+    latency.maxTime = (float)(latencyMax*1000.0);
+    latency.periodFrames = periodFrames;
+
+    UnlockMutex(mixerMutex);
+
+    return latency;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Mix active voices into stream buffer (audio thread)
+static void MixAudio(void *bufferData, unsigned int frames)
+{
+    float *output = (float *)bufferData;
+    memset(output, 0, (size_t)frames*MIXER_CHANNELS*sizeof(float));
+
+    LockMutex(mixerMutex);
+
+    const double mixTime = GetTime();
+    const double periodTime = (double)frames/MIXER_SAMPLE_RATE;
+    periodFrames = frames;
+
+    for (int v = 0; v < MAX_MIXER_VOICES; v++)
+    {
+        MixerVoice *voice = &voices[v];
+        if (!voice->active) continue;
+
+        if (!voice->started)
+        {
+            const double latency = mixTime - voice->playTime + periodTime;
+
+            latencySum += latency;
+            if (latency > latencyMax) latencyMax = latency;
+            latencyCount++;
+            voice->started = true;
+        }
+
+        const MixerSoundSlot *sound = &sounds[voice->sound];
+        unsigned int count = sound->frameCount - voice->position;
+        if (count > frames) count = frames;
+
+        const short *samples = arena + (size_t)(sound->offset + voice->position)*MIXER_CHANNELS;
+        for (unsigned int i = 0; i < count*MIXER_CHANNELS; i++) output[i] += samples[i]*(1.0f/32768.0f);
+
+        voice->position += count;
+        if (voice->position >= sound->frameCount) voice->active = false;
+    }
+
+    UnlockMutex(mixerMutex);
+
+    // NOTE: Overlapping voices are summed, output is clamped instead of scaled so single sounds keep their volume
+    for (unsigned int i = 0; i < frames*MIXER_CHANNELS; i++)
+    {
+        if (output[i] > 1.0f) output[i] = 1.0f;
+        else if (output[i] < -1.0f) output[i] = -1.0f;
+    }
+}
+
+// Stream music until shutdown
+static void MusicStreamingThread(void *userData)
+{
+    (void)userData;
+
+    LockMutex(musicMutex);
+
+    while (!musicShutdown)
+    {
+        if (mixerMusic.frameCount > 0) UpdateMusicStream(mixerMusic);
+
+        UnlockMutex(musicMutex);
+        WaitTime(MIXER_MUSIC_INTERVAL);
+        LockMutex(musicMutex);
+    }
+
+    UnlockMutex(musicMutex);
+}
+
+// Check if wave is in mixer format
+static bool IsMixerFormat(Wave wave)
+{
+    return (wave.sampleRate == MIXER_SAMPLE_RATE) && (wave.sampleSize == 16) && (wave.channels == MIXER_CHANNELS);
+}
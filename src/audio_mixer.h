@@ -0,0 +1,72 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Audio mixer
+*
+*   Sound effects mixed on the audio device thread, from a fixed pool of voices: every play
+*   takes a free voice (the one played the longest is stolen when all are busy), so sounds
+*   triggered in quick succession overlap instead of restarting each other.
+*
+*   Sounds are decoded to PCM at load time (loader threads convert them to mixer format) and
+*   stored in one contiguous arena, the mixer only reads and sums samples. Sound latency is
+*   about one audio device period, set at build time (AUDIO_PERIOD_MS, CMake).
+*
+*   Music is streamed by a dedicated thread, not by the frame loop, so it does not starve
+*   while frames are slow or not drawn. Without threads support (web), UpdateAudioMixer()
+*   streams it from the frame loop.
+*
+**********************************************************************************************/
+
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_MIXER_VOICES        16
+#define MAX_MIXER_SOUNDS        16
+#define MIXER_SAMPLE_RATE       48000
+#define MIXER_CHANNELS          2
+#define MIXER_ARENA_FRAMES      (4*MIXER_SAMPLE_RATE)   // Sounds arena size, 16 bit samples (4 seconds)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Mixer sound, PCM data in the mixer arena
+typedef struct MixerSound {
+    int id;                     // Sound slot, valid if frameCount > 0
+    unsigned int frameCount;    // Total number of frames (considering channels)
+} MixerSound;
+
+// Mixer latency estimated on the audio thread, device buffering not included
+typedef struct MixerLatency {
+    int playCount;              // Sounds started by the mixer
+    float averageTime;          // Average time from play request to first frame mixed, plus one device period (milliseconds)
+    float maxTime;              // Maximum time from play request to first frame mixed, plus one device period (milliseconds)
+    unsigned int periodFrames;  // Frames mixed per audio device callback (last callback)
+} MixerLatency;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Audio Mixer Functions Declaration
+//----------------------------------------------------------------------------------
+bool InitAudioMixer(void);                                  // Initialize mixer stream and music streaming thread (call after InitAudioDevice())
+void CloseAudioMixer(void);                                 // Close mixer, stopping voices and music streaming (call before CloseAudioDevice())
+void UpdateAudioMixer(void);                                // Stream music from the frame loop, only when streaming thread is not available
+bool FormatMixerWave(Wave *wave);                           // Convert wave to mixer format (CPU only, can be called from any thread)
+MixerSound LoadMixerSound(Wave wave);                       // Load sound into mixer arena from wave data, wave is not unloaded
+void UnloadMixerSound(MixerSound sound);                    // Unload sound from mixer arena, stopping its voices
+void PlayMixerSound(MixerSound sound);                      // Play sound on a free voice (the one played the longest if none)
+void SetMixerMusic(Music music);                            // Set music stream to be streamed by the mixer, empty music to stop streaming
+MixerLatency GetAudioMixerLatency(void);                    // Get latency estimated on the audio thread
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_MIXER_H
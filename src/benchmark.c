@@ -0,0 +1,204 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Benchmark
+*
+*   Benchmark stages statistics and JSON export.
+*
+**********************************************************************************************/
+
+#if defined(BENCHMARK_MODE)
+
+#include "raylib.h"
+#include "benchmark.h"
+
+#include <stdio.h>      // Required for: FILE, fopen(), fprintf()
+#include <stdlib.h>     // Required for: qsort(), size_t
+#include <string.h>     // Required for: strncpy()
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Benchmark stage results
+typedef struct BenchmarkStage {
+    char name[32];
+    int frames;
+    double meanTime;                // Frame times (seconds)
+    double p99Time;
+    double maxTime;
+    long long allocations;          // Allocations done during stage
+    long long allocatedBytes;
+} BenchmarkStage;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static BenchmarkStage stages[MAX_BENCHMARK_STAGES] = { 0 };
+static int stageCount = 0;
+static bool stageRunning = false;
+
+// NOTE: Frame times buffer is static, so recording does not allocate
+static double frameTimes[MAX_BENCHMARK_STAGE_FRAMES] = { 0 };
+static int frameCount = 0;
+
+static long long allocationCount = 0;       // Updated by allocation wrappers, from any thread
+static long long allocationBytes = 0;
+static long long stageAllocationCount = 0;  // Counters at stage begin
+static long long stageAllocationBytes = 0;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static int CompareDouble(const void *a, const void *b);    // Compare doubles, used for sorting
+static long long GetAllocationCounter(const long long *counter);   // Read allocation counter
+
+//----------------------------------------------------------------------------------
+// Benchmark Functions Definition
+//----------------------------------------------------------------------------------
+
+// Initialize benchmark, discards previous stages
+void InitBenchmark(void)
+{
+    stageCount = 0;
+    stageRunning = false;
+    frameCount = 0;
+}
+
+// Begin benchmark stage, snapshots allocation counters
+void BeginBenchmarkStage(const char *name)
+{
+    if (stageCount >= MAX_BENCHMARK_STAGES) return;
+
+    BenchmarkStage *stage = &stages[stageCount];
+    *stage = (BenchmarkStage){ 0 };
+    strncpy(stage->name, name, sizeof(stage->name) - 1);
+
+    frameCount = 0;
+    stageRunning = true;
+    stageAllocationCount = GetAllocationCounter(&allocationCount);
+    stageAllocationBytes = GetAllocationCounter(&allocationBytes);
+}
+
+// Record frame time (seconds) on current stage
+void RecordBenchmarkFrame(double frameTime)
+{
+    if (stageRunning && (frameCount < MAX_BENCHMARK_STAGE_FRAMES)) frameTimes[frameCount++] = frameTime;
+}
+
+// End benchmark stage, computes stage statistics
+void EndBenchmarkStage(void)
+{
+    if (!stageRunning) return;
+
+    BenchmarkStage *stage = &stages[stageCount];
+    stage->allocations = GetAllocationCounter(&allocationCount) - stageAllocationCount;
+    stage->allocatedBytes = GetAllocationCounter(&allocationBytes) - stageAllocationBytes;
+    stage->frames = frameCount;
+
+    if (frameCount > 0)
+    {
+        double sum = 0.0;
+        for (int i = 0; i < frameCount; i++) sum += frameTimes[i];
+
+        qsort(frameTimes, frameCount, sizeof(double), CompareDouble);
+
+        stage->meanTime = sum/frameCount;
+        stage->p99Time = frameTimes[(frameCount*99)/100];
+        stage->maxTime = frameTimes[frameCount - 1];
+    }
+
+    TraceLog(LOG_INFO, "BENCHMARK: Stage %s, %i frames, mean %.3f ms, p99 %.3f ms, max %.3f ms, %lld allocations",
+        stage->name, stage->frames, stage->meanTime*1000.0, stage->p99Time*1000.0, stage->maxTime*1000.0, stage->allocations);
+
+    stageCount++;
+    stageRunning = false;
+}
+
+// Export stages results as JSON (NULL for standard output)
+bool ExportBenchmarkResults(const char *fileName)
+{
+    FILE *file = (fileName != NULL)? fopen(fileName, "wt") : stdout;
+    if (file == NULL) return false;
+
+#if defined(BENCHMARK_WRAP_ALLOCATIONS)
+    const bool allocationTracking = true;
+#else
+    const bool allocationTracking = false;
+#endif
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"benchmark\": \"StopThePump\",\n");
+    fprintf(file, "  \"allocation_tracking\": %s,\n", allocationTracking? "true" : "false");
+    fprintf(file, "  \"stages\": [\n");
+
+    for (int i = 0; i < stageCount; i++)
+    {
+        const BenchmarkStage *stage = &stages[i];
+
+        fprintf(file, "    { \"name\": \"%s\", \"frames\": %i, \"mean_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f, \"allocations\": %lld, \"allocated_bytes\": %lld }%s\n",
+            stage->name, stage->frames, stage->meanTime*1000.0, stage->p99Time*1000.0, stage->maxTime*1000.0,
+            allocationTracking? stage->allocations : -1, allocationTracking? stage->allocatedBytes : -1, (i < stageCount - 1)? "," : "");
+    }
+
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+
+    if (file != stdout) fclose(file);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Compare doubles, used for sorting
+static int CompareDouble(const void *a, const void *b)
+{
+    const double da = *(const double *)a;
+    const double db = *(const double *)b;
+
+    return (da > db) - (da < db);
+}
+
+// Read allocation counter
+static long long GetAllocationCounter(const long long *counter)
+{
+#if defined(BENCHMARK_WRAP_ALLOCATIONS)
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+#else
+    return *counter;
+#endif
+}
+
+#if defined(BENCHMARK_WRAP_ALLOCATIONS)
+//----------------------------------------------------------------------------------
+// Allocation Wrappers Definition (linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc)
+//----------------------------------------------------------------------------------
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocationBytes, (long long)size, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocationBytes, (long long)(count*size), __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocationBytes, (long long)size, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+#endif
+
+#endif // BENCHMARK_MODE
@@ -0,0 +1,41 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Benchmark
+*
+*   Frame time statistics per benchmark stage (mean, p99, max) and allocation counts,
+*   exported as JSON. Only compiled into the StopThePumpBench target (BENCHMARK_MODE).
+*
+*   NOTE: Allocations are counted wrapping malloc/calloc/realloc at link time (GNU linkers,
+*   BENCHMARK_WRAP_ALLOCATIONS), so only calls from the game and raylib are counted.
+*
+**********************************************************************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_BENCHMARK_STAGES        16
+#define MAX_BENCHMARK_STAGE_FRAMES  65536
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Benchmark Functions Declaration
+//----------------------------------------------------------------------------------
+void InitBenchmark(void);                               // Initialize benchmark, discards previous stages
+void BeginBenchmarkStage(const char *name);             // Begin benchmark stage, snapshots allocation counters
+void RecordBenchmarkFrame(double frameTime);            // Record frame time (seconds) on current stage
+void EndBenchmarkStage(void);                           // End benchmark stage, computes stage statistics
+bool ExportBenchmarkResults(const char *fileName);      // Export stages results as JSON (NULL for standard output)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCHMARK_H
@@ -0,0 +1,264 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Dynamic resolution
+*
+*   Offscreen 3D pass scaled with GPU frame time, upscaled with sharpening and post-process AA.
+*
+*   Rendered pixels are assumed proportional to GPU time: scale (per axis) is lowered right
+*   away to the one expected to fit the budget, and raised one step at a time while the
+*   expected time stays under the budget headroom, so it does not oscillate.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "dynamic_resolution.h"
+#include "profiler.h"   // Required for: GetProfilerLastDrawnFrame()
+
+#include <stddef.h>     // Required for: NULL
+#include <math.h>       // Required for: sqrtf(), floorf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define DYNAMIC_RESOLUTION_HEADROOM     0.85f       // Budget fraction scale is raised to
+#define DYNAMIC_RESOLUTION_SETTLE       4           // Measured frames skipped after a scale change (GPU results are a few frames old)
+#define DYNAMIC_RESOLUTION_INTERVAL     8           // Measured frames averaged before a scale change
+#define DYNAMIC_RESOLUTION_SMOOTHING    0.2f        // GPU time exponential average factor
+#define DYNAMIC_RESOLUTION_SHARPNESS    0.5f
+
+// NOTE: Body is shared by every GLSL version, prefixes define IN, TEXTURE and OUTPUT.
+// Samples are clamped to the target region in use, edges are blurred along their direction
+// (post-process AA), other pixels are sharpened within their neighbours range (no ringing)
+#define DYNAMIC_RESOLUTION_FS_BODY \
+    "IN vec2 fragTexCoord;\n" \
+    "IN vec4 fragColor;\n" \
+    "uniform sampler2D texture0;\n" \
+    "uniform vec2 texelSize;\n" \
+    "uniform vec2 uvMax;\n" \
+    "uniform float sharpness;\n" \
+    "uniform float postAA;\n" \
+    "vec3 Fetch(vec2 uv)\n" \
+    "{\n" \
+    "    return TEXTURE(texture0, clamp(uv, 0.5*texelSize, uvMax)).rgb;\n" \
+    "}\n" \
+    "float GetLuma(vec3 color)\n" \
+    "{\n" \
+    "    return dot(color, vec3(0.299, 0.587, 0.114));\n" \
+    "}\n" \
+    "void main()\n" \
+    "{\n" \
+    "    vec2 uv = fragTexCoord;\n" \
+    "    vec3 center = Fetch(uv);\n" \
+    "    vec3 north = Fetch(uv + vec2(0.0, texelSize.y));\n" \
+    "    vec3 south = Fetch(uv - vec2(0.0, texelSize.y));\n" \
+    "    vec3 east = Fetch(uv + vec2(texelSize.x, 0.0));\n" \
+    "    vec3 west = Fetch(uv - vec2(texelSize.x, 0.0));\n" \
+    "    float lumaNorth = GetLuma(north);\n" \
+    "    float lumaSouth = GetLuma(south);\n" \
+    "    float lumaEast = GetLuma(east);\n" \
+    "    float lumaWest = GetLuma(west);\n" \
+    "    float lumaCenter = GetLuma(center);\n" \
+    "    float lumaMin = min(lumaCenter, min(min(lumaNorth, lumaSouth), min(lumaEast, lumaWest)));\n" \
+    "    float lumaMax = max(lumaCenter, max(max(lumaNorth, lumaSouth), max(lumaEast, lumaWest)));\n" \
+    "    vec3 color = center;\n" \
+    "    if ((postAA > 0.5) && (lumaMax - lumaMin > max(0.05, 0.125*lumaMax)))\n" \
+    "    {\n" \
+    "        vec2 dir = vec2(lumaSouth - lumaNorth, lumaEast - lumaWest);\n" \
+    "        dir = dir/max(length(dir), 0.0001)*texelSize*0.75;\n" \
+    "        color = 0.5*(Fetch(uv + dir) + Fetch(uv - dir));\n" \
+    "    }\n" \
+    "    else\n" \
+    "    {\n" \
+    "        vec3 blur = 0.25*(north + south + east + west);\n" \
+    "        vec3 colorMin = min(center, min(min(north, south), min(east, west)));\n" \
+    "        vec3 colorMax = max(center, max(max(north, south), max(east, west)));\n" \
+    "        color = clamp(center + (center - blur)*sharpness*2.0, colorMin, colorMax);\n" \
+    "    }\n" \
+    "    OUTPUT = vec4(color, 1.0)*fragColor;\n" \
+    "}\n"
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *upscaleFsCode330 = "#version 330\n#define IN in\n#define TEXTURE texture\nout vec4 finalColor;\n#define OUTPUT finalColor\n" DYNAMIC_RESOLUTION_FS_BODY;
+static const char *upscaleFsCode300es = "#version 300 es\nprecision mediump float;\n#define IN in\n#define TEXTURE texture\nout vec4 finalColor;\n#define OUTPUT finalColor\n" DYNAMIC_RESOLUTION_FS_BODY;
+static const char *upscaleFsCode120 = "#version 120\n#define IN varying\n#define TEXTURE texture2D\n#define OUTPUT gl_FragColor\n" DYNAMIC_RESOLUTION_FS_BODY;
+static const char *upscaleFsCode100 = "#version 100\nprecision mediump float;\n#define IN varying\n#define TEXTURE texture2D\n#define OUTPUT gl_FragColor\n" DYNAMIC_RESOLUTION_FS_BODY;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static int GetScaledSize(int size, float scale);    // Get scaled target size, at least one pixel
+
+//----------------------------------------------------------------------------------
+// Dynamic Resolution Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load upscale shader (call after window initialization), budget in milliseconds
+// NOTE: Offscreen target is only loaded on first scaled frame, at screen size
+DynamicResolution LoadDynamicResolution(float budget, bool postAA)
+{
+    DynamicResolution resolution = { 0 };
+
+    resolution.budget = (budget > 0.0f)? budget : 0.0f;
+    resolution.sharpness = DYNAMIC_RESOLUTION_SHARPNESS;
+    resolution.postAA = postAA;
+    resolution.scale = 1.0f;
+    resolution.lastFrame = -1;
+
+    switch (rlGetVersion())
+    {
+        case RL_OPENGL_21: resolution.shader = LoadShaderFromMemory(NULL, upscaleFsCode120); break;
+        case RL_OPENGL_ES_20: resolution.shader = LoadShaderFromMemory(NULL, upscaleFsCode100); break;
+        case RL_OPENGL_ES_30: resolution.shader = LoadShaderFromMemory(NULL, upscaleFsCode300es); break;
+        default: resolution.shader = LoadShaderFromMemory(NULL, upscaleFsCode330); break;
+    }
+
+    // NOTE: On compilation failure default shader is returned, it must not be unloaded,
+    // scaled frames are still upscaled (bilinear only)
+    if (!IsShaderReady(resolution.shader) || (resolution.shader.id == rlGetShaderIdDefault()))
+    {
+        TraceLog(LOG_WARNING, "RESOLUTION: Failed to load upscale shader");
+        resolution.shader = (Shader){ 0 };
+    }
+    else
+    {
+        resolution.texelSizeLoc = GetShaderLocation(resolution.shader, "texelSize");
+        resolution.uvMaxLoc = GetShaderLocation(resolution.shader, "uvMax");
+        resolution.sharpnessLoc = GetShaderLocation(resolution.shader, "sharpness");
+        resolution.postAALoc = GetShaderLocation(resolution.shader, "postAA");
+    }
+
+    return resolution;
+}
+
+// Unload offscreen target and upscale shader
+void UnloadDynamicResolution(DynamicResolution *resolution)
+{
+    if (resolution->target.id > 0) UnloadRenderTexture(resolution->target);
+    if (resolution->shader.id > 0) UnloadShader(resolution->shader);
+
+    *resolution = (DynamicResolution){ 0 };
+}
+
+// Update resolution scale from latest measured GPU frame time
+// NOTE: Buffers swap is not accounted, its GPU time can include waiting for presentation
+void UpdateDynamicResolution(DynamicResolution *resolution)
+{
+    ProfileFrame frame = { 0 };
+    const long long index = GetProfilerLastDrawnFrame(&frame);
+
+    if ((resolution->budget <= 0.0f) || (index <= resolution->lastFrame)) return;
+    resolution->lastFrame = index;
+
+    if (frame.gpuTime[PROFILE_PHASE_DRAW] < 0.0f) return;    // GPU time not measured
+
+    float gpuTime = 0.0f;
+    for (int p = PROFILE_PHASE_UPDATE; p < PROFILE_PHASE_SWAP; p++) if (frame.gpuTime[p] > 0.0f) gpuTime += frame.gpuTime[p];
+
+    resolution->measuredFrames++;
+    if (resolution->measuredFrames <= DYNAMIC_RESOLUTION_SETTLE)
+    {
+        resolution->gpuTime = gpuTime;
+        return;
+    }
+
+    resolution->gpuTime += (gpuTime - resolution->gpuTime)*DYNAMIC_RESOLUTION_SMOOTHING;
+    if (resolution->measuredFrames < DYNAMIC_RESOLUTION_SETTLE + DYNAMIC_RESOLUTION_INTERVAL) return;
+
+    const float fitScale = resolution->scale*sqrtf(resolution->budget*DYNAMIC_RESOLUTION_HEADROOM/fmaxf(resolution->gpuTime, 0.001f));
+    float scale = resolution->scale;
+
+    if (resolution->gpuTime > resolution->budget) scale = floorf(fitScale/DYNAMIC_RESOLUTION_STEP)*DYNAMIC_RESOLUTION_STEP;
+    else if (fitScale >= resolution->scale + DYNAMIC_RESOLUTION_STEP) scale = resolution->scale + DYNAMIC_RESOLUTION_STEP;
+
+    if (scale < DYNAMIC_RESOLUTION_MIN_SCALE) scale = DYNAMIC_RESOLUTION_MIN_SCALE;
+    if (scale > 1.0f - DYNAMIC_RESOLUTION_STEP*0.5f) scale = 1.0f;
+
+    if (scale != resolution->scale)
+    {
+        TraceLog(LOG_DEBUG, "RESOLUTION: Scale %.2f -> %.2f (GPU frame time %.2f ms, budget %.2f ms)", resolution->scale, scale, resolution->gpuTime, resolution->budget);
+
+        resolution->scale = scale;
+        resolution->measuredFrames = 0;
+    }
+}
+
+// Begin 3D pass, drawn offscreen when scaled (call before ClearBackground())
+// NOTE: Target is kept at screen size and only its bottom-left part is drawn (viewport), so scale
+// changes do not reload it, 3D mode projection aspect ratio comes from the target size
+void BeginDynamicResolution(DynamicResolution *resolution)
+{
+    resolution->scaled = false;
+    if (resolution->scale >= 1.0f) return;
+
+    const int width = GetScreenWidth();
+    const int height = GetScreenHeight();
+
+    if ((resolution->target.texture.width != width) || (resolution->target.texture.height != height))
+    {
+        if (resolution->target.id > 0) UnloadRenderTexture(resolution->target);
+
+        resolution->target = LoadRenderTexture(width, height);
+        if (!IsRenderTextureReady(resolution->target))
+        {
+            TraceLog(LOG_WARNING, "RESOLUTION: Failed to load offscreen target, drawing at native resolution");
+            resolution->target = (RenderTexture2D){ 0 };
+            resolution->budget = 0.0f;
+            resolution->scale = 1.0f;
+            return;
+        }
+
+        SetTextureFilter(resolution->target.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    BeginTextureMode(resolution->target);
+    rlViewport(0, 0, GetScaledSize(width, resolution->scale), GetScaledSize(height, resolution->scale));
+
+    resolution->scaled = true;
+}
+
+// End 3D pass, upscaling it to the screen when scaled
+void EndDynamicResolution(DynamicResolution *resolution)
+{
+    if (!resolution->scaled) return;
+
+    EndTextureMode();
+
+    const Texture2D texture = resolution->target.texture;
+    const float scaledWidth = (float)GetScaledSize(texture.width, resolution->scale);
+    const float scaledHeight = (float)GetScaledSize(texture.height, resolution->scale);
+
+    if (resolution->shader.id > 0)
+    {
+        const Vector2 texelSize = { 1.0f/texture.width, 1.0f/texture.height };
+        const Vector2 uvMax = { (scaledWidth - 0.5f)/texture.width, (scaledHeight - 0.5f)/texture.height };
+        const float postAA = resolution->postAA? 1.0f : 0.0f;
+
+        // NOTE: Uniforms are set before the quad is batched, shader mode change flushes it with them
+        BeginShaderMode(resolution->shader);
+        SetShaderValue(resolution->shader, resolution->texelSizeLoc, &texelSize, SHADER_UNIFORM_VEC2);
+        SetShaderValue(resolution->shader, resolution->uvMaxLoc, &uvMax, SHADER_UNIFORM_VEC2);
+        SetShaderValue(resolution->shader, resolution->sharpnessLoc, &resolution->sharpness, SHADER_UNIFORM_FLOAT);
+        SetShaderValue(resolution->shader, resolution->postAALoc, &postAA, SHADER_UNIFORM_FLOAT);
+    }
+
+    // NOTE: Render texture is flipped vertically, scaled region is at its bottom-left
+    DrawTexturePro(texture, (Rectangle){ 0.0f, 0.0f, scaledWidth, -scaledHeight },
+        (Rectangle){ 0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight() }, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+
+    if (resolution->shader.id > 0) EndShaderMode();
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Get scaled target size, at least one pixel
+static int GetScaledSize(int size, float scale)
+{
+    const int scaledSize = (int)(size*scale + 0.5f);
+
+    return (scaledSize > 0)? scaledSize : 1;
+}
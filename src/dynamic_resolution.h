@@ -0,0 +1,68 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Dynamic resolution
+*
+*   3D pass rendered at a resolution scaled with the measured GPU frame time: when drawn frames
+*   take longer than the budget, the 3D scene is rendered into an offscreen target at a lower
+*   resolution and upscaled to the screen with a sharpening pass, HUD is drawn after it at
+*   native resolution. Scale goes back up when frames are under budget again.
+*
+*   At native scale the scene is drawn directly to the screen, keeping MSAA. Scaled frames can
+*   replace it with a cheap post-process AA, applied by the upscale pass.
+*
+*   NOTE: GPU frame time comes from the profiler GPU timer queries (desktop OpenGL 3.3+),
+*   resolution stays native where they are not supported
+*
+**********************************************************************************************/
+
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define DYNAMIC_RESOLUTION_MIN_SCALE    0.5f        // Minimum resolution scale (per axis)
+#define DYNAMIC_RESOLUTION_STEP         0.05f       // Resolution scale granularity
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Dynamic resolution state
+typedef struct DynamicResolution {
+    RenderTexture2D target;     // Screen sized target, scaled frames only use its bottom-left part
+    Shader shader;              // Upscale shader, sharpening and optional post-process AA
+    int texelSizeLoc;
+    int uvMaxLoc;
+    int sharpnessLoc;
+    int postAALoc;
+    float budget;               // GPU frame time budget (milliseconds), 0 disables scaling
+    float sharpness;            // Upscale sharpening amount [0.0f..1.0f]
+    bool postAA;                // Scaled frames use post-process AA (MSAA only applies to screen)
+    float scale;                // Current resolution scale [DYNAMIC_RESOLUTION_MIN_SCALE..1.0f]
+    float gpuTime;              // Smoothed GPU frame time (milliseconds), at current scale
+    int measuredFrames;         // Frames measured since last scale change
+    long long lastFrame;        // Latest profiler frame measured
+    bool scaled;                // Current frame 3D pass is drawn into target
+} DynamicResolution;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Dynamic Resolution Functions Declaration
+//----------------------------------------------------------------------------------
+DynamicResolution LoadDynamicResolution(float budget, bool postAA);  // Load upscale shader (call after window initialization), budget in milliseconds
+void UnloadDynamicResolution(DynamicResolution *resolution);        // Unload offscreen target and upscale shader
+void UpdateDynamicResolution(DynamicResolution *resolution);        // Update resolution scale from latest measured GPU frame time
+void BeginDynamicResolution(DynamicResolution *resolution);         // Begin 3D pass, drawn offscreen when scaled (call before ClearBackground())
+void EndDynamicResolution(DynamicResolution *resolution);           // End 3D pass, upscaling it to the screen when scaled
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_RESOLUTION_H
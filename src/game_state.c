@@ -0,0 +1,176 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Game state
+*
+*   Gameplay rules as a pure fixed-step simulation.
+*
+**********************************************************************************************/
+
+#include "game_state.h"
+
+#include <stdlib.h>     // Required for: abs()
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static int GetGameRandomValue(GameState *state, int min, int max);     // Get random value from session random generator
+
+//----------------------------------------------------------------------------------
+// Game State Functions Definition
+//----------------------------------------------------------------------------------
+
+// Get default game rules
+GameRules GetDefaultGameRules(void)
+{
+    GameRules rules = { 0 };
+
+    rules.priceRangeMinCents = 25;
+    rules.priceRangeMaxCents = 200;
+    rules.pumpSpeed = 15*GAME_CENT;
+    rules.hitTolerance = 2*GAME_CENT;
+    rules.hitReward = 25*GAME_CENT;
+    rules.gameOverScore = GAME_DOLLAR;
+
+    return rules;
+}
+
+// Initialize game state for a new game session
+void InitGameState(GameState *state, GameRules rules, unsigned int seed)
+{
+    *state = (GameState){ 0 };
+
+    state->rules = rules;
+    state->seed = seed;
+    state->randomState = seed*2654435761u ^ 0x9e3779b9u;    // NOTE: Scrambled, xorshift state must not be zero
+    if (state->randomState == 0) state->randomState = 1;
+    state->pumpStep = (GameRate)(((long long)rules.pumpSpeed << GAME_RATE_SHIFT)/GAME_STEP_RATE);  // NOTE: Truncated, under 1/65536 milli-cent per step
+    state->gameRunning = true;
+
+    StartGameRound(state);
+}
+
+// Start new round, target price drawn from session random generator
+void StartGameRound(GameState *state)
+{
+    state->currentPrice = 0;
+    state->previousPrice = 0;
+    state->priceFraction = 0;
+    state->targetPrice = GetGameRandomValue(state, state->rules.priceRangeMinCents, state->rules.priceRangeMaxCents)*GAME_CENT;
+    state->isPumping = false;
+}
+
+// Advance game state one simulation step
+// NOTE: On hit/missed events next round is started on the same step, unless the game is over
+GameEvent UpdateGameState(GameState *state, GameInput input)
+{
+    GameEvent event = GAME_EVENT_NONE;
+
+    if (!state->gameRunning) return event;
+
+    state->tick++;
+    state->previousPrice = state->currentPrice;
+
+    if (input.pumpDown)
+    {
+        if (!state->isPumping)
+        {
+            state->isPumping = true;
+            event = GAME_EVENT_PUMP_STARTED;
+        }
+
+        const int pumped = state->priceFraction + state->pumpStep;
+        state->currentPrice += pumped >> GAME_RATE_SHIFT;
+        state->priceFraction = pumped & (GAME_RATE_ONE - 1);
+    }
+    else if (state->isPumping)
+    {
+        state->isPumping = false;
+
+        // NOTE: Scored on the displayed price, whole cents
+        const int roundDelta = abs(GetGamePriceCents(state->currentPrice)*GAME_CENT - state->targetPrice);
+        const bool hit = (roundDelta < state->rules.hitTolerance);
+
+        const int rewardedScore = state->score - (hit? state->rules.hitReward : 0);
+        state->score = ((rewardedScore > 0)? rewardedScore : 0) + roundDelta;
+
+        event = hit? GAME_EVENT_ROUND_HIT : GAME_EVENT_ROUND_MISSED;
+        state->rounds += 1;
+        state->lastRoundDelta = roundDelta;
+
+        if (state->score > state->rules.gameOverScore) state->gameRunning = false;
+        else StartGameRound(state);
+    }
+
+    return event;
+}
+
+// Advance game state several steps with the same input, returns last event produced
+// NOTE: Equivalent to calling UpdateGameState() steps times, steps that can't produce
+// events (keep pumping or keep idle) are computed at once, used by headless simulations
+GameEvent UpdateGameStateSteps(GameState *state, GameInput input, int steps)
+{
+    GameEvent event = GAME_EVENT_NONE;
+
+    while ((steps > 0) && state->gameRunning)
+    {
+        if (input.pumpDown && state->isPumping)
+        {
+            // NOTE: Fixed-point sums are exact, so n steps pump exactly n times the rate
+            const long long pumped = state->priceFraction + (long long)state->pumpStep*(steps - 1);
+            const int previousPrice = state->currentPrice + (int)(pumped >> GAME_RATE_SHIFT);
+            const int previousFraction = (int)(pumped & (GAME_RATE_ONE - 1)) + state->pumpStep;
+
+            state->previousPrice = previousPrice;
+            state->currentPrice = previousPrice + (previousFraction >> GAME_RATE_SHIFT);
+            state->priceFraction = previousFraction & (GAME_RATE_ONE - 1);
+            state->tick += steps;
+            steps = 0;
+        }
+        else if (!input.pumpDown && !state->isPumping)
+        {
+            state->previousPrice = state->currentPrice;
+            state->tick += steps;
+            steps = 0;
+        }
+        else
+        {
+            GameEvent stepEvent = UpdateGameState(state, input);
+            if (stepEvent != GAME_EVENT_NONE) event = stepEvent;
+            steps--;
+        }
+    }
+
+    return event;
+}
+
+// Get current price interpolated between last two steps (milli-cents, rendering only)
+// NOTE: Result is an integer price, at alpha 1.0 displayed cents are the scored ones
+int GetGameStatePrice(const GameState *state, float alpha)
+{
+    if (alpha <= 0.0f) return state->previousPrice;
+    if (alpha >= 1.0f) return state->currentPrice;
+
+    return state->previousPrice + (int)((state->currentPrice - state->previousPrice)*alpha);
+}
+
+// Get price in whole cents as displayed by the pump (truncated), price must not be negative
+int GetGamePriceCents(int price)
+{
+    return price/GAME_CENT;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Get random value from session random generator (xorshift32), min and max included
+static int GetGameRandomValue(GameState *state, int min, int max)
+{
+    unsigned int x = state->randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->randomState = x;
+
+    return min + (int)(x%(unsigned int)(max - min + 1));
+}
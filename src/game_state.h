@@ -0,0 +1,101 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Game state
+*
+*   Gameplay rules as a pure fixed-step simulation, no window, audio or GL dependencies.
+*
+*   Prices and score are integer milli-cents, pump speed is a fixed-point rate (milli-cents per
+*   step with 16 fractional bits), so the update step only uses integer add/sub/compare and the
+*   same inputs produce identical states on every platform (x86-64, ARM and wasm), independently
+*   of the rendering frame rate.
+*
+*   Rounds are scored on the stopped price in whole cents, as shown by the pump display, so the
+*   score is always whole cents and displayed values are exactly the ones scored.
+*
+**********************************************************************************************/
+
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define GAME_STEP_RATE      1000                    // Simulation steps per second
+#define GAME_STEP_TIME      (1.0/GAME_STEP_RATE)    // Simulation step duration in seconds
+#define GAME_MAX_STEP_TIME  0.25                    // Maximum frame time simulated in one update, avoids spiral of death after long hitches
+
+#define GAME_CENT           1000                    // Milli-cents per cent
+#define GAME_DOLLAR         (100*GAME_CENT)         // Milli-cents per dollar
+#define GAME_RATE_SHIFT     16                      // Fixed-point rates fractional bits
+#define GAME_RATE_ONE       (1 << GAME_RATE_SHIFT)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Fixed-point rate, milli-cents per simulation step (GAME_RATE_SHIFT fractional bits)
+typedef int GameRate;
+
+// Game rules, tunable difficulty parameters
+typedef struct GameRules {
+    int priceRangeMinCents;     // Minimum target price (cents)
+    int priceRangeMaxCents;     // Maximum target price (cents)
+    int pumpSpeed;              // Price increase per second while pumping (milli-cents)
+    int hitTolerance;           // Maximum distance to target price to hit a round, exclusive (milli-cents)
+    int hitReward;              // Score reduction when hitting a round (milli-cents)
+    int gameOverScore;          // Game ends when score goes over this value (milli-cents)
+} GameRules;
+
+// Game input for one simulation step
+typedef struct GameInput {
+    bool pumpDown;              // Pump trigger held
+} GameInput;
+
+// Game events produced by a simulation step
+typedef enum GameEvent {
+    GAME_EVENT_NONE = 0,
+    GAME_EVENT_PUMP_STARTED,    // Pump trigger pressed
+    GAME_EVENT_ROUND_HIT,       // Pump stopped within tolerance of target
+    GAME_EVENT_ROUND_MISSED,    // Pump stopped outside tolerance of target
+} GameEvent;
+
+// Game state, fully defined by rules, session seed and per-step inputs
+typedef struct GameState {
+    GameRules rules;
+    unsigned int seed;          // Session random seed
+    unsigned int randomState;   // Session random generator state, target prices are drawn from it
+    unsigned int tick;          // Simulation steps since game start
+    GameRate pumpStep;          // Price increase per simulation step while pumping
+    int priceFraction;          // Pumped price below one milli-cent (GAME_RATE_SHIFT fractional bits)
+    int currentPrice;           // Prices and score in milli-cents
+    int previousPrice;          // Price at previous step, used for rendering interpolation
+    int targetPrice;            // Whole cents (in milli-cents)
+    int lastRoundDelta;         // Stopped price difference to target on last round, whole cents (in milli-cents)
+    int score;                  // Sum of whole cents round deltas (in milli-cents)
+    int rounds;
+    bool isPumping;
+    bool gameRunning;
+} GameState;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Game State Functions Declaration
+//----------------------------------------------------------------------------------
+GameRules GetDefaultGameRules(void);                                       // Get default game rules
+void InitGameState(GameState *state, GameRules rules, unsigned int seed); // Initialize game state for a new game session
+void StartGameRound(GameState *state);                                     // Start new round, target price drawn from session random generator
+GameEvent UpdateGameState(GameState *state, GameInput input);              // Advance game state one simulation step
+GameEvent UpdateGameStateSteps(GameState *state, GameInput input, int steps); // Advance game state several steps with the same input
+int GetGameStatePrice(const GameState *state, float alpha);                // Get current price interpolated between last two steps (milli-cents, rendering only)
+int GetGamePriceCents(int price);                                          // Get price in whole cents as displayed by the pump (truncated)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GAME_STATE_H
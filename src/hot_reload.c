@@ -0,0 +1,108 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Hot reload
+*
+*   Shared library copies loaded and replaced while the game runs (dlopen).
+*
+**********************************************************************************************/
+
+#if defined(HOT_RELOAD)
+
+#include "raylib.h"
+#include "hot_reload.h"
+
+#include <dlfcn.h>      // Required for: dlopen(), dlsym(), dlclose(), dlerror()
+#include <stdio.h>      // Required for: snprintf(), remove()
+#include <string.h>     // Required for: strncpy()
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static int loadCount = 0;               // Copies loaded so far, every copy gets a new file name
+
+//----------------------------------------------------------------------------------
+// Hot Reload Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load a copy of shared library
+// NOTE: Copy file name is never reused, the dynamic loader would return the copy still loaded
+HotModule LoadHotModule(const char *fileName)
+{
+    HotModule module = { 0 };
+    strncpy(module.fileName, fileName, sizeof(module.fileName) - 1);
+    snprintf(module.copyFileName, sizeof(module.copyFileName), "%s.%i", fileName, loadCount++);
+    module.modTime = GetFileModTime(fileName);
+    module.pendingSize = -1;
+    module.lastPollTime = GetTime();
+
+    int dataSize = 0;
+    unsigned char *data = LoadFileData(fileName, &dataSize);
+    if (data == NULL) return module;
+
+    module.fileSize = dataSize;
+    const bool copied = SaveFileData(module.copyFileName, data, dataSize);
+    UnloadFileData(data);
+
+    if (copied)
+    {
+        module.handle = dlopen(module.copyFileName, RTLD_NOW | RTLD_LOCAL);
+        if (module.handle == NULL)
+        {
+            TraceLog(LOG_WARNING, "HOTRELOAD: [%s] Failed to load library: %s", fileName, dlerror());
+            remove(module.copyFileName);
+        }
+    }
+
+    return module;
+}
+
+// Unload shared library copy, deleting the copy file
+// NOTE: No code or data of the library can be in use (i.e. screen preload thread running)
+void UnloadHotModule(HotModule *module)
+{
+    if (module->handle == NULL) return;
+
+    dlclose(module->handle);
+    remove(module->copyFileName);
+    module->handle = NULL;
+}
+
+// Get exported symbol address, NULL if not found
+void *GetHotModuleSymbol(HotModule module, const char *name)
+{
+    return (module.handle != NULL)? dlsym(module.handle, name) : NULL;
+}
+
+// Check if library file was rebuilt, true once per change
+// NOTE: File must keep its size for a poll interval, so a library still being written is not loaded
+bool IsHotModuleChanged(HotModule *module)
+{
+    const double currentTime = GetTime();
+    if ((currentTime - module->lastPollTime) < HOT_MODULE_POLL_INTERVAL) return false;
+    module->lastPollTime = currentTime;
+
+    if (!FileExists(module->fileName)) return false;
+
+    const long modTime = GetFileModTime(module->fileName);
+    const int fileSize = GetFileLength(module->fileName);
+
+    if ((modTime == module->modTime) && (fileSize == module->fileSize))
+    {
+        module->pendingSize = -1;
+        return false;
+    }
+
+    if (fileSize != module->pendingSize)
+    {
+        module->pendingSize = fileSize;
+        return false;
+    }
+
+    module->modTime = modTime;
+    module->fileSize = fileSize;
+    module->pendingSize = -1;
+
+    return true;
+}
+
+#endif // HOT_RELOAD
@@ -0,0 +1,56 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Hot reload
+*
+*   Shared library loaded so it can be replaced while the game runs (development builds only):
+*   the library file is polled for changes and, once rebuilt, a new copy is loaded next to the
+*   one in use. Copies are loaded instead of the built file, so the build can overwrite it and
+*   the previous copy stays valid until the host switches to the new one.
+*
+*   NOTE: Only built with HOT_RELOAD defined (CMake HOT_RELOAD option, Linux and macOS),
+*   release builds link the same code statically
+*
+**********************************************************************************************/
+
+#ifndef HOT_RELOAD_H
+#define HOT_RELOAD_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define HOT_MODULE_POLL_INTERVAL    0.25        // Time between library file checks (seconds)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Hot module, loaded copy of a shared library
+typedef struct HotModule {
+    void *handle;               // Loaded copy handle, NULL if not loaded
+    char fileName[256];         // Library file, watched for changes
+    char copyFileName[272];     // Loaded copy of the library file
+    long modTime;               // Library file modification time when loaded
+    int fileSize;               // Library file size when loaded
+    int pendingSize;            // Changed library file size, reloaded once it stops changing (-1 if unchanged)
+    double lastPollTime;
+} HotModule;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Hot Reload Functions Declaration
+//----------------------------------------------------------------------------------
+HotModule LoadHotModule(const char *fileName);                          // Load a copy of shared library (check handle for failure)
+void UnloadHotModule(HotModule *module);                                // Unload shared library copy, deleting the copy file
+void *GetHotModuleSymbol(HotModule module, const char *name);           // Get exported symbol address, NULL if not found
+bool IsHotModuleChanged(HotModule *module);                             // Check if library file was rebuilt (polled, true once per change)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOT_RELOAD_H
@@ -0,0 +1,183 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - HUD layer
+*
+*   Cached text layout, texts drawn in one batch with the SDF text shader.
+*
+*   NOTE: Glyphs are spaced by one font pixel, as DrawText() does for raylib default font
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "hud.h"
+#include "sdf_font.h"   // Required for: IsFontSdf(), LoadFontSdfShader()
+
+#include <string.h>     // Required for: strncpy(), strcmp()
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static void LayoutHudText(const Hud *hud, HudText *hudText);   // Compute text position for current screen size
+static float GetHudTextSpacing(const Hud *hud, float fontSize); // Get glyphs spacing for font size (one font pixel)
+static void SetHudTextString(Hud *hud, HudText *hudText, const char *text);    // Copy text, measuring it if changed
+
+//----------------------------------------------------------------------------------
+// HUD Functions Definition
+//----------------------------------------------------------------------------------
+
+// Initialize empty HUD, SDF fonts load the SDF text shader
+// NOTE: Fonts not loaded (or SDF fonts without shader support) fall back to raylib default font
+void InitHud(Hud *hud, Font font)
+{
+    *hud = (Hud){ 0 };
+    hud->font = (font.texture.id > 0)? font : GetFontDefault();
+
+    if (IsFontSdf(hud->font))
+    {
+        hud->shader = LoadFontSdfShader();
+        if (hud->shader.id == 0) hud->font = GetFontDefault();
+    }
+}
+
+// Unload HUD shader
+void UnloadHud(Hud *hud)
+{
+    if (hud->shader.id > 0) UnloadShader(hud->shader);
+
+    *hud = (Hud){ 0 };
+}
+
+// Add text, returns text id
+int AddHudText(Hud *hud, const char *text, int fontSize, Color color, HudAnchor anchor, int offsetX, int offsetY)
+{
+    if (hud->textCount >= MAX_HUD_TEXTS)
+    {
+        TraceLog(LOG_WARNING, "HUD: Maximum number of texts reached (%i)", MAX_HUD_TEXTS);
+        return -1;
+    }
+
+    const int id = hud->textCount++;
+    HudText *hudText = &hud->texts[id];
+
+    *hudText = (HudText){ 0 };
+    hudText->fontSize = fontSize;
+    hudText->color = color;
+    hudText->anchor = anchor;
+    hudText->offsetX = offsetX;
+    hudText->offsetY = offsetY;
+    hudText->visible = true;
+    hudText->value = -1;
+
+    SetHudTextString(hud, hudText, text);
+
+    // NOTE: Layout size reset, layout is updated on next draw
+    hud->screenWidth = 0;
+
+    return id;
+}
+
+// Set text, only measured if changed
+void SetHudText(Hud *hud, int id, const char *text)
+{
+    if ((id < 0) || (id >= hud->textCount)) return;
+
+    SetHudTextString(hud, &hud->texts[id], text);
+}
+
+// Set text from integer value, only formatted if value changed
+void SetHudValue(Hud *hud, int id, const char *format, int value)
+{
+    if ((id < 0) || (id >= hud->textCount) || (hud->texts[id].value == value)) return;
+
+    hud->texts[id].value = value;
+    SetHudText(hud, id, TextFormat(format, value));
+}
+
+// Set text as label followed by dollars amount
+void SetHudCents(Hud *hud, int id, const char *label, int cents)
+{
+    if ((id < 0) || (id >= hud->textCount) || (hud->texts[id].value == cents)) return;
+
+    hud->texts[id].value = cents;
+    SetHudText(hud, id, TextFormat("%s$%i.%02i", label, cents/100, cents%100));
+}
+
+// Set text visibility
+void SetHudTextVisible(Hud *hud, int id, bool visible)
+{
+    if ((id < 0) || (id >= hud->textCount)) return;
+
+    hud->texts[id].visible = visible;
+}
+
+// Draw HUD texts in one batch (call outside 3D mode)
+// NOTE: Window resize is detected comparing screen size, IsWindowResized() is reset by the input sampler polls
+void DrawHud(Hud *hud)
+{
+    if ((hud->screenWidth != GetScreenWidth()) || (hud->screenHeight != GetScreenHeight()))
+    {
+        hud->screenWidth = GetScreenWidth();
+        hud->screenHeight = GetScreenHeight();
+        hud->scale = (float)hud->screenHeight/HUD_REFERENCE_HEIGHT;
+
+        for (int i = 0; i < hud->textCount; i++) LayoutHudText(hud, &hud->texts[i]);
+    }
+
+    // NOTE: Shader mode flushes draws issued before the HUD, then every glyph quad goes in one batch
+    if (hud->shader.id > 0) BeginShaderMode(hud->shader);
+
+    for (int i = 0; i < hud->textCount; i++)
+    {
+        const HudText *hudText = &hud->texts[i];
+        const float fontSize = hudText->fontSize*hud->scale;
+
+        if (hudText->visible) DrawTextEx(hud->font, hudText->text, hudText->position, fontSize, GetHudTextSpacing(hud, fontSize), hudText->color);
+    }
+
+    if (hud->shader.id > 0) EndShaderMode();
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Compute text position for current screen size
+static void LayoutHudText(const Hud *hud, HudText *hudText)
+{
+    switch (hudText->anchor)
+    {
+        case HUD_ANCHOR_CENTER:
+        {
+            hudText->position.x = hud->screenWidth/2 + (hudText->offsetX - hudText->width/2.0f)*hud->scale;
+            hudText->position.y = hud->screenHeight/2 + hudText->offsetY*hud->scale;
+        } break;
+        case HUD_ANCHOR_BOTTOM_LEFT:
+        {
+            hudText->position.x = hudText->offsetX*hud->scale;
+            hudText->position.y = hud->screenHeight - hudText->offsetY*hud->scale;
+        } break;
+        default: break;
+    }
+}
+
+// Get glyphs spacing for font size (one font pixel)
+// NOTE: SDF fonts base size is in atlas pixels, SDF_FONT_SAMPLES per font pixel
+static float GetHudTextSpacing(const Hud *hud, float fontSize)
+{
+    const float fontPixels = (hud->shader.id > 0)? (float)hud->font.baseSize/SDF_FONT_SAMPLES : (float)hud->font.baseSize;
+
+    return (fontPixels > 0.0f)? fontSize/fontPixels : 1.0f;
+}
+
+// Copy text, measuring it if changed
+// NOTE: Width is measured at reference size, so it does not change with the screen size
+static void SetHudTextString(Hud *hud, HudText *hudText, const char *text)
+{
+    if (strcmp(hudText->text, text) == 0) return;
+
+    strncpy(hudText->text, text, MAX_HUD_TEXT_LENGTH - 1);
+    hudText->text[MAX_HUD_TEXT_LENGTH - 1] = '\0';
+
+    hudText->width = MeasureTextEx(hud->font, hudText->text, (float)hudText->fontSize, GetHudTextSpacing(hud, (float)hudText->fontSize)).x;
+    LayoutHudText(hud, hudText);
+}
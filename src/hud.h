@@ -0,0 +1,82 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - HUD layer
+*
+*   Screen text laid out once and cached: texts are measured when added and dynamic fields
+*   are only formatted and measured when their displayed value changes. Layout is recomputed
+*   only when the screen size changes, scaled from a 720 pixels high reference screen.
+*
+*   Text is drawn with a SDF font (sdf_font.h) and its shader, so it stays sharp at any scale,
+*   and all HUD texts go in one batched draw call (glyph quads share the font atlas texture).
+*   Without a SDF font, raylib default font is drawn the same way, unshaded.
+*
+**********************************************************************************************/
+
+#ifndef HUD_H
+#define HUD_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_HUD_TEXTS           16
+#define MAX_HUD_TEXT_LENGTH     64
+#define HUD_REFERENCE_HEIGHT    720         // Screen height texts sizes and offsets are given for
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// HUD text anchor, offsets are applied from anchor point
+typedef enum HudAnchor {
+    HUD_ANCHOR_CENTER = 0,      // Text horizontally centered on screen center
+    HUD_ANCHOR_BOTTOM_LEFT,     // Text left aligned, offset from bottom-left corner
+} HudAnchor;
+
+// HUD text element
+typedef struct HudText {
+    char text[MAX_HUD_TEXT_LENGTH];
+    int fontSize;               // Size at reference screen height
+    Color color;
+    HudAnchor anchor;
+    int offsetX;
+    int offsetY;
+    bool visible;
+    int value;                  // Last displayed value, text is only formatted when it changes
+    float width;                // Measured text width at reference screen height
+    Vector2 position;           // Layout position (screen pixels)
+} HudText;
+
+// HUD layer
+typedef struct Hud {
+    HudText texts[MAX_HUD_TEXTS];
+    int textCount;
+    Font font;
+    Shader shader;              // SDF text shader, not loaded for bitmap fonts
+    int screenWidth;            // Screen size used for layout
+    int screenHeight;
+    float scale;                // Layout scale, screen height over reference height
+} Hud;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// HUD Functions Declaration
+//----------------------------------------------------------------------------------
+void InitHud(Hud *hud, Font font);                          // Initialize empty HUD, SDF fonts load the SDF text shader
+void UnloadHud(Hud *hud);                                   // Unload HUD shader
+int AddHudText(Hud *hud, const char *text, int fontSize, Color color, HudAnchor anchor, int offsetX, int offsetY); // Add text, returns text id
+void SetHudText(Hud *hud, int id, const char *text);        // Set text, only measured if changed
+void SetHudValue(Hud *hud, int id, const char *format, int value); // Set text from integer value, only formatted if value changed
+void SetHudCents(Hud *hud, int id, const char *label, int cents);  // Set text as label followed by dollars amount
+void SetHudTextVisible(Hud *hud, int id, bool visible);     // Set text visibility
+void DrawHud(Hud *hud);                                     // Draw HUD texts in one batch (call outside 3D mode)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HUD_H
@@ -0,0 +1,249 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Input sampler
+*
+*   Timestamped pump trigger edges and latched per-frame input.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "input.h"
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/html5.h>
+    #include <emscripten/emscripten.h>  // Required for: emscripten_get_now()
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_TRIGGER_EDGES   64          // Trigger edges ring buffer size
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static InputEdge triggerEdges[MAX_TRIGGER_EDGES] = { 0 };
+static int triggerEdgesHead = 0;        // Oldest recorded edge
+static int triggerEdgesCount = 0;
+static bool triggerDown = false;
+
+static bool confirmPressed = false;     // Latched until ResetInputLatches()
+static bool debugTogglePressed = false;
+static bool inputActive = false;        // Any trigger edge, latched input or window resize sampled this frame
+
+static bool scriptedInput = false;      // Trigger driven by SetScriptedTrigger() instead of devices
+static bool scriptedTriggerDown = false;
+
+#if defined(PLATFORM_WEB)
+static bool webKeyDown = false;
+static bool webMouseDown = false;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static void RecordTriggerEdge(bool down, double time);
+
+#if defined(PLATFORM_WEB)
+static EM_BOOL WebKeyCallback(int eventType, const EmscriptenKeyboardEvent *keyEvent, void *userData);
+static EM_BOOL WebMouseCallback(int eventType, const EmscriptenMouseEvent *mouseEvent, void *userData);
+static double GetWebEventTime(double eventTimestamp);
+#endif
+
+//----------------------------------------------------------------------------------
+// Input Sampler Functions Definition
+//----------------------------------------------------------------------------------
+
+// Initialize input sampler (registers platform event callbacks)
+void InitInputSampler(void)
+{
+    ClearTriggerEdges();
+    confirmPressed = false;
+    debugTogglePressed = false;
+    inputActive = false;
+
+#if defined(PLATFORM_WEB)
+    // NOTE: Callbacks don't consume events, raylib keeps receiving them through its own listeners
+    emscripten_set_keydown_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, NULL, 1, WebKeyCallback);
+    emscripten_set_keyup_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, NULL, 1, WebKeyCallback);
+    emscripten_set_mousedown_callback("#canvas", NULL, 1, WebMouseCallback);
+    emscripten_set_mouseup_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, NULL, 1, WebMouseCallback);
+#endif
+}
+
+// Close input sampler
+void CloseInputSampler(void)
+{
+#if defined(PLATFORM_WEB)
+    emscripten_set_keydown_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, NULL, 1, NULL);
+    emscripten_set_keyup_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, NULL, 1, NULL);
+    emscripten_set_mousedown_callback("#canvas", NULL, 1, NULL);
+    emscripten_set_mouseup_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, NULL, 1, NULL);
+#endif
+}
+
+// Sample input state after an events poll, recording trigger edges
+void SampleInputEvents(void)
+{
+#if !defined(PLATFORM_WEB)
+    // NOTE: Edge timestamp is the sampling time, so release resolution is INPUT_SAMPLE_INTERVAL while waiting for next frame
+    bool down = scriptedInput? scriptedTriggerDown : (IsKeyDown(KEY_SPACE) || IsMouseButtonDown(MOUSE_LEFT_BUTTON));
+    if (down != triggerDown) RecordTriggerEdge(down, GetTime());
+#endif
+
+    if (IsKeyPressed(KEY_ENTER) || IsGestureDetected(GESTURE_TAP)) confirmPressed = true;
+    if (IsKeyPressed(KEY_F3)) debugTogglePressed = true;
+
+    // NOTE: Window resize is only reported by the poll that received it, latched too
+    if (confirmPressed || debugTogglePressed || IsWindowResized()) inputActive = true;
+}
+
+// Wait until time, polling and sampling input at high frequency
+// NOTE: Replaces SetTargetFPS() frame limiting on desktop, on web browser drives the frame loop
+void WaitInputSampling(double endTime)
+{
+#if !defined(PLATFORM_WEB)
+    SampleInputEvents();
+
+    double remaining = endTime - GetTime();
+
+    // NOTE: Only a held trigger is polled every INPUT_SAMPLE_INTERVAL, presses are timestamped by the poll after the wait
+    while (remaining > 0.0)
+    {
+        const double interval = triggerDown? INPUT_SAMPLE_INTERVAL : remaining;
+        WaitTime((remaining < interval)? remaining : interval);
+        PollInputEvents();
+        SampleInputEvents();
+
+        remaining = endTime - GetTime();
+    }
+#endif
+}
+
+// Reset per-frame latched input (call once per frame, after update)
+void ResetInputLatches(void)
+{
+    confirmPressed = false;
+    debugTogglePressed = false;
+    inputActive = false;
+}
+
+// Set scripted trigger state, replaces devices input from now on (used by benchmark)
+void SetScriptedTrigger(bool down)
+{
+    scriptedInput = true;
+    scriptedTriggerDown = down;
+}
+
+// Check if pump trigger is currently down (last sampled state)
+bool IsTriggerDown(void)
+{
+    return triggerDown;
+}
+
+// Pop oldest trigger edge recorded up to time, returns false if none
+bool PopTriggerEdge(double time, InputEdge *edge)
+{
+    if ((triggerEdgesCount == 0) || (triggerEdges[triggerEdgesHead].time > time)) return false;
+
+    *edge = triggerEdges[triggerEdgesHead];
+    triggerEdgesHead = (triggerEdgesHead + 1)%MAX_TRIGGER_EDGES;
+    triggerEdgesCount--;
+
+    return true;
+}
+
+// Discard all recorded trigger edges
+void ClearTriggerEdges(void)
+{
+    triggerEdgesHead = 0;
+    triggerEdgesCount = 0;
+}
+
+// Check if confirm (ENTER or tap) has been pressed this frame
+bool IsConfirmPressed(void)
+{
+    return confirmPressed;
+}
+
+// Check if debug overlay toggle (F3) has been pressed this frame
+bool IsDebugTogglePressed(void)
+{
+    return debugTogglePressed;
+}
+
+// Check if any input or window event (trigger edge, confirm, debug toggle, resize) has been sampled this frame
+bool IsInputActive(void)
+{
+    return inputActive;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Record trigger edge, oldest edge is dropped when buffer is full
+static void RecordTriggerEdge(bool down, double time)
+{
+    triggerDown = down;
+    inputActive = true;
+
+    if (triggerEdgesCount == MAX_TRIGGER_EDGES)
+    {
+        TraceLog(LOG_WARNING, "INPUT: Trigger edges buffer full, oldest edge dropped");
+        triggerEdgesHead = (triggerEdgesHead + 1)%MAX_TRIGGER_EDGES;
+        triggerEdgesCount--;
+    }
+
+    // NOTE: Keep edges ordered, timestamps from different sources could be slightly out of order
+    if (triggerEdgesCount > 0)
+    {
+        double lastTime = triggerEdges[(triggerEdgesHead + triggerEdgesCount - 1)%MAX_TRIGGER_EDGES].time;
+        if (time < lastTime) time = lastTime;
+    }
+
+    triggerEdges[(triggerEdgesHead + triggerEdgesCount)%MAX_TRIGGER_EDGES] = (InputEdge){ time, down };
+    triggerEdgesCount++;
+}
+
+#if defined(PLATFORM_WEB)
+// Web keyboard callback, records trigger edges on SPACE
+static EM_BOOL WebKeyCallback(int eventType, const EmscriptenKeyboardEvent *keyEvent, void *userData)
+{
+    if ((keyEvent->keyCode == KEY_SPACE) && !keyEvent->repeat)
+    {
+        webKeyDown = (eventType == EMSCRIPTEN_EVENT_KEYDOWN);
+
+        bool down = webKeyDown || webMouseDown;
+        if (down != triggerDown) RecordTriggerEdge(down, GetWebEventTime(keyEvent->timestamp));
+    }
+
+    return EM_FALSE;    // Event not consumed
+}
+
+// Web mouse callback, records trigger edges on left button
+static EM_BOOL WebMouseCallback(int eventType, const EmscriptenMouseEvent *mouseEvent, void *userData)
+{
+    if (mouseEvent->button == 0)
+    {
+        webMouseDown = (eventType == EMSCRIPTEN_EVENT_MOUSEDOWN);
+
+        bool down = webKeyDown || webMouseDown;
+        if (down != triggerDown) RecordTriggerEdge(down, GetWebEventTime(mouseEvent->timestamp));
+    }
+
+    return EM_FALSE;    // Event not consumed
+}
+
+// Convert browser event timestamp (milliseconds, performance.now() base) to GetTime() base
+static double GetWebEventTime(double eventTimestamp)
+{
+    double now = GetTime();
+    double eventAge = (emscripten_get_now() - eventTimestamp)/1000.0;
+
+    // NOTE: Some browsers report timestamps on a different base, fallback to callback time
+    if ((eventAge < 0.0) || (eventAge > 1.0)) eventAge = 0.0;
+
+    return now - eventAge;
+}
+#endif
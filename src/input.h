@@ -0,0 +1,65 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Input sampler
+*
+*   Records pump trigger press/release edges with high-resolution timestamps (GetTime() base).
+*
+*   On desktop/Android, while the pump trigger is held (its release decides the stop price), time
+*   left until the next frame is spent polling input events at high frequency (GLFW requires events
+*   to be processed on the main thread, so no polling thread); otherwise the main thread sleeps
+*   until the next frame, so idle screens don't wake up every millisecond. Frames are paced by the
+*   sampler only when the frame rate is limited ("--fps N"), with VSync (default) the held trigger
+*   is polled for part of the refresh interval after each swap.
+*   On web, edges come from browser event callbacks using the event timestamp.
+*
+*   NOTE: Extra polling consumes raylib per-frame edges (IsKeyPressed(), gestures), so screens
+*   must use IsConfirmPressed(), latched by the sampler, instead of querying them directly.
+*
+**********************************************************************************************/
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define INPUT_SAMPLE_INTERVAL   0.001       // Input polling interval while waiting for next frame with trigger held (seconds)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Pump trigger edge
+typedef struct InputEdge {
+    double time;                // Edge timestamp, GetTime() base
+    bool down;                  // Trigger pressed (true) or released (false)
+} InputEdge;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Input Sampler Functions Declaration
+//----------------------------------------------------------------------------------
+void InitInputSampler(void);                        // Initialize input sampler (registers platform event callbacks)
+void CloseInputSampler(void);                       // Close input sampler
+void SampleInputEvents(void);                       // Sample input state after an events poll, recording trigger edges
+void WaitInputSampling(double endTime);             // Wait until time, polling and sampling input at high frequency while trigger is held
+void ResetInputLatches(void);                       // Reset per-frame latched input (call once per frame, after update)
+void SetScriptedTrigger(bool down);                 // Set scripted trigger state, replaces devices input from now on (used by benchmark)
+
+bool IsTriggerDown(void);                           // Check if pump trigger is currently down (last sampled state)
+bool PopTriggerEdge(double time, InputEdge *edge);  // Pop oldest trigger edge recorded up to time, returns false if none
+void ClearTriggerEdges(void);                       // Discard all recorded trigger edges
+bool IsConfirmPressed(void);                        // Check if confirm (ENTER or tap) has been pressed this frame
+bool IsDebugTogglePressed(void);                    // Check if debug overlay toggle (F3) has been pressed this frame
+bool IsInputActive(void);                           // Check if any input or window event (trigger edge, confirm, debug toggle, resize) has been sampled this frame
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_H
@@ -0,0 +1,254 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Job pool
+*
+*   Work-stealing thread pool.
+*
+**********************************************************************************************/
+
+#include "job_pool.h"
+#include "threads.h"
+
+#include <stdbool.h>
+#include <stdlib.h>     // Required for: malloc(), calloc(), realloc(), free()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define JOB_DEQUE_INITIAL_CAPACITY  64      // Must be a power of two
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Job {
+    JobFunction function;
+    void *userData;
+} Job;
+
+// Worker jobs deque (ring buffer), owner works on the bottom, thieves steal from the top
+typedef struct JobDeque {
+    Mutex *mutex;
+    Job *jobs;
+    int capacity;
+    int top;                    // Oldest job index
+    int count;
+} JobDeque;
+
+typedef struct JobWorker {
+    JobPool *pool;
+    Thread *thread;
+    JobDeque deque;
+    int index;
+} JobWorker;
+
+struct JobPool {
+    JobWorker *workers;
+    int workerCount;
+    int nextWorker;             // Worker receiving next submitted job (round-robin)
+
+    Mutex *mutex;               // Protects counters below
+    Condition *jobsAvailable;
+    Condition *jobsFinished;
+    int queuedJobs;             // Jobs waiting in deques
+    int pendingJobs;            // Jobs submitted and not finished yet
+    bool shutdown;
+};
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static void PushJob(JobDeque *deque, Job job);
+static bool PopJob(JobDeque *deque, Job *job);
+static bool StealJob(JobDeque *deque, Job *job);
+static void WorkerLoop(void *userData);
+
+//----------------------------------------------------------------------------------
+// Job Pool Functions Definition
+//----------------------------------------------------------------------------------
+
+// Start job pool workers (0 uses one worker per processor)
+JobPool *LoadJobPool(int workerCount)
+{
+    if (workerCount <= 0) workerCount = GetProcessorCount();
+
+    JobPool *pool = (JobPool *)calloc(1, sizeof(JobPool));
+    pool->workers = (JobWorker *)calloc(workerCount, sizeof(JobWorker));
+    pool->workerCount = workerCount;
+    pool->mutex = LoadMutex();
+    pool->jobsAvailable = LoadCondition();
+    pool->jobsFinished = LoadCondition();
+
+    for (int i = 0; i < workerCount; i++)
+    {
+        JobWorker *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+        worker->deque.mutex = LoadMutex();
+        worker->deque.capacity = JOB_DEQUE_INITIAL_CAPACITY;
+        worker->deque.jobs = (Job *)malloc(JOB_DEQUE_INITIAL_CAPACITY*sizeof(Job));
+    }
+
+    // NOTE: Workers started once all deques exist, they steal from each other
+    for (int i = 0; i < workerCount; i++) pool->workers[i].thread = StartThread(WorkerLoop, &pool->workers[i]);
+
+    return pool;
+}
+
+// Wait for pending jobs and stop job pool workers
+void UnloadJobPool(JobPool *pool)
+{
+    if (pool == NULL) return;
+
+    WaitJobs(pool);
+
+    LockMutex(pool->mutex);
+    pool->shutdown = true;
+    BroadcastCondition(pool->jobsAvailable);
+    UnlockMutex(pool->mutex);
+
+    for (int i = 0; i < pool->workerCount; i++)
+    {
+        JoinThread(pool->workers[i].thread);
+        UnloadMutex(pool->workers[i].deque.mutex);
+        free(pool->workers[i].deque.jobs);
+    }
+
+    UnloadCondition(pool->jobsFinished);
+    UnloadCondition(pool->jobsAvailable);
+    UnloadMutex(pool->mutex);
+    free(pool->workers);
+    free(pool);
+}
+
+// Submit job to be run by any worker
+// NOTE: Jobs are distributed round-robin, idle workers balance the load by stealing
+void SubmitJob(JobPool *pool, JobFunction function, void *userData)
+{
+    // NOTE: Job is counted as queued before being pushed, so no worker goes to sleep while it's on its way
+    LockMutex(pool->mutex);
+    int workerIndex = pool->nextWorker;
+    pool->nextWorker = (pool->nextWorker + 1)%pool->workerCount;
+    pool->pendingJobs++;
+    pool->queuedJobs++;
+    UnlockMutex(pool->mutex);
+
+    PushJob(&pool->workers[workerIndex].deque, (Job){ function, userData });
+
+    SignalCondition(pool->jobsAvailable);
+}
+
+// Wait until all submitted jobs have finished
+void WaitJobs(JobPool *pool)
+{
+    LockMutex(pool->mutex);
+    while (pool->pendingJobs > 0) WaitCondition(pool->jobsFinished, pool->mutex);
+    UnlockMutex(pool->mutex);
+}
+
+// Get number of job pool workers
+int GetJobPoolWorkerCount(const JobPool *pool)
+{
+    return pool->workerCount;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Push job to deque bottom, growing it if required
+static void PushJob(JobDeque *deque, Job job)
+{
+    LockMutex(deque->mutex);
+
+    if (deque->count == deque->capacity)
+    {
+        Job *jobs = (Job *)malloc(deque->capacity*2*sizeof(Job));
+        for (int i = 0; i < deque->count; i++) jobs[i] = deque->jobs[(deque->top + i) & (deque->capacity - 1)];
+
+        free(deque->jobs);
+        deque->jobs = jobs;
+        deque->capacity *= 2;
+        deque->top = 0;
+    }
+
+    deque->jobs[(deque->top + deque->count) & (deque->capacity - 1)] = job;
+    deque->count++;
+
+    UnlockMutex(deque->mutex);
+}
+
+// Pop newest job from deque bottom (owner side)
+static bool PopJob(JobDeque *deque, Job *job)
+{
+    bool found = false;
+
+    LockMutex(deque->mutex);
+    if (deque->count > 0)
+    {
+        deque->count--;
+        *job = deque->jobs[(deque->top + deque->count) & (deque->capacity - 1)];
+        found = true;
+    }
+    UnlockMutex(deque->mutex);
+
+    return found;
+}
+
+// Steal oldest job from deque top (thief side)
+static bool StealJob(JobDeque *deque, Job *job)
+{
+    bool found = false;
+
+    LockMutex(deque->mutex);
+    if (deque->count > 0)
+    {
+        *job = deque->jobs[deque->top];
+        deque->top = (deque->top + 1) & (deque->capacity - 1);
+        deque->count--;
+        found = true;
+    }
+    UnlockMutex(deque->mutex);
+
+    return found;
+}
+
+// Worker thread loop: run own jobs, then steal, then sleep until new jobs are submitted
+static void WorkerLoop(void *userData)
+{
+    JobWorker *worker = (JobWorker *)userData;
+    JobPool *pool = worker->pool;
+
+    while (true)
+    {
+        Job job = { 0 };
+        bool found = PopJob(&worker->deque, &job);
+
+        for (int i = 1; !found && (i < pool->workerCount); i++)
+        {
+            found = StealJob(&pool->workers[(worker->index + i)%pool->workerCount].deque, &job);
+        }
+
+        if (found)
+        {
+            LockMutex(pool->mutex);
+            pool->queuedJobs--;
+            UnlockMutex(pool->mutex);
+
+            job.function(job.userData);
+
+            LockMutex(pool->mutex);
+            pool->pendingJobs--;
+            if (pool->pendingJobs == 0) BroadcastCondition(pool->jobsFinished);
+            UnlockMutex(pool->mutex);
+        }
+        else
+        {
+            LockMutex(pool->mutex);
+            while ((pool->queuedJobs == 0) && !pool->shutdown) WaitCondition(pool->jobsAvailable, pool->mutex);
+            bool exit = (pool->shutdown && (pool->queuedJobs == 0));
+            UnlockMutex(pool->mutex);
+
+            if (exit) break;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Job pool
+*
+*   Work-stealing thread pool: every worker owns a jobs deque, takes its own jobs newest first
+*   and steals the oldest jobs from other workers when its deque runs empty.
+*
+**********************************************************************************************/
+
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct JobPool JobPool;         // Opaque job pool
+
+typedef void (*JobFunction)(void *userData);
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Job Pool Functions Declaration
+//----------------------------------------------------------------------------------
+JobPool *LoadJobPool(int workerCount);                                  // Start job pool workers (0 uses one worker per processor)
+void UnloadJobPool(JobPool *pool);                                      // Wait for pending jobs and stop job pool workers
+void SubmitJob(JobPool *pool, JobFunction function, void *userData);    // Submit job to be run by any worker
+void WaitJobs(JobPool *pool);                                           // Wait until all submitted jobs have finished
+int GetJobPoolWorkerCount(const JobPool *pool);                         // Get number of job pool workers
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JOB_POOL_H
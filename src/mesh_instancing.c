@@ -0,0 +1,338 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Mesh instancing
+*
+*   Instanced mesh drawing through rlgl, levels of detail batches and frustum culling helpers.
+*
+*   Level of detail transitions are dithered: instance color alpha holds a coverage value and
+*   the fragment shader discards pixels against a 4x4 ordered dither matrix. Outgoing and
+*   incoming levels use complementary tests on the same threshold, so every pixel is drawn
+*   by exactly one of them and there is no blending or sorting involved:
+*
+*     alpha 255               opaque
+*     alpha 128 + q           incoming level, pixels with threshold < q/127 drawn
+*     alpha q (0..127)        outgoing level, pixels with threshold >= q/127 drawn
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "raymath.h"
+#include "mesh_instancing.h"
+
+#include <stddef.h>     // Required for: offsetof()
+#include <stdlib.h>     // Required for: calloc(), free()
+#include <math.h>       // Required for: sqrtf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define INSTANCING_VS_BODY \
+    "in vec3 vertexPosition;\n" \
+    "in vec4 vertexColor;\n" \
+    "in mat4 instanceTransform;\n" \
+    "in vec4 instanceColor;\n" \
+    "uniform mat4 mvp;\n" \
+    "out vec4 fragColor;\n" \
+    "flat out float fragDither;\n" \
+    "void main()\n" \
+    "{\n" \
+    "    fragColor = vec4(vertexColor.rgb*instanceColor.rgb, vertexColor.a);\n" \
+    "    fragDither = floor(instanceColor.a*255.0 + 0.5);\n" \
+    "    gl_Position = mvp*(vec4(vertexPosition, 1.0)*instanceTransform);\n" \
+    "}\n"
+
+#define INSTANCING_FS_BODY \
+    "in vec4 fragColor;\n" \
+    "flat in float fragDither;\n" \
+    "out vec4 finalColor;\n" \
+    "const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);\n" \
+    "void main()\n" \
+    "{\n" \
+    "    if (fragDither < 255.0)\n" \
+    "    {\n" \
+    "        ivec2 pixel = ivec2(gl_FragCoord.xy) & 3;\n" \
+    "        float threshold = (bayer[pixel.y*4 + pixel.x] + 0.5)/16.0;\n" \
+    "        bool incoming = (fragDither >= 128.0);\n" \
+    "        float coverage = (incoming? fragDither - 128.0 : fragDither)/127.0;\n" \
+    "        if (incoming == (threshold >= coverage)) discard;\n" \
+    "    }\n" \
+    "    finalColor = fragColor;\n" \
+    "}\n"
+
+#define LOD_DITHER_STEPS        127         // Coverage steps encoded in instance color alpha
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+// NOTE: Instance transform rows are uploaded as mat4 attribute columns, so vertices are
+// multiplied as row vectors (v*M), equivalent to M*v with raylib matrix layout
+static const char *instancingVsCode330 = "#version 330\n" INSTANCING_VS_BODY;
+static const char *instancingFsCode330 = "#version 330\n" INSTANCING_FS_BODY;
+static const char *instancingVsCode300es = "#version 300 es\n" INSTANCING_VS_BODY;
+static const char *instancingFsCode300es = "#version 300 es\nprecision mediump float;\n" INSTANCING_FS_BODY;
+
+//----------------------------------------------------------------------------------
+// Mesh Instancing Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load mesh instances batch for an uploaded mesh
+// NOTE: Batch gets its own vertex array, reading mesh position and color buffers, so mesh
+// vertex array is left untouched and the mesh can still be drawn with DrawMesh()
+MeshInstances LoadMeshInstances(Mesh mesh, int capacity)
+{
+    MeshInstances batch = { 0 };
+
+    batch.mesh = mesh;
+    batch.capacity = capacity;
+    batch.instances = (MeshInstance *)calloc(capacity, sizeof(MeshInstance));
+
+    const int glVersion = rlGetVersion();
+    batch.instancing = ((glVersion == RL_OPENGL_33) || (glVersion == RL_OPENGL_43) || (glVersion == RL_OPENGL_ES_30)) && (mesh.vboId != NULL) && (mesh.vboId[0] != 0);
+
+    if (batch.instancing)
+    {
+        if (glVersion == RL_OPENGL_ES_30) batch.shader = LoadShaderFromMemory(instancingVsCode300es, instancingFsCode300es);
+        else batch.shader = LoadShaderFromMemory(instancingVsCode330, instancingFsCode330);
+
+        // NOTE: On compilation failure default shader is returned, it must not be modified
+        const bool shaderLoaded = IsShaderReady(batch.shader) && (batch.shader.id != rlGetShaderIdDefault());
+        const int transformLoc = shaderLoaded? GetShaderLocationAttrib(batch.shader, "instanceTransform") : -1;
+        const int colorLoc = shaderLoaded? GetShaderLocationAttrib(batch.shader, "instanceColor") : -1;
+
+        batch.instancing = (transformLoc >= 0) && (colorLoc >= 0);
+
+        if (batch.instancing)
+        {
+            batch.shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(batch.shader, "mvp");
+
+            batch.vaoId = rlLoadVertexArray();
+            rlEnableVertexArray(batch.vaoId);
+
+            // Mesh buffers: positions (location 0) and colors (location 3), same locations raylib binds by name
+            rlEnableVertexBuffer(mesh.vboId[0]);
+            rlSetVertexAttribute(0, 3, RL_FLOAT, false, 0, 0);
+            rlEnableVertexAttribute(0);
+
+            if (mesh.vboId[3] != 0)
+            {
+                rlEnableVertexBuffer(mesh.vboId[3]);
+                rlSetVertexAttribute(3, 4, RL_UNSIGNED_BYTE, true, 0, 0);
+                rlEnableVertexAttribute(3);
+            }
+
+            // Instance buffer: transform (4 consecutive locations) and color, advanced once per instance
+            batch.vboId = rlLoadVertexBuffer(NULL, capacity*sizeof(MeshInstance), true);
+            for (int i = 0; i < 4; i++)
+            {
+                rlSetVertexAttribute(transformLoc + i, 4, RL_FLOAT, false, sizeof(MeshInstance), (void *)(offsetof(MeshInstance, transform) + i*sizeof(Vector4)));
+                rlEnableVertexAttribute(transformLoc + i);
+                rlSetVertexAttributeDivisor(transformLoc + i, 1);
+            }
+
+            rlSetVertexAttribute(colorLoc, 4, RL_UNSIGNED_BYTE, true, sizeof(MeshInstance), (void *)offsetof(MeshInstance, color));
+            rlEnableVertexAttribute(colorLoc);
+            rlSetVertexAttributeDivisor(colorLoc, 1);
+
+            if (mesh.indices != NULL) rlEnableVertexBufferElement(mesh.vboId[6]);
+
+            // NOTE: Vertex array unbound first, so it keeps its buffer bindings
+            rlDisableVertexArray();
+            rlDisableVertexBuffer();
+            rlDisableVertexBufferElement();
+        }
+        else
+        {
+            TraceLog(LOG_WARNING, "INSTANCING: Failed to load instancing shader, drawing instances one by one");
+            UnloadShader(batch.shader);
+            batch.shader = (Shader){ 0 };
+        }
+    }
+    else TraceLog(LOG_INFO, "INSTANCING: Instanced drawing not supported, drawing instances one by one");
+
+    if (!batch.instancing) batch.material = LoadMaterialDefault();
+
+    return batch;
+}
+
+// Unload mesh instances batch (mesh is not unloaded)
+void UnloadMeshInstances(MeshInstances *batch)
+{
+    if (batch->vaoId != 0) rlUnloadVertexArray(batch->vaoId);
+    if (batch->vboId != 0) rlUnloadVertexBuffer(batch->vboId);
+    if (batch->shader.id != 0) UnloadShader(batch->shader);
+
+    // NOTE: Default material only holds default shader and texture, UnloadMaterial() keeps them
+    if (batch->material.maps != NULL) UnloadMaterial(batch->material);
+
+    free(batch->instances);
+
+    *batch = (MeshInstances){ 0 };
+}
+
+// Draw batch instances (call inside 3D mode)
+void DrawMeshInstances(MeshInstances *batch)
+{
+    const int count = (batch->count < batch->capacity)? batch->count : batch->capacity;
+    if ((count <= 0) || (batch->mesh.vertexCount == 0)) return;
+
+    if (!batch->instancing)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            Color color = batch->instances[i].color;
+
+            // NOTE: No dithering without the instancing shader, only the level covering most pixels is drawn
+            if (color.a < 255)
+            {
+                const int coverage = (color.a >= 128)? color.a - 128 : LOD_DITHER_STEPS - color.a;
+                if (coverage*2 < LOD_DITHER_STEPS) continue;
+                color.a = 255;
+            }
+
+            batch->material.maps[MATERIAL_MAP_DIFFUSE].color = color;
+            DrawMesh(batch->mesh, batch->material, batch->instances[i].transform);
+        }
+
+        return;
+    }
+
+    rlDrawRenderBatchActive();      // Flush batched draws issued before instances
+
+    rlUpdateVertexBuffer(batch->vboId, batch->instances, count*sizeof(MeshInstance), 0);
+
+    rlEnableShader(batch->shader.id);
+    rlSetUniformMatrix(batch->shader.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+
+    // NOTE: Meshes without colors read a constant white color
+    if (batch->mesh.vboId[3] == 0)
+    {
+        const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        rlSetVertexAttributeDefault(3, white, SHADER_ATTRIB_VEC4, 1);
+    }
+
+    rlEnableVertexArray(batch->vaoId);
+    if (batch->mesh.indices != NULL) rlDrawVertexArrayElementsInstanced(0, batch->mesh.triangleCount*3, 0, count);
+    else rlDrawVertexArrayInstanced(0, batch->mesh.vertexCount, count);
+    rlDisableVertexArray();
+
+    rlDisableShader();
+}
+
+// Load levels of detail batches, one per model mesh (meshes are levels of detail, full detail first)
+// NOTE: Capacity is per level, an instance fading between two levels takes a slot on both
+LodInstances LoadLodInstances(Model model, int capacity)
+{
+    LodInstances lods = { 0 };
+
+    lods.levelCount = (model.meshCount < MAX_INSTANCES_LODS)? model.meshCount : MAX_INSTANCES_LODS;
+    for (int i = 0; i < lods.levelCount; i++) lods.levels[i] = LoadMeshInstances(model.meshes[i], capacity);
+
+    return lods;
+}
+
+// Unload levels of detail batches (model is not unloaded)
+void UnloadLodInstances(LodInstances *lods)
+{
+    for (int i = 0; i < lods->levelCount; i++) UnloadMeshInstances(&lods->levels[i]);
+
+    *lods = (LodInstances){ 0 };
+}
+
+// Clear instances of every level
+void ClearLodInstances(LodInstances *lods)
+{
+    for (int i = 0; i < lods->levelCount; i++) lods->levels[i].count = 0;
+}
+
+// Add instance at level of detail, dithered into next level by fade [0..1]
+void AddLodInstance(LodInstances *lods, Matrix transform, Color color, int level, float fade)
+{
+    if (lods->levelCount <= 0) return;
+
+    if (level < 0) level = 0;
+    if (level >= lods->levelCount - 1)
+    {
+        level = lods->levelCount - 1;
+        fade = 0.0f;
+    }
+
+    const int coverage = (int)(Clamp(fade, 0.0f, 1.0f)*LOD_DITHER_STEPS + 0.5f);
+
+    // Outgoing level, skipped once fully covered by next level
+    MeshInstances *outgoing = &lods->levels[level];
+    if ((coverage < LOD_DITHER_STEPS) && (outgoing->count < outgoing->capacity))
+    {
+        color.a = (coverage == 0)? 255 : (unsigned char)coverage;
+        outgoing->instances[outgoing->count] = (MeshInstance){ transform, color };
+        outgoing->count++;
+    }
+
+    // Incoming level, only while fading (never the last level, fade is cleared there)
+    if (coverage > 0)
+    {
+        MeshInstances *incoming = &lods->levels[level + 1];
+        if (incoming->count < incoming->capacity)
+        {
+            color.a = (unsigned char)(128 + coverage);
+            incoming->instances[incoming->count] = (MeshInstance){ transform, color };
+            incoming->count++;
+        }
+    }
+}
+
+// Draw instances of every level (call inside 3D mode)
+void DrawLodInstances(LodInstances *lods)
+{
+    for (int i = 0; i < lods->levelCount; i++) DrawMeshInstances(&lods->levels[i]);
+}
+
+// Get frustum from current modelview and projection matrices (call inside 3D mode)
+// NOTE: Planes are the clip matrix rows combinations (Gribb-Hartmann), clip = mvp*v with
+// matrix rows being (m0, m4, m8, m12), (m1, m5, m9, m13)...
+Frustum GetCurrentFrustum(void)
+{
+    const Matrix m = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    const Vector4 rows[4] = {
+        { m.m0, m.m4, m.m8, m.m12 },
+        { m.m1, m.m5, m.m9, m.m13 },
+        { m.m2, m.m6, m.m10, m.m14 },
+        { m.m3, m.m7, m.m11, m.m15 },
+    };
+
+    Frustum frustum = { 0 };
+
+    for (int i = 0; i < 3; i++)
+    {
+        frustum.planes[i*2] = (Vector4){ rows[3].x + rows[i].x, rows[3].y + rows[i].y, rows[3].z + rows[i].z, rows[3].w + rows[i].w };
+        frustum.planes[i*2 + 1] = (Vector4){ rows[3].x - rows[i].x, rows[3].y - rows[i].y, rows[3].z - rows[i].z, rows[3].w - rows[i].w };
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        Vector4 *plane = &frustum.planes[i];
+        const float length = sqrtf(plane->x*plane->x + plane->y*plane->y + plane->z*plane->z);
+
+        if (length > 0.0f)
+        {
+            plane->x /= length;
+            plane->y /= length;
+            plane->z /= length;
+            plane->w /= length;
+        }
+    }
+
+    return frustum;
+}
+
+// Check if sphere is, at least partially, inside frustum
+bool IsSphereInFrustum(const Frustum *frustum, Vector3 center, float radius)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        const Vector4 plane = frustum->planes[i];
+        if (plane.x*center.x + plane.y*center.y + plane.z*center.z + plane.w < -radius) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,87 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Mesh instancing
+*
+*   Draws many copies of one mesh with per-instance transforms and colors in a single
+*   instanced draw call (rlgl, OpenGL 3.3+ or ES 3.0). Instances are written by the caller
+*   every frame into the CPU array and uploaded once per draw into a persistent dynamic buffer.
+*   Without instancing support (OpenGL 2.1, ES 2.0) instances are drawn one by one.
+*
+*   Levels of detail batches hold one batch per model mesh, every instance is added at its
+*   level and dithered into the next one while fading, so levels swap without popping.
+*
+*   Frustum helpers extract the current camera frustum from rlgl matrices, so culling must
+*   happen inside BeginMode3D()/EndMode3D(), with the same matrices used for drawing.
+*
+**********************************************************************************************/
+
+#ifndef MESH_INSTANCING_H
+#define MESH_INSTANCING_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_INSTANCES_LODS      4           // Levels of detail per batches set
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Mesh instance, uploaded as is to the instance buffer
+// NOTE: Matrix is stored row-major in memory (raylib layout), shader multiplies accordingly
+typedef struct MeshInstance {
+    Matrix transform;
+    Color color;                // Tint, multiplied by mesh vertex colors, alpha is level of detail dither (255: opaque)
+} MeshInstance;
+
+// Mesh instances batch
+typedef struct MeshInstances {
+    Mesh mesh;                  // Mesh drawn, not owned (must stay loaded)
+    MeshInstance *instances;    // Instances to draw, written by caller
+    int count;                  // Instances to draw
+    int capacity;
+    bool instancing;            // Instanced draw supported, otherwise drawn one by one
+    Shader shader;
+    Material material;          // Fallback material, used without instancing support
+    unsigned int vaoId;         // Vertex array combining mesh buffers and instance buffer
+    unsigned int vboId;         // Instance buffer
+} MeshInstances;
+
+// Levels of detail batches, one per model mesh, full detail first
+typedef struct LodInstances {
+    MeshInstances levels[MAX_INSTANCES_LODS];
+    int levelCount;
+} LodInstances;
+
+// View frustum, planes normal pointing inside (x, y, z) and distance (w)
+typedef struct Frustum {
+    Vector4 planes[6];
+} Frustum;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Mesh Instancing Functions Declaration
+//----------------------------------------------------------------------------------
+MeshInstances LoadMeshInstances(Mesh mesh, int capacity);       // Load mesh instances batch for an uploaded mesh
+void UnloadMeshInstances(MeshInstances *batch);                 // Unload mesh instances batch (mesh is not unloaded)
+void DrawMeshInstances(MeshInstances *batch);                   // Draw batch instances (call inside 3D mode)
+
+LodInstances LoadLodInstances(Model model, int capacity);       // Load levels of detail batches, one per model mesh (meshes are levels of detail, full detail first)
+void UnloadLodInstances(LodInstances *lods);                    // Unload levels of detail batches (model is not unloaded)
+void ClearLodInstances(LodInstances *lods);                     // Clear instances of every level
+void AddLodInstance(LodInstances *lods, Matrix transform, Color color, int level, float fade);  // Add instance at level of detail, dithered into next level by fade [0..1]
+void DrawLodInstances(LodInstances *lods);                      // Draw instances of every level (call inside 3D mode)
+
+Frustum GetCurrentFrustum(void);                                // Get frustum from current modelview and projection matrices (call inside 3D mode)
+bool IsSphereInFrustum(const Frustum *frustum, Vector3 center, float radius);   // Check if sphere is, at least partially, inside frustum
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MESH_INSTANCING_H
@@ -0,0 +1,234 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Particle kernels
+*
+*   Structure-of-arrays particle update, SIMD (SSE2/NEON) and scalar kernels.
+*
+**********************************************************************************************/
+
+#include "particle_kernels.h"
+
+#include <stdlib.h>     // Required for: calloc(), free()
+#include <stdint.h>     // Required for: uintptr_t
+
+#if defined(PARTICLES_SIMD_SSE2)
+    #include <emmintrin.h>  // Required for: SSE2 intrinsics
+#elif defined(PARTICLES_SIMD_NEON)
+    #include <arm_neon.h>   // Required for: NEON intrinsics
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PARTICLE_ARRAYS_ALIGNMENT   16
+#define PARTICLE_ARRAYS_COUNT       9       // Attribute arrays, all 4 bytes per particle
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static int GetUpdateCount(const ParticleArrays *particles);     // Get particles to update, count padded to PARTICLE_LANES
+static float GetDamping(ParticleForces forces, float deltaTime);    // Get velocity scale for a step
+
+//----------------------------------------------------------------------------------
+// Particle Kernels Functions Definition
+//----------------------------------------------------------------------------------
+
+// Allocate particle arrays (capacity padded to PARTICLE_LANES)
+// NOTE: Arrays are laid out back to back in one aligned block, every array starts 16-byte aligned
+bool LoadParticleArrays(ParticleArrays *particles, int capacity)
+{
+    *particles = (ParticleArrays){ 0 };
+
+    if (capacity <= 0) return false;
+
+    const int paddedCapacity = (capacity + PARTICLE_LANES - 1)/PARTICLE_LANES*PARTICLE_LANES;
+    particles->memory = calloc((size_t)paddedCapacity*PARTICLE_ARRAYS_COUNT*sizeof(float) + PARTICLE_ARRAYS_ALIGNMENT, 1);
+
+    if (particles->memory == NULL) return false;
+
+    float *base = (float *)(((uintptr_t)particles->memory + PARTICLE_ARRAYS_ALIGNMENT - 1) & ~(uintptr_t)(PARTICLE_ARRAYS_ALIGNMENT - 1));
+
+    particles->positionX = base;
+    particles->positionY = base + paddedCapacity;
+    particles->positionZ = base + paddedCapacity*2;
+    particles->velocityX = base + paddedCapacity*3;
+    particles->velocityY = base + paddedCapacity*4;
+    particles->velocityZ = base + paddedCapacity*5;
+    particles->life = base + paddedCapacity*6;
+    particles->size = base + paddedCapacity*7;
+    particles->color = (unsigned int *)(base + paddedCapacity*8);
+    particles->capacity = paddedCapacity;
+
+    return true;
+}
+
+// Free particle arrays
+void UnloadParticleArrays(ParticleArrays *particles)
+{
+    free(particles->memory);
+
+    *particles = (ParticleArrays){ 0 };
+}
+
+// Update particles, scalar kernel
+void UpdateParticlesScalar(ParticleArrays *particles, ParticleForces forces, float deltaTime)
+{
+    const int count = GetUpdateCount(particles);
+    const float damping = GetDamping(forces, deltaTime);
+    const float gravityStep = forces.gravity*deltaTime;
+
+    float *px = particles->positionX;
+    float *py = particles->positionY;
+    float *pz = particles->positionZ;
+    float *vx = particles->velocityX;
+    float *vy = particles->velocityY;
+    float *vz = particles->velocityZ;
+    float *life = particles->life;
+
+    for (int i = 0; i < count; i++)
+    {
+        vx[i] = vx[i]*damping;
+        vy[i] = (vy[i] - gravityStep)*damping;
+        vz[i] = vz[i]*damping;
+
+        px[i] = px[i] + vx[i]*deltaTime;
+        py[i] = py[i] + vy[i]*deltaTime;
+        pz[i] = pz[i] + vz[i]*deltaTime;
+
+        life[i] = (py[i] < forces.floorY)? 0.0f : life[i] - deltaTime;
+    }
+}
+
+// Update particles, SIMD kernel (scalar kernel if no SIMD available)
+// NOTE: Padding particles past count are updated too, they are never drawn or compacted in
+void UpdateParticlesSimd(ParticleArrays *particles, ParticleForces forces, float deltaTime)
+{
+#if defined(PARTICLES_SIMD_SSE2)
+    const int count = GetUpdateCount(particles);
+    const __m128 damping = _mm_set1_ps(GetDamping(forces, deltaTime));
+    const __m128 gravityStep = _mm_set1_ps(forces.gravity*deltaTime);
+    const __m128 step = _mm_set1_ps(deltaTime);
+    const __m128 floorY = _mm_set1_ps(forces.floorY);
+
+    for (int i = 0; i < count; i += PARTICLE_LANES)
+    {
+        const __m128 vx = _mm_mul_ps(_mm_load_ps(particles->velocityX + i), damping);
+        const __m128 vy = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(particles->velocityY + i), gravityStep), damping);
+        const __m128 vz = _mm_mul_ps(_mm_load_ps(particles->velocityZ + i), damping);
+
+        const __m128 px = _mm_add_ps(_mm_load_ps(particles->positionX + i), _mm_mul_ps(vx, step));
+        const __m128 py = _mm_add_ps(_mm_load_ps(particles->positionY + i), _mm_mul_ps(vy, step));
+        const __m128 pz = _mm_add_ps(_mm_load_ps(particles->positionZ + i), _mm_mul_ps(vz, step));
+
+        // Particles below floor get life 0 (mask clears lanes), others lose delta time
+        const __m128 belowFloor = _mm_cmplt_ps(py, floorY);
+        const __m128 life = _mm_andnot_ps(belowFloor, _mm_sub_ps(_mm_load_ps(particles->life + i), step));
+
+        _mm_store_ps(particles->velocityX + i, vx);
+        _mm_store_ps(particles->velocityY + i, vy);
+        _mm_store_ps(particles->velocityZ + i, vz);
+        _mm_store_ps(particles->positionX + i, px);
+        _mm_store_ps(particles->positionY + i, py);
+        _mm_store_ps(particles->positionZ + i, pz);
+        _mm_store_ps(particles->life + i, life);
+    }
+#elif defined(PARTICLES_SIMD_NEON)
+    const int count = GetUpdateCount(particles);
+    const float32x4_t damping = vdupq_n_f32(GetDamping(forces, deltaTime));
+    const float32x4_t gravityStep = vdupq_n_f32(forces.gravity*deltaTime);
+    const float32x4_t step = vdupq_n_f32(deltaTime);
+    const float32x4_t floorY = vdupq_n_f32(forces.floorY);
+
+    for (int i = 0; i < count; i += PARTICLE_LANES)
+    {
+        const float32x4_t vx = vmulq_f32(vld1q_f32(particles->velocityX + i), damping);
+        const float32x4_t vy = vmulq_f32(vsubq_f32(vld1q_f32(particles->velocityY + i), gravityStep), damping);
+        const float32x4_t vz = vmulq_f32(vld1q_f32(particles->velocityZ + i), damping);
+
+        const float32x4_t px = vaddq_f32(vld1q_f32(particles->positionX + i), vmulq_f32(vx, step));
+        const float32x4_t py = vaddq_f32(vld1q_f32(particles->positionY + i), vmulq_f32(vy, step));
+        const float32x4_t pz = vaddq_f32(vld1q_f32(particles->positionZ + i), vmulq_f32(vz, step));
+
+        // Particles below floor get life 0 (mask clears lanes), others lose delta time
+        const uint32x4_t belowFloor = vcltq_f32(py, floorY);
+        const float32x4_t life = vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(vsubq_f32(vld1q_f32(particles->life + i), step)), belowFloor));
+
+        vst1q_f32(particles->velocityX + i, vx);
+        vst1q_f32(particles->velocityY + i, vy);
+        vst1q_f32(particles->velocityZ + i, vz);
+        vst1q_f32(particles->positionX + i, px);
+        vst1q_f32(particles->positionY + i, py);
+        vst1q_f32(particles->positionZ + i, pz);
+        vst1q_f32(particles->life + i, life);
+    }
+#else
+    UpdateParticlesScalar(particles, forces, deltaTime);
+#endif
+}
+
+// Update particles with the fastest kernel available
+void UpdateParticles(ParticleArrays *particles, ParticleForces forces, float deltaTime)
+{
+    UpdateParticlesSimd(particles, forces, deltaTime);
+}
+
+// Remove dead particles (order not kept), returns particles alive
+// NOTE: Dead particles are replaced by the last one, so the arrays stay packed
+int CompactParticles(ParticleArrays *particles)
+{
+    int i = 0;
+
+    while (i < particles->count)
+    {
+        if (particles->life[i] > 0.0f)
+        {
+            i++;
+            continue;
+        }
+
+        const int last = particles->count - 1;
+
+        particles->positionX[i] = particles->positionX[last];
+        particles->positionY[i] = particles->positionY[last];
+        particles->positionZ[i] = particles->positionZ[last];
+        particles->velocityX[i] = particles->velocityX[last];
+        particles->velocityY[i] = particles->velocityY[last];
+        particles->velocityZ[i] = particles->velocityZ[last];
+        particles->life[i] = particles->life[last];
+        particles->size[i] = particles->size[last];
+        particles->color[i] = particles->color[last];
+        particles->count--;
+    }
+
+    return particles->count;
+}
+
+// Get SIMD kernel instruction set name ("SSE2", "NEON" or "scalar")
+const char *GetParticleKernelName(void)
+{
+#if defined(PARTICLES_SIMD_SSE2)
+    return "SSE2";
+#elif defined(PARTICLES_SIMD_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Get particles to update, count padded to PARTICLE_LANES
+static int GetUpdateCount(const ParticleArrays *particles)
+{
+    return (particles->count + PARTICLE_LANES - 1)/PARTICLE_LANES*PARTICLE_LANES;
+}
+
+// Get velocity scale for a step, drag applied linearly (never reverses velocity)
+static float GetDamping(ParticleForces forces, float deltaTime)
+{
+    const float damping = 1.0f - forces.drag*deltaTime;
+
+    return (damping > 0.0f)? damping : 0.0f;
+}
@@ -0,0 +1,79 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Particle kernels
+*
+*   Structure-of-arrays particle storage and its update kernels: every particle attribute is
+*   its own 16-byte aligned array, so the update runs 4 particles per instruction.
+*
+*   Kernels:
+*     - SIMD: SSE2 (x86/x64) or NEON (ARM), selected at compile time
+*     - Scalar: portable fallback (i.e. wasm), same operations in the same order, so both
+*       kernels produce the same results
+*
+*   NOTE: No raylib dependency, so headless tools (particle kernels benchmark) can link it
+*
+**********************************************************************************************/
+
+#ifndef PARTICLE_KERNELS_H
+#define PARTICLE_KERNELS_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define PARTICLES_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define PARTICLES_SIMD_NEON
+#endif
+
+#define PARTICLE_LANES          4           // Particles per SIMD update step, capacity is padded to it
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Particle arrays, one per attribute, particle i alive while life[i] > 0
+typedef struct ParticleArrays {
+    float *positionX;
+    float *positionY;
+    float *positionZ;
+    float *velocityX;
+    float *velocityY;
+    float *velocityZ;
+    float *life;                // Remaining life (seconds)
+    float *size;                // Billboard size (world units), not updated by kernels
+    unsigned int *color;        // RGBA bytes (raylib Color layout), not updated by kernels
+    int count;                  // Particles in use, alive or dead until compacted
+    int capacity;               // Multiple of PARTICLE_LANES
+    void *memory;               // Single allocation holding every array
+} ParticleArrays;
+
+// Particle forces, applied by update kernels
+typedef struct ParticleForces {
+    float gravity;              // Downwards acceleration (units/s^2)
+    float drag;                 // Velocity fraction lost per second [0..1]
+    float floorY;               // Particles are killed once below this height
+} ParticleForces;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Particle Kernels Functions Declaration
+//----------------------------------------------------------------------------------
+bool LoadParticleArrays(ParticleArrays *particles, int capacity);                   // Allocate particle arrays (capacity padded to PARTICLE_LANES)
+void UnloadParticleArrays(ParticleArrays *particles);                               // Free particle arrays
+void UpdateParticlesScalar(ParticleArrays *particles, ParticleForces forces, float deltaTime);  // Update particles, scalar kernel
+void UpdateParticlesSimd(ParticleArrays *particles, ParticleForces forces, float deltaTime);    // Update particles, SIMD kernel (scalar kernel if no SIMD available)
+void UpdateParticles(ParticleArrays *particles, ParticleForces forces, float deltaTime);        // Update particles with the fastest kernel available
+int CompactParticles(ParticleArrays *particles);                                    // Remove dead particles (order not kept), returns particles alive
+const char *GetParticleKernelName(void);                                            // Get SIMD kernel instruction set name ("SSE2", "NEON" or "scalar")
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTICLE_KERNELS_H
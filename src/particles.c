@@ -0,0 +1,259 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Particles
+*
+*   Particle emitters and instanced billboards drawing.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "raymath.h"
+#include "particles.h"
+
+#include <string.h>     // Required for: memcpy()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PARTICLES_VS_BODY \
+    "in vec2 vertexPosition;\n" \
+    "in float particleX;\n" \
+    "in float particleY;\n" \
+    "in float particleZ;\n" \
+    "in float particleSize;\n" \
+    "in vec4 particleColor;\n" \
+    "uniform mat4 mvp;\n" \
+    "uniform vec3 cameraRight;\n" \
+    "uniform vec3 cameraUp;\n" \
+    "out vec4 fragColor;\n" \
+    "out vec2 fragCorner;\n" \
+    "void main()\n" \
+    "{\n" \
+    "    vec3 position = vec3(particleX, particleY, particleZ) + (cameraRight*vertexPosition.x + cameraUp*vertexPosition.y)*particleSize;\n" \
+    "    fragColor = particleColor;\n" \
+    "    fragCorner = vertexPosition*2.0;\n" \
+    "    gl_Position = mvp*vec4(position, 1.0);\n" \
+    "}\n"
+
+#define PARTICLES_FS_BODY \
+    "in vec4 fragColor;\n" \
+    "in vec2 fragCorner;\n" \
+    "out vec4 finalColor;\n" \
+    "void main()\n" \
+    "{\n" \
+    "    if (dot(fragCorner, fragCorner) > 1.0) discard;\n" \
+    "    finalColor = fragColor;\n" \
+    "}\n"
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *particlesVsCode330 = "#version 330\n" PARTICLES_VS_BODY;
+static const char *particlesFsCode330 = "#version 330\n" PARTICLES_FS_BODY;
+static const char *particlesVsCode300es = "#version 300 es\n" PARTICLES_VS_BODY;
+static const char *particlesFsCode300es = "#version 300 es\nprecision mediump float;\n" PARTICLES_FS_BODY;
+
+// Billboard corners, two counter-clockwise triangles facing the camera
+static const float billboardCorners[12] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f };
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static float GetParticleRandomValue(ParticleSystem *system, float min, float max);  // Get random value from system random generator
+
+//----------------------------------------------------------------------------------
+// Particles Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load particle system (call after window initialization)
+ParticleSystem LoadParticleSystem(int capacity, ParticleForces forces)
+{
+    ParticleSystem system = { 0 };
+
+    system.forces = forces;
+    system.randomState = 0x9e3779b9u;
+
+    if (!LoadParticleArrays(&system.particles, capacity))
+    {
+        TraceLog(LOG_WARNING, "PARTICLES: Failed to allocate %i particles", capacity);
+        return system;
+    }
+
+    const int glVersion = rlGetVersion();
+    system.instancing = (glVersion == RL_OPENGL_33) || (glVersion == RL_OPENGL_43) || (glVersion == RL_OPENGL_ES_30);
+
+    if (system.instancing)
+    {
+        if (glVersion == RL_OPENGL_ES_30) system.shader = LoadShaderFromMemory(particlesVsCode300es, particlesFsCode300es);
+        else system.shader = LoadShaderFromMemory(particlesVsCode330, particlesFsCode330);
+
+        // NOTE: On compilation failure default shader is returned, it must not be modified
+        const bool shaderLoaded = IsShaderReady(system.shader) && (system.shader.id != rlGetShaderIdDefault());
+        const char *attribNames[5] = { "particleX", "particleY", "particleZ", "particleSize", "particleColor" };
+        int attribLocs[5] = { -1, -1, -1, -1, -1 };
+
+        for (int i = 0; (i < 5) && shaderLoaded; i++)
+        {
+            attribLocs[i] = GetShaderLocationAttrib(system.shader, attribNames[i]);
+            if (attribLocs[i] < 0) system.instancing = false;
+        }
+
+        system.instancing = system.instancing && shaderLoaded;
+
+        if (system.instancing)
+        {
+            system.shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(system.shader, "mvp");
+            system.cameraRightLoc = GetShaderLocation(system.shader, "cameraRight");
+            system.cameraUpLoc = GetShaderLocation(system.shader, "cameraUp");
+
+            system.vaoId = rlLoadVertexArray();
+            rlEnableVertexArray(system.vaoId);
+
+            // Billboard corners (location 0, same location raylib binds vertexPosition by name)
+            system.vboIds[0] = rlLoadVertexBuffer(billboardCorners, sizeof(billboardCorners), false);
+            rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, 0);
+            rlEnableVertexAttribute(0);
+
+            // Instance buffers, one per particle array, advanced once per instance
+            for (int i = 0; i < 5; i++)
+            {
+                system.vboIds[i + 1] = rlLoadVertexBuffer(NULL, system.particles.capacity*sizeof(float), true);
+                if (i < 4) rlSetVertexAttribute(attribLocs[i], 1, RL_FLOAT, false, 0, 0);
+                else rlSetVertexAttribute(attribLocs[i], 4, RL_UNSIGNED_BYTE, true, 0, 0);
+                rlEnableVertexAttribute(attribLocs[i]);
+                rlSetVertexAttributeDivisor(attribLocs[i], 1);
+            }
+
+            rlDisableVertexArray();
+            rlDisableVertexBuffer();
+        }
+        else
+        {
+            TraceLog(LOG_WARNING, "PARTICLES: Failed to load particles shader, drawing through rlgl batch");
+            if (shaderLoaded) UnloadShader(system.shader);
+            system.shader = (Shader){ 0 };
+        }
+    }
+
+    TraceLog(LOG_INFO, "PARTICLES: %i particles, %s update kernel, %s", system.particles.capacity, GetParticleKernelName(), system.instancing? "instanced" : "batched");
+
+    return system;
+}
+
+// Unload particle system
+void UnloadParticleSystem(ParticleSystem *system)
+{
+    if (system->vaoId != 0) rlUnloadVertexArray(system->vaoId);
+    for (int i = 0; i < 6; i++) if (system->vboIds[i] != 0) rlUnloadVertexBuffer(system->vboIds[i]);
+    if (system->shader.id != 0) UnloadShader(system->shader);
+
+    UnloadParticleArrays(&system->particles);
+
+    *system = (ParticleSystem){ 0 };
+}
+
+// Emit particles, dropped once at capacity
+void EmitParticles(ParticleSystem *system, ParticleEmitter emitter, int count)
+{
+    ParticleArrays *particles = &system->particles;
+    unsigned int color = 0;
+    memcpy(&color, &emitter.color, sizeof(unsigned int));
+
+    if (count > particles->capacity - particles->count) count = particles->capacity - particles->count;
+
+    for (int i = particles->count; i < particles->count + count; i++)
+    {
+        particles->positionX[i] = emitter.position.x;
+        particles->positionY[i] = emitter.position.y;
+        particles->positionZ[i] = emitter.position.z;
+        particles->velocityX[i] = emitter.velocity.x + GetParticleRandomValue(system, -emitter.spread, emitter.spread);
+        particles->velocityY[i] = emitter.velocity.y + GetParticleRandomValue(system, -emitter.spread, emitter.spread);
+        particles->velocityZ[i] = emitter.velocity.z + GetParticleRandomValue(system, -emitter.spread, emitter.spread);
+        particles->life[i] = emitter.life*GetParticleRandomValue(system, 0.75f, 1.25f);
+        particles->size[i] = emitter.size;
+        particles->color[i] = color;
+    }
+
+    particles->count += (count > 0)? count : 0;
+}
+
+// Update particles and remove dead ones
+void UpdateParticleSystem(ParticleSystem *system, float deltaTime)
+{
+    if (system->particles.count == 0) return;
+
+    UpdateParticles(&system->particles, system->forces, deltaTime);
+    CompactParticles(&system->particles);
+}
+
+// Draw particles (call inside 3D mode)
+// NOTE: Billboards face the camera using current modelview matrix axes
+void DrawParticleSystem(ParticleSystem *system)
+{
+    const ParticleArrays *particles = &system->particles;
+    if (particles->count == 0) return;
+
+    const Matrix view = rlGetMatrixModelview();
+    const Vector3 right = { view.m0, view.m4, view.m8 };
+    const Vector3 up = { view.m1, view.m5, view.m9 };
+
+    if (!system->instancing)
+    {
+        for (int i = 0; i < particles->count; i++)
+        {
+            const float halfSize = particles->size[i]*0.5f;
+            const Vector3 position = { particles->positionX[i], particles->positionY[i], particles->positionZ[i] };
+            const Vector3 offsetRight = Vector3Scale(right, halfSize);
+            const Vector3 offsetUp = Vector3Scale(up, halfSize);
+            Color color = { 0 };
+            memcpy(&color, &particles->color[i], sizeof(Color));
+
+            rlCheckRenderBatchLimit(4);
+
+            rlBegin(RL_QUADS);
+                rlColor4ub(color.r, color.g, color.b, color.a);
+                rlVertex3f(position.x - offsetRight.x - offsetUp.x, position.y - offsetRight.y - offsetUp.y, position.z - offsetRight.z - offsetUp.z);
+                rlVertex3f(position.x + offsetRight.x - offsetUp.x, position.y + offsetRight.y - offsetUp.y, position.z + offsetRight.z - offsetUp.z);
+                rlVertex3f(position.x + offsetRight.x + offsetUp.x, position.y + offsetRight.y + offsetUp.y, position.z + offsetRight.z + offsetUp.z);
+                rlVertex3f(position.x - offsetRight.x + offsetUp.x, position.y - offsetRight.y + offsetUp.y, position.z - offsetRight.z + offsetUp.z);
+            rlEnd();
+        }
+
+        return;
+    }
+
+    rlDrawRenderBatchActive();      // Flush batched draws issued before particles
+
+    const int dataSize = particles->count*(int)sizeof(float);
+    rlUpdateVertexBuffer(system->vboIds[1], particles->positionX, dataSize, 0);
+    rlUpdateVertexBuffer(system->vboIds[2], particles->positionY, dataSize, 0);
+    rlUpdateVertexBuffer(system->vboIds[3], particles->positionZ, dataSize, 0);
+    rlUpdateVertexBuffer(system->vboIds[4], particles->size, dataSize, 0);
+    rlUpdateVertexBuffer(system->vboIds[5], particles->color, dataSize, 0);
+
+    rlEnableShader(system->shader.id);
+    rlSetUniformMatrix(system->shader.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(view, rlGetMatrixProjection()));
+    rlSetUniform(system->cameraRightLoc, &right, RL_SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(system->cameraUpLoc, &up, RL_SHADER_UNIFORM_VEC3, 1);
+
+    rlEnableVertexArray(system->vaoId);
+    rlDrawVertexArrayInstanced(0, 6, particles->count);
+    rlDisableVertexArray();
+
+    rlDisableShader();
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Get random value from system random generator (xorshift32)
+static float GetParticleRandomValue(ParticleSystem *system, float min, float max)
+{
+    system->randomState ^= system->randomState << 13;
+    system->randomState ^= system->randomState >> 17;
+    system->randomState ^= system->randomState << 5;
+
+    return min + (max - min)*(float)(system->randomState >> 8)/16777216.0f;
+}
@@ -0,0 +1,62 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Particles
+*
+*   Particle system on top of the structure-of-arrays particle kernels: emitters, update and
+*   drawing. Particles are camera facing round billboards drawn in one instanced draw call,
+*   the attribute arrays are uploaded as they are (one instance buffer per array, no repacking).
+*   Without instancing support (OpenGL 2.1, ES 2.0) billboards go through the rlgl batch.
+*
+**********************************************************************************************/
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "raylib.h"
+#include "particle_kernels.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Particle emitter, particles spawned with randomized velocity and life
+typedef struct ParticleEmitter {
+    Vector3 position;
+    Vector3 velocity;           // Base velocity
+    float spread;               // Random velocity added on every axis [-spread..spread]
+    float life;                 // Base life (seconds), randomized by +-25%
+    float size;                 // Billboard size (world units)
+    Color color;
+} ParticleEmitter;
+
+// Particle system
+typedef struct ParticleSystem {
+    ParticleArrays particles;
+    ParticleForces forces;
+    unsigned int randomState;   // Emitters random generator
+    bool instancing;            // Instanced draw supported, otherwise drawn through rlgl batch
+    Shader shader;
+    int cameraRightLoc;
+    int cameraUpLoc;
+    unsigned int vaoId;
+    unsigned int vboIds[6];     // Billboard corners and instance buffers (position x, y, z, size, color)
+} ParticleSystem;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Particles Functions Declaration
+//----------------------------------------------------------------------------------
+ParticleSystem LoadParticleSystem(int capacity, ParticleForces forces);    // Load particle system (call after window initialization)
+void UnloadParticleSystem(ParticleSystem *system);                          // Unload particle system
+void EmitParticles(ParticleSystem *system, ParticleEmitter emitter, int count);    // Emit particles, dropped once at capacity
+void UpdateParticleSystem(ParticleSystem *system, float deltaTime);         // Update particles and remove dead ones
+void DrawParticleSystem(ParticleSystem *system);                            // Draw particles (call inside 3D mode)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARTICLES_H
@@ -0,0 +1,157 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Price display
+*
+*   Odometer price display and fuel gauge fragment shader.
+*
+*   Wheel k (place value 10^k cents) shows digit k of the integer cents and only rolls while
+*   the wheels below it go from 9 to 0, over the last cent of their range, like a mechanical
+*   counter. Cents wheel rolls continuously with the fraction of the next cent.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "price_display.h"
+
+#include <stddef.h>     // Required for: NULL
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define DIGIT_ATLAS_CELLS       13          // Digits 0-9, 0 (wheel wrap), '$', '.'
+#define DIGIT_CELL_WIDTH        24
+#define DIGIT_CELL_HEIGHT       32
+#define DIGIT_FONT_SIZE         30
+
+// NOTE: Body is shared by every GLSL version, prefixes define IN, TEXTURE and OUTPUT.
+// Digits (dollars, dimes, cents) are small integers, exact at any float precision
+#define PRICE_DISPLAY_FS_BODY \
+    "IN vec2 fragTexCoord;\n" \
+    "IN vec4 fragColor;\n" \
+    "uniform sampler2D texture0;\n" \
+    "uniform vec3 digits;\n" \
+    "uniform float roll;\n" \
+    "uniform vec2 gauge;\n" \
+    "const float atlasCells = 13.0;\n" \
+    "const vec3 panelColor = vec3(0.05, 0.06, 0.05);\n" \
+    "const vec3 digitColor = vec3(1.0, 0.72, 0.2);\n" \
+    "void main()\n" \
+    "{\n" \
+    "    vec2 uv = fragTexCoord;\n" \
+    "    vec3 color = panelColor;\n" \
+    "    if (uv.y < 0.7)\n" \
+    "    {\n" \
+    "        float slot = floor(uv.x*5.0);\n" \
+    "        vec2 local = vec2(fract(uv.x*5.0), uv.y/0.7);\n" \
+    "        float rollTens = (digits.z == 9.0)? roll : 0.0;\n" \
+    "        float cell = 11.0;\n" \
+    "        if (slot == 1.0) cell = digits.x + ((digits.y == 9.0)? rollTens : 0.0);\n" \
+    "        else if (slot == 2.0) cell = 12.0;\n" \
+    "        else if (slot == 3.0) cell = digits.y + rollTens;\n" \
+    "        else if (slot == 4.0) cell = digits.z + roll;\n" \
+    "        float glyph = TEXTURE(texture0, vec2(local.x, (cell + local.y)/atlasCells)).a;\n" \
+    "        float shade = 1.0 - 0.6*pow(abs(local.y*2.0 - 1.0), 2.0);\n" \
+    "        color = mix(panelColor, digitColor, glyph)*shade;\n" \
+    "    }\n" \
+    "    else if (uv.y > 0.75)\n" \
+    "    {\n" \
+    "        float fill = min(gauge.x, 1.0);\n" \
+    "        vec3 fillColor = (gauge.y > 0.5)? vec3(0.9, 0.16, 0.22) : mix(vec3(0.0, 0.89, 0.19), vec3(1.0, 0.63, 0.0), fill*fill);\n" \
+    "        color = (uv.x*1.25 <= gauge.x)? fillColor : vec3(0.15);\n" \
+    "        if (abs(uv.x - 0.8) < 0.01) color = vec3(1.0);\n" \
+    "    }\n" \
+    "    OUTPUT = vec4(color, 1.0)*fragColor;\n" \
+    "}\n"
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *priceDisplayFsCode330 = "#version 330\n#define IN in\n#define TEXTURE texture\nout vec4 finalColor;\n#define OUTPUT finalColor\n" PRICE_DISPLAY_FS_BODY;
+static const char *priceDisplayFsCode300es = "#version 300 es\nprecision highp float;\n#define IN in\n#define TEXTURE texture\nout vec4 finalColor;\n#define OUTPUT finalColor\n" PRICE_DISPLAY_FS_BODY;
+static const char *priceDisplayFsCode120 = "#version 120\n#define IN varying\n#define TEXTURE texture2D\n#define OUTPUT gl_FragColor\n" PRICE_DISPLAY_FS_BODY;
+static const char *priceDisplayFsCode100 = "#version 100\n#ifdef GL_FRAGMENT_PRECISION_HIGH\nprecision highp float;\n#else\nprecision mediump float;\n#endif\n"
+    "#define IN varying\n#define TEXTURE texture2D\n#define OUTPUT gl_FragColor\n" PRICE_DISPLAY_FS_BODY;
+
+//----------------------------------------------------------------------------------
+// Price Display Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load price display shader and digit atlas (call after window initialization)
+// NOTE: Shader uses raylib default vertex shader, fragment shader version must match it
+PriceDisplay LoadPriceDisplay(void)
+{
+    PriceDisplay display = { 0 };
+
+    switch (rlGetVersion())
+    {
+        case RL_OPENGL_21: display.shader = LoadShaderFromMemory(NULL, priceDisplayFsCode120); break;
+        case RL_OPENGL_ES_20: display.shader = LoadShaderFromMemory(NULL, priceDisplayFsCode100); break;
+        case RL_OPENGL_ES_30: display.shader = LoadShaderFromMemory(NULL, priceDisplayFsCode300es); break;
+        default: display.shader = LoadShaderFromMemory(NULL, priceDisplayFsCode330); break;
+    }
+
+    display.digitsLoc = GetShaderLocation(display.shader, "digits");
+    display.rollLoc = GetShaderLocation(display.shader, "roll");
+    display.gaugeLoc = GetShaderLocation(display.shader, "gauge");
+
+    // Digit atlas, one centered glyph per cell, glyph coverage in alpha
+    const char *cells[DIGIT_ATLAS_CELLS] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "0", "$", "." };
+    Image atlas = GenImageColor(DIGIT_CELL_WIDTH, DIGIT_CELL_HEIGHT*DIGIT_ATLAS_CELLS, BLANK);
+
+    for (int i = 0; i < DIGIT_ATLAS_CELLS; i++)
+    {
+        const int textWidth = MeasureText(cells[i], DIGIT_FONT_SIZE);
+        ImageDrawText(&atlas, cells[i], (DIGIT_CELL_WIDTH - textWidth)/2, i*DIGIT_CELL_HEIGHT + (DIGIT_CELL_HEIGHT - DIGIT_FONT_SIZE)/2, DIGIT_FONT_SIZE, WHITE);
+    }
+
+    display.digitAtlas = LoadTextureFromImage(atlas);
+    SetTextureFilter(display.digitAtlas, TEXTURE_FILTER_BILINEAR);
+    UnloadImage(atlas);
+
+    return display;
+}
+
+// Unload price display
+void UnloadPriceDisplay(PriceDisplay *display)
+{
+    if (display->shader.id != 0) UnloadShader(display->shader);
+    if (display->digitAtlas.id != 0) UnloadTexture(display->digitAtlas);
+
+    *display = (PriceDisplay){ 0 };
+}
+
+// Draw price display quad facing +Z (call inside 3D mode)
+// NOTE: Roll is the fraction of the next cent (0..1), gauge fill is relative to the target price
+void DrawPriceDisplay(PriceDisplay display, Vector3 center, Vector2 size, int cents, float roll, int targetCents)
+{
+    if (cents < 0) cents = 0;
+
+    const Vector3 digits = { (float)((cents/100)%10), (float)((cents/10)%10), (float)(cents%10) };
+    const Vector2 gauge = { (cents + roll)/((targetCents > 0)? targetCents : 1), (cents > targetCents)? 1.0f : 0.0f };
+
+    const float left = center.x - size.x*0.5f;
+    const float right = center.x + size.x*0.5f;
+    const float top = center.y + size.y*0.5f;
+    const float bottom = center.y - size.y*0.5f;
+
+    // NOTE: Uniforms are set before the quad is batched, shader mode change flushes it with them
+    BeginShaderMode(display.shader);
+
+        SetShaderValue(display.shader, display.digitsLoc, &digits, SHADER_UNIFORM_VEC3);
+        SetShaderValue(display.shader, display.rollLoc, &roll, SHADER_UNIFORM_FLOAT);
+        SetShaderValue(display.shader, display.gaugeLoc, &gauge, SHADER_UNIFORM_VEC2);
+
+        rlSetTexture(display.digitAtlas.id);
+        rlBegin(RL_QUADS);
+            rlColor4ub(255, 255, 255, 255);
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+            rlTexCoord2f(0.0f, 0.0f); rlVertex3f(left, top, center.z);
+            rlTexCoord2f(0.0f, 1.0f); rlVertex3f(left, bottom, center.z);
+            rlTexCoord2f(1.0f, 1.0f); rlVertex3f(right, bottom, center.z);
+            rlTexCoord2f(1.0f, 0.0f); rlVertex3f(right, top, center.z);
+        rlEnd();
+        rlSetTexture(0);
+
+    EndShaderMode();
+}
@@ -0,0 +1,47 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Price display
+*
+*   Pump price display drawn by a fragment shader on a single quad: odometer style rolling
+*   digit wheels ($D.DD) over a fuel gauge filling towards the target price. The shader only
+*   takes current price digits, wheels roll and gauge fill as uniforms and reads digits from a
+*   small atlas texture generated at load, so no text is formatted or rasterized while the price
+*   changes. Digits are computed from integer cents, so the display never disagrees with the
+*   scored price because of shader float precision.
+*
+**********************************************************************************************/
+
+#ifndef PRICE_DISPLAY_H
+#define PRICE_DISPLAY_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Price display
+typedef struct PriceDisplay {
+    Shader shader;
+    Texture2D digitAtlas;       // Digit wheel cells stacked vertically: 0-9, 0 (wheel wrap), '$', '.'
+    int digitsLoc;
+    int rollLoc;
+    int gaugeLoc;
+} PriceDisplay;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Price Display Functions Declaration
+//----------------------------------------------------------------------------------
+PriceDisplay LoadPriceDisplay(void);                        // Load price display shader and digit atlas (call after window initialization)
+void UnloadPriceDisplay(PriceDisplay *display);             // Unload price display
+void DrawPriceDisplay(PriceDisplay display, Vector3 center, Vector2 size, int cents, float roll, int targetCents);  // Draw price display quad facing +Z (call inside 3D mode)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRICE_DISPLAY_H
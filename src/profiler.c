@@ -0,0 +1,493 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Frame profiler
+*
+*   Per-phase CPU/GPU frame timings recorder and overlay.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"       // Required for: rlDrawRenderBatchActive()
+#include "profiler.h"
+
+#include <stdio.h>      // Required for: FILE, fopen(), fprintf()
+#include <stdlib.h>     // Required for: qsort()
+#include <string.h>     // Required for: strcmp()
+
+// NOTE: GL timer queries only available on desktop OpenGL 3.3+, functions loaded through GLFW
+// (built into raylib), so no GL loader header is required
+#if defined(PLATFORM_DESKTOP) && (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_43))
+    #define PROFILER_GPU_TIMING
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PROFILE_GPU_LATENCY     4           // Frames until GPU query results are read back
+#define PROFILE_GRAPH_FRAMES    240         // Frames shown in graph and used for percentiles
+#define PROFILE_AVERAGE_FRAMES  60          // Frames averaged for phase timings
+
+#if defined(PROFILER_GPU_TIMING)
+    #define GL_TIME_ELAPSED             0x88BF
+    #define GL_QUERY_RESULT             0x8866
+    #define GL_QUERY_RESULT_AVAILABLE   0x8867
+
+    #if defined(_WIN32)
+        #define PROFILER_GLAPI __stdcall
+    #else
+        #define PROFILER_GLAPI
+    #endif
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+#if defined(PROFILER_GPU_TIMING)
+typedef void (*GLFWglproc)(void);
+GLFWglproc glfwGetProcAddress(const char *procname);
+
+typedef void (PROFILER_GLAPI *GenQueriesProc)(int n, unsigned int *ids);
+typedef void (PROFILER_GLAPI *DeleteQueriesProc)(int n, const unsigned int *ids);
+typedef void (PROFILER_GLAPI *BeginQueryProc)(unsigned int target, unsigned int id);
+typedef void (PROFILER_GLAPI *EndQueryProc)(unsigned int target);
+typedef void (PROFILER_GLAPI *GetQueryObjectivProc)(unsigned int id, unsigned int pname, int *params);
+typedef void (PROFILER_GLAPI *GetQueryObjectui64vProc)(unsigned int id, unsigned int pname, unsigned long long *params);
+#endif
+
+// Profiled section, timings accumulated over the session (seconds)
+typedef struct ProfileSection {
+    const char *name;
+    int frameCount;
+    int drawnCount;
+    double elapsedTime;         // Time from first frame start to last frame end, waiting included
+    double cpuTime;             // Frames work time
+    double gpuTime;             // GPU time of GPU timed frames
+    double gpuElapsedTime;      // Elapsed time of GPU timed frames
+} ProfileSection;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *phaseNames[PROFILE_PHASE_COUNT] = { "update", "draw", "transition", "swap" };
+static const Color phaseColors[PROFILE_PHASE_COUNT] = {
+    { 102, 191, 255, 255 },     // SKYBLUE
+    { 0, 158, 47, 255 },        // LIME
+    { 255, 161, 0, 255 },       // ORANGE
+    { 135, 60, 190, 255 },      // VIOLET
+};
+
+static ProfileFrame frames[MAX_PROFILE_FRAMES] = { 0 };
+static long long frameCounter = -1;         // Current frame index, frames[frameCounter%MAX_PROFILE_FRAMES]
+static double frameStartTime = 0.0;
+static double scopeStartTime[PROFILE_PHASE_COUNT] = { 0 };
+
+static ProfileSection sections[MAX_PROFILE_SECTIONS] = { 0 };
+static int sectionCount = 0;
+static int currentSection = -1;
+
+static bool overlayVisible = false;
+static bool profilerUsed = false;
+static bool gpuTimingEnabled = false;       // GPU timing enabled with overlay hidden
+static bool frameGpuTiming = false;         // GPU timing active on current frame
+static long long lastDrawnFrame = -1;       // Latest finished frame that has been drawn
+static long long lastGpuDrawnFrame = -1;    // Latest drawn frame with GPU results read back
+
+#if defined(PROFILER_GPU_TIMING)
+static GenQueriesProc glGenQueriesProc = NULL;
+static DeleteQueriesProc glDeleteQueriesProc = NULL;
+static BeginQueryProc glBeginQueryProc = NULL;
+static EndQueryProc glEndQueryProc = NULL;
+static GetQueryObjectivProc glGetQueryObjectivProc = NULL;
+static GetQueryObjectui64vProc glGetQueryObjectui64vProc = NULL;
+
+static unsigned int queries[PROFILE_GPU_LATENCY][PROFILE_PHASE_COUNT] = { 0 };
+static long long queryFrame[PROFILE_GPU_LATENCY] = { 0 };      // Frame that issued slot queries, -1 if none
+static bool queryIssued[PROFILE_GPU_LATENCY][PROFILE_PHASE_COUNT] = { 0 };
+static bool gpuTimingSupported = false;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static int CompareFloat(const void *a, const void *b);     // Compare floats, used for sorting
+static void AccountProfileFrame(long long index, double elapsedTime);   // Account finished frame to its section
+#if defined(PROFILER_GPU_TIMING)
+static void LoadGpuQueries(void);                           // Load GL timer query functions and query objects
+static void ResolveGpuQueries(int slot);                    // Read back query results of slot into its frame
+#endif
+
+//----------------------------------------------------------------------------------
+// Profiler Functions Definition
+//----------------------------------------------------------------------------------
+
+// Initialize profiler
+void InitProfiler(void)
+{
+    frameCounter = -1;
+    frameStartTime = GetTime();
+    sectionCount = 0;
+    currentSection = -1;
+    overlayVisible = false;
+    profilerUsed = false;
+    gpuTimingEnabled = false;
+    frameGpuTiming = false;
+    lastDrawnFrame = -1;
+    lastGpuDrawnFrame = -1;
+}
+
+// Close profiler, unloads GPU queries
+void CloseProfiler(void)
+{
+#if defined(PROFILER_GPU_TIMING)
+    if (gpuTimingSupported) glDeleteQueriesProc(PROFILE_GPU_LATENCY*PROFILE_PHASE_COUNT, &queries[0][0]);
+    gpuTimingSupported = false;
+#endif
+}
+
+// Begin frame recording (call at frame start)
+void BeginProfileFrame(void)
+{
+    const double time = GetTime();
+
+    if (frameCounter >= 0) AccountProfileFrame(frameCounter, time - frameStartTime);
+
+    frameCounter++;
+    ProfileFrame *frame = &frames[frameCounter%MAX_PROFILE_FRAMES];
+    *frame = (ProfileFrame){ 0 };
+    frame->frameTime = (frameCounter > 0)? (float)((time - frameStartTime)*1000.0) : 0.0f;
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++) frame->gpuTime[i] = -1.0f;
+    frame->section = currentSection;
+    frameStartTime = time;
+
+#if defined(PROFILER_GPU_TIMING)
+    frameGpuTiming = (overlayVisible || gpuTimingEnabled) && gpuTimingSupported;
+
+    // NOTE: Slot is reused every PROFILE_GPU_LATENCY frames, results are read before issuing new queries
+    if (gpuTimingSupported) ResolveGpuQueries((int)(frameCounter%PROFILE_GPU_LATENCY));
+    if (frameGpuTiming) queryFrame[frameCounter%PROFILE_GPU_LATENCY] = frameCounter;
+#endif
+}
+
+// End frame recording
+void EndProfileFrame(void)
+{
+    frames[frameCounter%MAX_PROFILE_FRAMES].workTime = (float)((GetTime() - frameStartTime)*1000.0);
+}
+
+// Begin timing frame phase
+void BeginProfileScope(ProfilePhase phase)
+{
+#if defined(PROFILER_GPU_TIMING)
+    if (frameGpuTiming)
+    {
+        rlDrawRenderBatchActive();      // Flush previous phase draws
+        glBeginQueryProc(GL_TIME_ELAPSED, queries[frameCounter%PROFILE_GPU_LATENCY][phase]);
+        queryIssued[frameCounter%PROFILE_GPU_LATENCY][phase] = true;
+    }
+#endif
+
+    if (phase == PROFILE_PHASE_DRAW) frames[frameCounter%MAX_PROFILE_FRAMES].drawn = true;
+
+    scopeStartTime[phase] = GetTime();
+}
+
+// End timing frame phase
+void EndProfileScope(ProfilePhase phase)
+{
+#if defined(PROFILER_GPU_TIMING)
+    if (frameGpuTiming)
+    {
+        rlDrawRenderBatchActive();      // Flush this phase draws
+        glEndQueryProc(GL_TIME_ELAPSED);
+    }
+#endif
+
+    frames[frameCounter%MAX_PROFILE_FRAMES].cpuTime[phase] += (float)((GetTime() - scopeStartTime[phase])*1000.0);
+}
+
+// Set section current and next frames are accounted to (name must stay valid)
+// NOTE: Sections are matched by name, only first MAX_PROFILE_SECTIONS names get a section
+void SetProfileSection(const char *name)
+{
+    int section = -1;
+    for (int i = 0; (i < sectionCount) && (section < 0); i++) if (strcmp(sections[i].name, name) == 0) section = i;
+
+    if ((section < 0) && (sectionCount < MAX_PROFILE_SECTIONS))
+    {
+        section = sectionCount++;
+        sections[section] = (ProfileSection){ 0 };
+        sections[section].name = name;
+    }
+
+    currentSection = section;
+    if (frameCounter >= 0) frames[frameCounter%MAX_PROFILE_FRAMES].section = section;
+}
+
+// Toggle overlay visibility and GPU timing
+void ToggleProfilerOverlay(void)
+{
+    overlayVisible = !overlayVisible;
+    profilerUsed = true;
+
+#if defined(PROFILER_GPU_TIMING)
+    if (overlayVisible && (glGenQueriesProc == NULL)) LoadGpuQueries();
+#endif
+}
+
+// Check if overlay is visible
+bool IsProfilerOverlayVisible(void)
+{
+    return overlayVisible;
+}
+
+// Check if overlay has been shown during the session
+bool IsProfilerUsed(void)
+{
+    return profilerUsed;
+}
+
+// Enable GPU timing with overlay hidden, to measure GPU duty cycles
+// NOTE: Render batch is flushed at every scope boundary while enabled, adding some draw calls
+void SetProfilerGpuTiming(bool enabled)
+{
+    gpuTimingEnabled = enabled;
+
+#if defined(PROFILER_GPU_TIMING)
+    if (enabled && (glGenQueriesProc == NULL)) LoadGpuQueries();
+#endif
+}
+
+// Get latest drawn frame timings, returns frame index (-1 if none)
+// NOTE: While GPU timing is active, latest frame with GPU results read back is returned (a few frames old)
+long long GetProfilerLastDrawnFrame(ProfileFrame *frame)
+{
+    long long index = lastDrawnFrame;
+
+#if defined(PROFILER_GPU_TIMING)
+    if ((overlayVisible || gpuTimingEnabled) && gpuTimingSupported) index = lastGpuDrawnFrame;
+#endif
+
+    if ((index < 0) || (frameCounter - index >= MAX_PROFILE_FRAMES)) return -1;
+
+    *frame = frames[index%MAX_PROFILE_FRAMES];
+
+    return index;
+}
+
+// Log per-section CPU/GPU duty cycles and drawn frames ratio
+// NOTE: CPU duty cycle is frame work time over elapsed time (waiting for next frame excluded),
+// GPU duty cycle is only available for sections that run with GPU timing active
+void LogProfilerDutyCycles(void)
+{
+    for (int i = 0; i < sectionCount; i++)
+    {
+        const ProfileSection *section = &sections[i];
+        if ((section->frameCount == 0) || (section->elapsedTime <= 0.0)) continue;
+
+        const char *gpuText = (section->gpuElapsedTime > 0.0)? TextFormat("%5.1f%%", 100.0*section->gpuTime/section->gpuElapsedTime) : "  n/a";
+
+        TraceLog(LOG_INFO, "PROFILER: Duty cycle [%-10s] CPU %5.1f%%, GPU %s, %i/%i frames drawn (%.1f s)", section->name,
+            100.0*section->cpuTime/section->elapsedTime, gpuText, section->drawnCount, section->frameCount, section->elapsedTime);
+    }
+}
+
+// Draw overlay, if visible
+void DrawProfilerOverlay(void)
+{
+    if (!overlayVisible || (frameCounter < 1)) return;
+
+    const int posX = 10;
+    const int posY = 10;
+    const int width = PROFILE_GRAPH_FRAMES + 20;
+    const int graphHeight = 80;
+    const float graphMaxTime = 50.0f;      // Graph vertical scale (ms)
+
+    // Frame time percentiles over graph frames
+    float sorted[PROFILE_GRAPH_FRAMES] = { 0 };
+    int count = 0;
+    for (long long i = frameCounter; (i > 0) && (i > frameCounter - PROFILE_GRAPH_FRAMES) && (i > frameCounter - MAX_PROFILE_FRAMES); i--) sorted[count++] = frames[i%MAX_PROFILE_FRAMES].frameTime;
+    qsort(sorted, count, sizeof(float), CompareFloat);
+
+    // Phase averages, GPU time averaged over measured frames only
+    float cpuAverage[PROFILE_PHASE_COUNT] = { 0 };
+    float gpuAverage[PROFILE_PHASE_COUNT] = { 0 };
+    int gpuCount[PROFILE_PHASE_COUNT] = { 0 };
+    int averageCount = 0;
+    for (long long i = frameCounter - 1; (i >= 0) && (i > frameCounter - PROFILE_AVERAGE_FRAMES); i--, averageCount++)
+    {
+        const ProfileFrame *frame = &frames[i%MAX_PROFILE_FRAMES];
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++)
+        {
+            cpuAverage[p] += frame->cpuTime[p];
+            if (frame->gpuTime[p] >= 0.0f) { gpuAverage[p] += frame->gpuTime[p]; gpuCount[p]++; }
+        }
+    }
+
+    const int height = 40 + PROFILE_PHASE_COUNT*14 + graphHeight + 10;
+    DrawRectangle(posX, posY, width, height, Fade(BLACK, 0.75f));
+
+    DrawText(TextFormat("FRAME %.2f ms  p50 %.2f  p99 %.2f", frames[(frameCounter - 1)%MAX_PROFILE_FRAMES].frameTime,
+        sorted[count/2], sorted[(count*99)/100]), posX + 10, posY + 8, 10, RAYWHITE);
+    DrawText(TextFormat("%-10s %8s %8s", "PHASE", "CPU ms", "GPU ms"), posX + 10, posY + 24, 10, GRAY);
+
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++)
+    {
+        const char *gpuText = (gpuCount[p] > 0)? TextFormat("%.3f", gpuAverage[p]/gpuCount[p]) : "n/a";
+        DrawText(TextFormat("%-10s %8.3f %8s", phaseNames[p], (averageCount > 0)? cpuAverage[p]/averageCount : 0.0f, gpuText),
+            posX + 10, posY + 38 + p*14, 10, phaseColors[p]);
+    }
+
+    // Rolling frame time graph, most recent frame on the right, work time stacked by phase
+    const int graphX = posX + 10;
+    const int graphY = posY + 40 + PROFILE_PHASE_COUNT*14 + graphHeight;
+    const int targetY = graphY - (int)(graphHeight*(1000.0f/60.0f)/graphMaxTime);
+
+    for (int x = 0; x < PROFILE_GRAPH_FRAMES; x++)
+    {
+        const long long i = frameCounter - PROFILE_GRAPH_FRAMES + x;
+        if ((i < 1) || (i <= frameCounter - MAX_PROFILE_FRAMES)) continue;
+
+        const ProfileFrame *frame = &frames[i%MAX_PROFILE_FRAMES];
+        int barHeight = (int)(graphHeight*frame->frameTime/graphMaxTime);
+        if (barHeight > graphHeight) barHeight = graphHeight;
+        DrawLine(graphX + x, graphY, graphX + x, graphY - barHeight, Fade(RAYWHITE, 0.35f));
+
+        float stacked = 0.0f;
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++)
+        {
+            const int bottom = graphY - (int)(graphHeight*stacked/graphMaxTime);
+            stacked += frame->cpuTime[p];
+            const int top = graphY - (int)(graphHeight*((stacked < graphMaxTime)? stacked : graphMaxTime)/graphMaxTime);
+            if (top < bottom) DrawLine(graphX + x, bottom, graphX + x, top, phaseColors[p]);
+        }
+    }
+
+    DrawLine(graphX, targetY, graphX + PROFILE_GRAPH_FRAMES, targetY, Fade(RED, 0.75f));
+}
+
+// Export recorded frames to CSV file
+bool ExportProfilerData(const char *fileName)
+{
+    FILE *file = fopen(fileName, "wt");
+    if (file == NULL) return false;
+
+    fprintf(file, "frame,section,drawn,frame_ms,work_ms");
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) fprintf(file, ",%s_cpu_ms", phaseNames[p]);
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) fprintf(file, ",%s_gpu_ms", phaseNames[p]);
+    fprintf(file, "\n");
+
+    // NOTE: Last frame is skipped, it's still being recorded
+    long long first = frameCounter - MAX_PROFILE_FRAMES + 1;
+    if (first < 1) first = 1;
+
+    for (long long i = first; i < frameCounter; i++)
+    {
+        const ProfileFrame *frame = &frames[i%MAX_PROFILE_FRAMES];
+
+        fprintf(file, "%lld,%s,%i,%.3f,%.3f", i, (frame->section >= 0)? sections[frame->section].name : "", frame->drawn, frame->frameTime, frame->workTime);
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) fprintf(file, ",%.3f", frame->cpuTime[p]);
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++)
+        {
+            if (frame->gpuTime[p] >= 0.0f) fprintf(file, ",%.3f", frame->gpuTime[p]);
+            else fprintf(file, ",");
+        }
+        fprintf(file, "\n");
+    }
+
+    fclose(file);
+
+    TraceLog(LOG_INFO, "PROFILER: Frame timings exported to %s", fileName);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Compare floats, used for sorting
+static int CompareFloat(const void *a, const void *b)
+{
+    const float fa = *(const float *)a;
+    const float fb = *(const float *)b;
+
+    return (fa > fb) - (fa < fb);
+}
+
+// Account finished frame to its section
+static void AccountProfileFrame(long long index, double elapsedTime)
+{
+    const ProfileFrame *frame = &frames[index%MAX_PROFILE_FRAMES];
+    if (frame->drawn) lastDrawnFrame = index;
+    if (frame->section < 0) return;
+
+    ProfileSection *section = &sections[frame->section];
+    section->frameCount++;
+    if (frame->drawn) section->drawnCount++;
+    section->elapsedTime += elapsedTime;
+    section->cpuTime += frame->workTime/1000.0;
+}
+
+#if defined(PROFILER_GPU_TIMING)
+// Load GL timer query functions and query objects
+static void LoadGpuQueries(void)
+{
+    glGenQueriesProc = (GenQueriesProc)glfwGetProcAddress("glGenQueries");
+    glDeleteQueriesProc = (DeleteQueriesProc)glfwGetProcAddress("glDeleteQueries");
+    glBeginQueryProc = (BeginQueryProc)glfwGetProcAddress("glBeginQuery");
+    glEndQueryProc = (EndQueryProc)glfwGetProcAddress("glEndQuery");
+    glGetQueryObjectivProc = (GetQueryObjectivProc)glfwGetProcAddress("glGetQueryObjectiv");
+    glGetQueryObjectui64vProc = (GetQueryObjectui64vProc)glfwGetProcAddress("glGetQueryObjectui64v");
+
+    gpuTimingSupported = (glGenQueriesProc != NULL) && (glDeleteQueriesProc != NULL) && (glBeginQueryProc != NULL) &&
+        (glEndQueryProc != NULL) && (glGetQueryObjectivProc != NULL) && (glGetQueryObjectui64vProc != NULL);
+
+    if (gpuTimingSupported)
+    {
+        glGenQueriesProc(PROFILE_GPU_LATENCY*PROFILE_PHASE_COUNT, &queries[0][0]);
+        for (int i = 0; i < PROFILE_GPU_LATENCY; i++) queryFrame[i] = -1;
+    }
+    else TraceLog(LOG_WARNING, "PROFILER: GL timer queries not supported, GPU timings not available");
+}
+
+// Read back query results of slot into its frame
+// NOTE: Results not available after PROFILE_GPU_LATENCY frames are dropped, never stalls waiting for them
+static void ResolveGpuQueries(int slot)
+{
+    const long long frameIndex = queryFrame[slot];
+    if (frameIndex < 0) return;
+
+    queryFrame[slot] = -1;
+
+    ProfileFrame *frame = &frames[frameIndex%MAX_PROFILE_FRAMES];
+    bool resolved = true;
+    double gpuTime = 0.0;
+
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++)
+    {
+        if (!queryIssued[slot][p]) continue;
+        queryIssued[slot][p] = false;
+
+        int available = 0;
+        glGetQueryObjectivProc(queries[slot][p], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available)
+        {
+            unsigned long long elapsed = 0;
+            glGetQueryObjectui64vProc(queries[slot][p], GL_QUERY_RESULT, &elapsed);
+            frame->gpuTime[p] = (float)(elapsed/1000000.0);
+            gpuTime += elapsed/1000000000.0;
+        }
+        else resolved = false;
+    }
+
+    if (resolved && frame->drawn) lastGpuDrawnFrame = frameIndex;
+
+    // NOTE: Frame elapsed time is the next frame time, only frames with all results read back are accounted
+    if (resolved && (frame->section >= 0))
+    {
+        sections[frame->section].gpuTime += gpuTime;
+        sections[frame->section].gpuElapsedTime += frames[(frameIndex + 1)%MAX_PROFILE_FRAMES].frameTime/1000.0;
+    }
+}
+#endif
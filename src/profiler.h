@@ -0,0 +1,81 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Frame profiler
+*
+*   Ring-buffer recorder of per-frame phase timings (update, screen draw, transition, swap),
+*   CPU time always recorded, GPU time measured with GL timer queries while the overlay is
+*   visible (OpenGL 3.3+ desktop only). Overlay shows per-phase averages and a rolling
+*   frame-time graph with p50/p99. Recorded frames can be exported to CSV.
+*
+*   Frames are accounted to sections (i.e. current screen), CPU/GPU duty cycles (busy time
+*   over elapsed time) and drawn frames ratio are accumulated per section for the session.
+*
+*   NOTE: GPU timing flushes the render batch at every scope boundary, so GPU work is
+*   attributed to the phase that issued it. Results are read back a few frames later.
+*
+**********************************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_PROFILE_FRAMES      3600        // Recorded frames (one minute at 60 fps)
+#define MAX_PROFILE_SECTIONS    8           // Sections frames are accounted to
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Profiled frame phases, every phase is scoped once per frame
+typedef enum ProfilePhase {
+    PROFILE_PHASE_UPDATE = 0,   // Screen and transition update
+    PROFILE_PHASE_DRAW,         // Screen Draw*() function
+    PROFILE_PHASE_TRANSITION,   // Transition draw
+    PROFILE_PHASE_SWAP,         // EndDrawing(), render batch flush and buffers swap
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+// Profiled frame timings (milliseconds)
+typedef struct ProfileFrame {
+    float frameTime;                        // Time since previous frame start
+    float workTime;                         // Time from frame start to frame end, excludes waiting for next frame
+    float cpuTime[PROFILE_PHASE_COUNT];
+    float gpuTime[PROFILE_PHASE_COUNT];     // Negative if not measured
+    int section;                            // Section frame is accounted to, -1 if none
+    bool drawn;                             // Frame has been drawn, not skipped
+} ProfileFrame;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Profiler Functions Declaration
+//----------------------------------------------------------------------------------
+void InitProfiler(void);                                // Initialize profiler
+void CloseProfiler(void);                               // Close profiler, unloads GPU queries
+void BeginProfileFrame(void);                           // Begin frame recording (call at frame start)
+void EndProfileFrame(void);                             // End frame recording
+void BeginProfileScope(ProfilePhase phase);             // Begin timing frame phase
+void EndProfileScope(ProfilePhase phase);               // End timing frame phase
+
+void SetProfileSection(const char *name);               // Set section current and next frames are accounted to (name must stay valid)
+
+void ToggleProfilerOverlay(void);                       // Toggle overlay visibility and GPU timing
+bool IsProfilerOverlayVisible(void);                    // Check if overlay is visible
+bool IsProfilerUsed(void);                              // Check if overlay has been shown during the session
+void SetProfilerGpuTiming(bool enabled);                // Enable GPU timing with overlay hidden, to measure GPU duty cycles
+long long GetProfilerLastDrawnFrame(ProfileFrame *frame); // Get latest drawn frame timings, returns frame index (-1 if none)
+void LogProfilerDutyCycles(void);                       // Log per-section CPU/GPU duty cycles and drawn frames ratio
+void DrawProfilerOverlay(void);                         // Draw overlay, if visible
+bool ExportProfilerData(const char *fileName);          // Export recorded frames to CSV file
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILER_H
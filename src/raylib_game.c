@@ -14,103 +14,302 @@
 
 #include "raylib.h"
 #include "screens.h"    // NOTE: Declares global (extern) variables and screens functions
+#include "input.h"      // NOTE: Timestamped trigger edges and high frequency input sampling
+#include "profiler.h"   // NOTE: Frame phases timings, overlay toggled with F3
+#include "threads.h"    // NOTE: Next screen assets are preloaded on a background thread
+#include "asset_pack.h" // NOTE: Resources are packed into a single archive at build time
+#include "tween.h"      // NOTE: Transitions are time-based, same duration at any frame rate
+#include "stats_store.h" // NOTE: Round results and high scores, written by a background thread
+
+#include <stddef.h>     // Required for: NULL
+#include <stdlib.h>     // Required for: atoi(), atof()
+
+#if defined(BENCHMARK_MODE)
+    #include "benchmark.h"
+#endif
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
 #endif
 
+#if defined(HOT_RELOAD)
+    #include "hot_reload.h"
+#endif
+
 //----------------------------------------------------------------------------------
 // Shared Variables Definition (global)
 // NOTE: Those variables are shared between modules through screens.h
 //----------------------------------------------------------------------------------
-GameScreen currentScreen = LOGO;
+GameScreen currentScreen = UNKNOWN;
 Font font = { 0 };
 Music music = { 0 };
-Sound fxCoin = { 0 };
-Sound fxError = { 0 };
+MixerSound fxCoin = { 0 };
+MixerSound fxError = { 0 };
+float startupProgress = 0.0f;
+float frameDeltaTime = 0.0f;
+int rounds = 0;
 
 //----------------------------------------------------------------------------------
 // Local Variables Definition (local to this module)
 //----------------------------------------------------------------------------------
 static const int screenWidth = 1280;
 static const int screenHeight = 720;
+static int targetFPS = 0;                       // Frame rate limit, 0 for uncapped or synced to display refresh rate (VSync, default)
+static const float assetUploadBudget = 0.004f;  // Time per frame spent uploading startup assets (seconds)
+
+// Frames are only drawn when something visible changed, update and input sampling keep running
+static bool idleRendering = true;
+static const int idleFPS = 60;                  // Update rate while frames are not drawn, if frame rate is not limited
+static const float vsyncPollShare = 0.5f;       // Share of the refresh interval spent polling the held trigger with VSync
+static const double idleRedrawInterval = 1.0;   // Maximum time between drawn frames (seconds), restores damaged window contents
+static bool frameDrawn = false;                 // Last frame has been drawn
+static double lastDrawTime = 0.0;
+static double lastUpdateTime = -1.0;
+
+// Assets references held for the whole application lifetime
+static AssetHandle fontAsset = ASSET_INVALID;
+static AssetHandle fxCoinAsset = ASSET_INVALID;
+static AssetHandle fxErrorAsset = ASSET_INVALID;
+static AssetHandle pumpModelAsset = ASSET_INVALID;
+static AssetHandle musicAsset = ASSET_INVALID;
+
+// Startup assets are loaded asynchronously while logo screen runs
+static bool startupLoading = false;
+static bool startupRequested = false;       // Startup assets requested, on web once the assets archive has been fetched
+static float packFetchProgress = -1.0f;     // Assets archive download progress, negative if not fetched
+static bool firstFramePresented = false;
 
 // Required variables to manage screen transitions (fade-in, fade-out)
 static float transAlpha = 0.0f;
+static Tween transTween = { 0 };
+static const float transFadeInTime = 20.0f/60.0f;   // Seconds, matches original 0.05 alpha per frame at 60 fps
+static const float transFadeOutTime = 50.0f/60.0f;  // Seconds, matches original 0.02 alpha per frame at 60 fps
 static bool onTransition = false;
 static bool transFadeOut = false;
 static int transFromScreen = -1;
 static GameScreen transToScreen = UNKNOWN;
 
+static bool scriptedScreens = false;        // Screen changes driven by benchmark script, finished screens are ignored
+
+// Screens registered by GameScreen, from screens module
+static const ScreensModule *screensModule = NULL;
+static const ScreenFunctions *screens = NULL;
+
+#if defined(HOT_RELOAD)
+// Screens library, reloaded when rebuilt while the game runs
+static HotModule screensLibrary = { 0 };
+static void *screensData = NULL;            // Screens data (gameplay state), kept across reloads
+#endif
+
+static Thread *preloadThread = NULL;        // Preloading transition target screen assets
+
 //----------------------------------------------------------------------------------
 // Local Functions Declaration
 //----------------------------------------------------------------------------------
+static bool LoadScreens(void);              // Load screens module (screens library on hot reload builds)
+static void UnloadScreens(void);            // Unload screens module
+#if defined(HOT_RELOAD)
+static void UpdateScreensReload(void);      // Reload screens module once its library is rebuilt
+#endif
+
 static void ChangeToScreen(int screen);     // Change to screen, no transition effect
+static void StartScreenPreload(int screen); // Start preloading screen assets on background thread
+static void WaitScreenPreload(void);        // Wait for screen preload to finish
+static void PreloadScreenThread(void *userData);    // Screen preload thread function
 
 static void TransitionToScreen(int screen); // Request transition to next screen
 static void UpdateTransition(void);         // Update transition effect
 static void DrawTransition(void);           // Draw transition effect (full-screen rectangle)
 
 static void UpdateDrawFrame(void);          // Update and draw one frame
+static bool IsFrameDirty(void);             // Check if frame view changed since last drawn frame
+
+static void RequestStartupAssets(void);     // Request global assets, loaded asynchronously
+static void UpdateStartupLoading(void);     // Update startup assets loading and its progress
+static void FinishStartupLoading(void);     // Set global assets once startup loading is done
+static double GetStartupTime(void);         // Get time since startup (seconds), used to measure time-to-first-frame
+
+#if defined(PLATFORM_WEB)
+static void OnAssetPackFetched(unsigned handle, void *userData, void *data, unsigned dataSize);         // Assets archive fetched
+static void OnAssetPackFetchFailed(unsigned handle, void *userData, int httpCode, const char *status); // Assets archive fetch failed
+static void OnAssetPackFetchProgress(unsigned handle, void *userData, int loaded, int total);         // Assets archive fetch progress
+#endif
+
+#if defined(BENCHMARK_MODE)
+static void RunBenchmark(int frames, const char *outputFileName);   // Run scripted benchmark stages
+static void RunBenchmarkLoading(const char *name);                  // Run frames until startup loading is done
+static void RunBenchmarkScreen(const char *name, int frames);       // Run current screen for frames with scripted input
+static void RunBenchmarkTransition(const char *name, int screen);   // Run transition to screen until it ends
+#endif
 
 //----------------------------------------------------------------------------------
 // Main entry point
 //----------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char *argv[])
 {
     TraceLog(LOG_DEBUG, "Application directory: %s", GetApplicationDirectory());
 
     // Initialization
     //---------------------------------------------------------
-    SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT | FLAG_MSAA_4X_HINT);  // Set window configuration state using flags
+#if defined(BENCHMARK_MODE)
+    // NOTE: Hidden window, no VSync and no frame rate limit, frames run as fast as possible
+    SetConfigFlags(FLAG_WINDOW_HIDDEN | FLAG_MSAA_4X_HINT);
+#else
+    // NOTE: VSync by default, "--fps N" disables it and limits frame rate to N (0 for uncapped), the input sampler paces
+    // frames and the time between them is used to poll the held trigger. "--fps vsync" keeps VSync, animations are time-based.
+    // "--always-draw" draws every frame, "--profile-gpu" measures GPU duty cycles with profiler overlay hidden.
+    // "--resolution-budget ms" sets the GPU frame time gameplay 3D resolution is scaled to (0 keeps native resolution,
+    // 80% of the frame time by default), "--no-post-aa" keeps scaled frames without anti-aliasing
+    unsigned int windowFlags = FLAG_WINDOW_RESIZABLE | FLAG_MSAA_4X_HINT | FLAG_VSYNC_HINT;
+    bool profileGpu = false;
+    float resolutionBudget = -1.0f;
+    bool resolutionPostAA = true;
+    for (int i = 1; i < argc; i++)
+    {
+        if (TextIsEqual(argv[i], "--always-draw")) idleRendering = false;
+        else if (TextIsEqual(argv[i], "--profile-gpu")) profileGpu = true;
+        else if (TextIsEqual(argv[i], "--fps") && (i + 1 < argc))
+        {
+            if (!TextIsEqual(argv[i + 1], "vsync")) windowFlags &= ~FLAG_VSYNC_HINT;
+            targetFPS = TextIsEqual(argv[i + 1], "vsync")? 0 : atoi(argv[i + 1]);
+        }
+        else if (TextIsEqual(argv[i], "--resolution-budget") && (i + 1 < argc)) resolutionBudget = (float)atof(argv[i + 1]);
+        else if (TextIsEqual(argv[i], "--no-post-aa")) resolutionPostAA = false;
+    }
+
+    if (resolutionBudget < 0.0f) resolutionBudget = 0.8f*1000.0f/((targetFPS > 0)? targetFPS : 60);
+
+    SetConfigFlags(windowFlags);  // Set window configuration state using flags
+#endif
     InitWindow(screenWidth, screenHeight, "Stop the Pump!");
+    InitInputSampler();
+    InitProfiler();
+
+    if (!LoadScreens())
+    {
+        CloseWindow();
+        return 1;
+    }
+
+#if defined(BENCHMARK_MODE)
+    idleRendering = false;      // NOTE: Benchmark measures drawing, every frame is drawn
+#else
+    // NOTE: Dynamic resolution needs GPU frame time, measured by profiler GPU timing (where supported)
+    screensModule->SetGameplayResolutionBudget(resolutionBudget, resolutionPostAA);
+    if (profileGpu || (resolutionBudget > 0.0f)) SetProfilerGpuTiming(true);
+#endif
 
     InitAudioDevice();      // Initialize audio device
+    InitAudioMixer();       // NOTE: Sound effects are mixed from a voices pool, music streamed on its own thread
+#if !defined(BENCHMARK_MODE)
+    InitStatsStore();       // NOTE: Benchmark sessions are not recorded
+#endif
 
-    // Load global data (assets that must be available in all screens, i.e. font)
-    font = LoadFont("resources/mecha.png");
-    music = LoadMusicStream("resources/ambient.ogg"); // TODO: Load music
-    fxCoin = LoadSound("resources/coin.wav");
-    fxError = LoadSound("resources/error.ogg");
+    // Open assets archive and request global data (assets that must be available in all screens, i.e. font)
+    // NOTE: Resources are loaded from loose files if the archive is not available (i.e. running from src)
+    startupLoading = true;
+#if defined(PLATFORM_WEB)
+    // NOTE: Archive is fetched in a single request while logo screen runs, startup assets are requested on arrival
+    packFetchProgress = 0.0f;
+    emscripten_async_wget2_data("resources.pak", "GET", NULL, NULL, 0, OnAssetPackFetched, OnAssetPackFetchFailed, OnAssetPackFetchProgress);
+#else
+    if (OpenAssetPack("resources.pak")) TraceLog(LOG_INFO, "ASSETS: Assets archive opened: resources.pak");
+    else TraceLog(LOG_INFO, "ASSETS: Assets archive not available, loading loose files");
 
-    SetMusicVolume(music, 1.0f);
-    PlayMusicStream(music);
+    RequestStartupAssets();
+#endif
 
     // Setup and init first screen
-    currentScreen = LOGO;
-    InitLogoScreen();
+    // NOTE: A session replay passed as "--replay <file>" is played back directly, so startup assets are waited for,
+    // same for the forecourt stress mode, "--forecourt <pumps>"
+    GameScreen firstScreen = LOGO;
+#if !defined(BENCHMARK_MODE)
+    for (int i = 1; i < argc - 1; i++)
+    {
+        if (TextIsEqual(argv[i], "--replay") && screensModule->SetGameplayReplay(argv[i + 1])) firstScreen = GAMEPLAY;
+        else if (TextIsEqual(argv[i], "--forecourt"))
+        {
+            screensModule->SetForecourtPumpCount(atoi(argv[i + 1]));
+            firstScreen = FORECOURT;
+        }
+    }
+#endif
+    if (firstScreen != LOGO)
+    {
+        WaitAssetLoading();
+        FinishStartupLoading();
+    }
 
-#if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
+    ChangeToScreen(firstScreen);
+
+#if defined(BENCHMARK_MODE)
+    // USAGE: StopThePumpBench [--frames N] [--output results.json]
+    int benchmarkFrames = 600;
+    const char *benchmarkOutput = NULL;
+    for (int i = 1; i < argc - 1; i++)
+    {
+        if (TextIsEqual(argv[i], "--frames")) benchmarkFrames = atoi(argv[i + 1]);
+        else if (TextIsEqual(argv[i], "--output")) benchmarkOutput = argv[i + 1];
+    }
+
+    RunBenchmark(benchmarkFrames, benchmarkOutput);
+#elif defined(PLATFORM_WEB)
+    // NOTE: Main loop runs on requestAnimationFrame, at display refresh rate
+    emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
 #else
-    SetTargetFPS(60);       // Set our game to run at 60 frames-per-second
+    // NOTE: Instead of SetTargetFPS(), time left until next frame is spent sampling input (VSync paces drawn frames)
     //--------------------------------------------------------------------------------------
 
     // Main game loop
     while (!WindowShouldClose())    // Detect window close button or ESC key
     {
+        const double frameStartTime = GetTime();
+
         UpdateDrawFrame();
+
+        // NOTE: Frames not drawn don't wait for VSync, so if frame rate is not limited updates are paced to idleFPS.
+        // With VSync the held trigger is polled for half of the refresh interval after the swap, the other half is left
+        // for next frame update and draw
+        double frameEndTime = 0.0;
+        if (targetFPS > 0) frameEndTime = frameStartTime + 1.0/targetFPS;
+        else if (!frameDrawn) frameEndTime = frameStartTime + 1.0/idleFPS;
+        else if (IsTriggerDown() && IsWindowState(FLAG_VSYNC_HINT)) frameEndTime = GetTime() + vsyncPollShare*GetFrameTime();
+
+        WaitInputSampling(frameEndTime);
     }
 #endif
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
     // Unload current screen data before closing
-    switch (currentScreen)
-    {
-        case LOGO: UnloadLogoScreen(); break;
-        case GAMEPLAY: UnloadGameplayScreen(); break;
-        case ENDING: UnloadEndingScreen(); break;
-        default: break;
-    }
+    WaitScreenPreload();
+    screens[currentScreen].Unload();
+    UnloadScreens();
+
+    CloseAudioMixer();      // NOTE: Music streaming is stopped before music is unloaded
+    CloseStatsStore();      // NOTE: Waits for the writer, current session was recorded by screen unload
 
     // Unload global data loaded
-    UnloadFont(font);
-    UnloadMusicStream(music);
-    UnloadSound(fxCoin);
+    ReleaseAsset(pumpModelAsset);
+    ReleaseAsset(fxErrorAsset);
+    ReleaseAsset(fxCoinAsset);
+    ReleaseAsset(fontAsset);
+    ReleaseAsset(musicAsset);
+
+    UnloadAssets();         // Unload any asset still referenced
+    CloseAssetPack();       // NOTE: Archive is closed after assets, music streams read from it
 
     CloseAudioDevice();     // Close audio context
 
+    CloseInputSampler();
+
+#if !defined(PLATFORM_WEB)
+    // NOTE: Frame timings are only exported if the profiler overlay was used, to be attached to bug reports
+    if (IsProfilerUsed()) ExportProfilerData("profile.csv");
+#endif
+    LogProfilerDutyCycles();
+    CloseProfiler();
+
     CloseWindow();          // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
 
@@ -120,30 +319,139 @@ int main(void)
 //----------------------------------------------------------------------------------
 // Module specific Functions Definition
 //----------------------------------------------------------------------------------
-// Change to next screen, no transition
-static void ChangeToScreen(int screen)
+// Load screens module
+// NOTE: On hot reload builds screens are loaded from their library and the host allocates
+// the screens data, set before any screen function is called
+static bool LoadScreens(void)
 {
-    // Unload current screen
-    switch (currentScreen)
+#if defined(HOT_RELOAD)
+    screensLibrary = LoadHotModule(TextFormat("%s%s", GetApplicationDirectory(), SCREENS_MODULE_FILE));
+    GetScreensModuleFunc getScreensModule = (GetScreensModuleFunc)GetHotModuleSymbol(screensLibrary, "GetScreensModule");
+    screensModule = (getScreensModule != NULL)? getScreensModule() : NULL;
+
+    if ((screensModule == NULL) || (screensModule->version != SCREENS_MODULE_VERSION))
     {
-        case LOGO: UnloadLogoScreen(); break;
-        case GAMEPLAY: UnloadGameplayScreen(); break;
-        case ENDING: UnloadEndingScreen(); break;
-        default: break;
+        TraceLog(LOG_ERROR, "HOTRELOAD: Screens library not available or incompatible: %s", screensLibrary.fileName);
+        UnloadHotModule(&screensLibrary);
+        return false;
     }
 
-    // Init next screen
-    switch (screen)
+    screensData = MemAlloc(screensModule->dataSize);
+    screensModule->SetData(screensData);
+    screensModule->InitData();      // NOTE: Reloaded modules keep current data
+
+    TraceLog(LOG_INFO, "HOTRELOAD: Screens library loaded, watching %s", screensLibrary.fileName);
+#else
+    screensModule = GetScreensModule();
+#endif
+    screens = screensModule->screens;
+
+    return true;
+}
+
+// Unload screens module
+static void UnloadScreens(void)
+{
+#if defined(HOT_RELOAD)
+    UnloadHotModule(&screensLibrary);
+    MemFree(screensData);
+    screensData = NULL;
+#endif
+    screens = NULL;
+    screensModule = NULL;
+}
+
+#if defined(HOT_RELOAD)
+// Reload screens module once its library is rebuilt, checked between transitions
+// NOTE: Gameplay continues where it was, its state is kept in screens data; other screens restart.
+// A library with a different gameplay data layout is not loaded, the game must be restarted
+static void UpdateScreensReload(void)
+{
+    if (!IsHotModuleChanged(&screensLibrary)) return;
+
+    const double reloadStartTime = GetTime();
+
+    HotModule library = LoadHotModule(screensLibrary.fileName);
+    GetScreensModuleFunc getScreensModule = (GetScreensModuleFunc)GetHotModuleSymbol(library, "GetScreensModule");
+    const ScreensModule *module = (getScreensModule != NULL)? getScreensModule() : NULL;
+
+    if (module == NULL)
+    {
+        TraceLog(LOG_WARNING, "HOTRELOAD: Rebuilt screens library could not be loaded, previous one kept");
+        UnloadHotModule(&library);
+        return;
+    }
+
+    if ((module->version != SCREENS_MODULE_VERSION) || (module->dataVersion != screensModule->dataVersion) || (module->dataSize != screensModule->dataSize))
     {
-        case LOGO: InitLogoScreen(); break;
-        case GAMEPLAY: InitGameplayScreen(); break;
-        case ENDING: InitEndingScreen(); break;
-        default: break;
+        TraceLog(LOG_WARNING, "HOTRELOAD: Screens interface or gameplay data layout changed (%i bytes, version %i), restart required",
+            module->dataSize, module->dataVersion);
+        UnloadHotModule(&library);
+        return;
     }
 
+    // NOTE: No code of the previous library may run once it is unloaded, screens preload included
+    WaitScreenPreload();
+
+    const bool restartScreen = !screens[currentScreen].hostData;
+    if (restartScreen) screens[currentScreen].Unload();
+
+    module->SetData(screensData);
+    UnloadHotModule(&screensLibrary);
+    screensLibrary = library;
+    screensModule = module;
+    screens = module->screens;
+
+    if (restartScreen)
+    {
+        if (screens[currentScreen].Preload != NULL) screens[currentScreen].Preload();
+        screens[currentScreen].Init();
+    }
+
+    TraceLog(LOG_INFO, "HOTRELOAD: Screens library reloaded in %.1f ms (%s %s)", (GetTime() - reloadStartTime)*1000.0,
+        screens[currentScreen].name, restartScreen? "screen restarted" : "state kept");
+}
+#endif
+
+// Change to next screen, no transition
+static void ChangeToScreen(int screen)
+{
+    // Unload current screen
+    if (currentScreen != UNKNOWN) screens[currentScreen].Unload();
+
+    // Init next screen, assets preloaded synchronously
+    if (screens[screen].Preload != NULL) screens[screen].Preload();
+    screens[screen].Init();
+
     currentScreen = screen;
 }
 
+// Start preloading screen assets on background thread
+// NOTE: If threads are not available (i.e. web without pthreads), preload runs synchronously
+static void StartScreenPreload(int screen)
+{
+    WaitScreenPreload();
+
+    if (screens[screen].Preload == NULL) return;
+
+    preloadThread = StartThread(PreloadScreenThread, (void *)&screens[screen]);
+    if (preloadThread == NULL) screens[screen].Preload();
+}
+
+// Wait for screen preload to finish
+static void WaitScreenPreload(void)
+{
+    if (preloadThread != NULL) JoinThread(preloadThread);
+    preloadThread = NULL;
+}
+
+// Screen preload thread function
+static void PreloadScreenThread(void *userData)
+{
+    const ScreenFunctions *screen = (const ScreenFunctions *)userData;
+    screen->Preload();
+}
+
 // Request transition to next screen
 static void TransitionToScreen(int screen)
 {
@@ -151,51 +459,41 @@ static void TransitionToScreen(int screen)
     transFadeOut = false;
     transFromScreen = currentScreen;
     transToScreen = screen;
+    transTween = CreateTween(0.0f, 1.0f, transFadeInTime, TWEEN_LINEAR);
     transAlpha = 0.0f;
+
+    // NOTE: Incoming screen assets load while fade-in runs, so the swap at full black only uploads them
+    StartScreenPreload(screen);
 }
 
 // Update transition effect (fade-in, fade-out)
+// NOTE: Fades are driven by elapsed time, screens swap once fade-in tween has finished
 static void UpdateTransition(void)
 {
+    UpdateTween(&transTween, frameDeltaTime);
+    transAlpha = GetTweenValue(transTween);
+
     if (!transFadeOut)
     {
-        transAlpha += 0.05f;
-
-        // NOTE: Due to float internal representation, condition jumps on 1.0f instead of 1.05f
-        // For that reason we compare against 1.01f, to avoid last frame loading stop
-        if (transAlpha > 1.01f)
+        if (IsTweenFinished(transTween))
         {
-            transAlpha = 1.0f;
-
             // Unload current screen
-            switch (transFromScreen)
-            {
-                case LOGO: UnloadLogoScreen(); break;
-                case GAMEPLAY: UnloadGameplayScreen(); break;
-                case ENDING: UnloadEndingScreen(); break;
-                default: break;
-            }
-
-            // Load next screen
-            switch (transToScreen)
-            {
-                case LOGO: InitLogoScreen(); break;
-                case GAMEPLAY: InitGameplayScreen(); break;
-                case ENDING: InitEndingScreen(); break;
-                default: break;
-            }
+            screens[transFromScreen].Unload();
+
+            // Load next screen, waits for its preload in the unlikely case fade-in was faster
+            WaitScreenPreload();
+            screens[transToScreen].Init();
 
             currentScreen = transToScreen;
 
             // Activate fade out effect to next loaded screen
             transFadeOut = true;
+            transTween = CreateTween(1.0f, 0.0f, transFadeOutTime, TWEEN_LINEAR);
         }
     }
     else  // Transition fade out logic
     {
-        transAlpha -= 0.02f;
-
-        if (transAlpha < -0.01f)
+        if (IsTweenFinished(transTween))
         {
             transAlpha = 0.0f;
             transFadeOut = false;
@@ -217,59 +515,268 @@ static void UpdateDrawFrame(void)
 {
     // Update
     //----------------------------------------------------------------------------------
-    //UpdateMusicStream(music);       // NOTE: Music keeps playing between screens
+    UpdateAudioMixer();     // NOTE: Music keeps playing between screens, only streamed here without streaming thread
+    UpdateStatsStore();     // NOTE: Only writes records here without writer thread (web)
+#if defined(HOT_RELOAD)
+    if (!onTransition) UpdateScreensReload();
+#endif
 
-    if (!onTransition)
-    {
-        switch(currentScreen)
-        {
-            case LOGO:
-            {
-                UpdateLogoScreen();
+    BeginProfileFrame();
 
-                if (FinishLogoScreen()) TransitionToScreen(GAMEPLAY);
+    // NOTE: Delta time measured here, GetFrameTime() is only updated by EndDrawing(), on drawn frames
+    const double updateTime = GetTime();
+    frameDeltaTime = (lastUpdateTime >= 0.0)? (float)(updateTime - lastUpdateTime) : 0.0f;
+    lastUpdateTime = updateTime;
 
-            } break;
-            case GAMEPLAY:
-            {
-                UpdateGameplayScreen();
+    SampleInputEvents();    // NOTE: Input sampled after last events poll, trigger edges may be already recorded
 
-                if (FinishGameplayScreen() == 1) TransitionToScreen(ENDING);
-                //else if (FinishGameplayScreen() == 2) TransitionToScreen(TITLE);
+    if (IsDebugTogglePressed()) ToggleProfilerOverlay();
 
-            } break;
-            case ENDING:
-            {
-                UpdateEndingScreen();
+    BeginProfileScope(PROFILE_PHASE_UPDATE);
 
-                if (FinishEndingScreen() == 1) TransitionToScreen(GAMEPLAY);
+    if (startupLoading) UpdateStartupLoading();
 
-            } break;
-            default: break;
-        }
+    if (!onTransition)
+    {
+        screens[currentScreen].Update();
+
+        if ((screens[currentScreen].Finish() == 1) && !scriptedScreens) TransitionToScreen(screens[currentScreen].nextScreen);
     }
     else UpdateTransition();    // Update transition (fade-in, fade-out)
+
+    EndProfileScope(PROFILE_PHASE_UPDATE);
+
+    SetProfileSection(screens[currentScreen].name);
     //----------------------------------------------------------------------------------
 
     // Draw
+    // NOTE: Frame is skipped if nothing visible changed, previous one stays on screen and input
+    // events are polled here instead of EndDrawing(), no buffers swap and no GPU work
     //----------------------------------------------------------------------------------
+    frameDrawn = !idleRendering || IsFrameDirty();
+
+    if (!frameDrawn)
+    {
+        PollInputEvents();
+        ResetInputLatches();
+        EndProfileFrame();
+        return;
+    }
+
+    lastDrawTime = updateTime;
+
     BeginDrawing();
 
         ClearBackground(RAYWHITE);
 
-        switch(currentScreen)
-        {
-            case LOGO: DrawLogoScreen(); break;
-            case GAMEPLAY: DrawGameplayScreen(); break;
-            case ENDING: DrawEndingScreen(); break;
-            default: break;
-        }
+        BeginProfileScope(PROFILE_PHASE_DRAW);
+
+        screens[currentScreen].Draw();
+
+        EndProfileScope(PROFILE_PHASE_DRAW);
 
         // Draw full screen rectangle in front of everything
-        if (onTransition) DrawTransition();
+        if (onTransition)
+        {
+            BeginProfileScope(PROFILE_PHASE_TRANSITION);
+            DrawTransition();
+            EndProfileScope(PROFILE_PHASE_TRANSITION);
+        }
 
-        //DrawFPS(10, 10);
+        DrawProfilerOverlay();
 
+    BeginProfileScope(PROFILE_PHASE_SWAP);
     EndDrawing();
+    EndProfileScope(PROFILE_PHASE_SWAP);
     //----------------------------------------------------------------------------------
+
+    if (!firstFramePresented)
+    {
+        TraceLog(LOG_INFO, "STARTUP: First frame presented after %.1f ms", GetStartupTime()*1000.0);
+        firstFramePresented = true;
+    }
+
+    ResetInputLatches();
+
+    EndProfileFrame();
+}
+
+// Check if frame view changed since last drawn frame
+// NOTE: Screens report their own view changes, transitions, loading progress, profiler overlay
+// and input always draw; a frame is drawn every idleRedrawInterval anyway
+static bool IsFrameDirty(void)
+{
+    if (onTransition || startupLoading || IsProfilerOverlayVisible() || IsInputActive()) return true;
+    if ((screens[currentScreen].IsDirty == NULL) || screens[currentScreen].IsDirty()) return true;
+
+    return ((GetTime() - lastDrawTime) >= idleRedrawInterval);
+}
+
+// Request global assets, loaded asynchronously
+// NOTE: Assets are decoded on loader threads and uploaded a few per frame, logo screen
+// starts right away and shows loading progress, globals are set once all are loaded
+static void RequestStartupAssets(void)
+{
+    fontAsset = RequestAsset(ASSET_FONT, "resources/mecha.sdf");     // Baked from mecha.png at build time
+    fxCoinAsset = RequestAsset(ASSET_SOUND, "resources/coin.wav");
+    fxErrorAsset = RequestAsset(ASSET_SOUND, "resources/error.ogg");
+    musicAsset = RequestAsset(ASSET_MUSIC, "resources/ambient.ogg");
+
+    // NOTE: Pump model is kept resident between gameplay rounds, gameplay screen only adds a reference
+    pumpModelAsset = RequestAsset(ASSET_MODEL, "resources/pump.vox");
+
+    startupRequested = true;
+}
+
+// Update startup assets loading and its progress
+// NOTE: On web, assets archive download counts as half of startup progress
+static void UpdateStartupLoading(void)
+{
+    if (startupRequested && (UpdateAssetLoading(assetUploadBudget) == 0))
+    {
+        FinishStartupLoading();
+        return;
+    }
+
+    const float loadingProgress = startupRequested? GetAssetLoadingProgress() : 0.0f;
+
+    if (packFetchProgress >= 0.0f) startupProgress = 0.5f*(packFetchProgress + loadingProgress);
+    else startupProgress = loadingProgress;
+}
+
+// Set global assets once startup loading is done
+static void FinishStartupLoading(void)
+{
+    font = GetAssetFont(fontAsset);
+    fxCoin = GetAssetSound(fxCoinAsset);
+    fxError = GetAssetSound(fxErrorAsset);
+    music = GetAssetMusic(musicAsset);
+
+    SetMusicVolume(music, 1.0f);
+    PlayMusicStream(music);
+    SetMixerMusic(music);
+
+    startupLoading = false;
+    startupProgress = 1.0f;
+
+    TraceLog(LOG_INFO, "STARTUP: Assets loaded after %.1f ms", GetStartupTime()*1000.0);
+}
+
+// Get time since startup (seconds), used to measure time-to-first-frame
+// NOTE: On web, time is measured since page navigation start, so it includes downloading
+// the data package and compiling the module; on desktop, time is measured since InitWindow()
+static double GetStartupTime(void)
+{
+#if defined(PLATFORM_WEB)
+    return emscripten_get_now()/1000.0;
+#else
+    return GetTime();
+#endif
+}
+
+#if defined(PLATFORM_WEB)
+// Assets archive fetched, archive data ownership is taken by the assets archive
+static void OnAssetPackFetched(unsigned handle, void *userData, void *data, unsigned dataSize)
+{
+    TraceLog(LOG_INFO, "STARTUP: Assets archive fetched after %.1f ms (%u bytes)", GetStartupTime()*1000.0, dataSize);
+
+    if (!OpenAssetPackFromMemory((unsigned char *)data, (int)dataSize)) TraceLog(LOG_WARNING, "ASSETS: Invalid assets archive, loading loose files");
+
+    packFetchProgress = 1.0f;
+    RequestStartupAssets();
 }
+
+// Assets archive fetch failed, loose files are loaded if available (i.e. preloaded by a Makefile build)
+static void OnAssetPackFetchFailed(unsigned handle, void *userData, int httpCode, const char *status)
+{
+    TraceLog(LOG_WARNING, "ASSETS: Assets archive could not be fetched (HTTP %i), loading loose files", httpCode);
+
+    packFetchProgress = 1.0f;
+    RequestStartupAssets();
+}
+
+// Assets archive fetch progress
+static void OnAssetPackFetchProgress(unsigned handle, void *userData, int loaded, int total)
+{
+    if (total > 0) packFetchProgress = (float)loaded/(float)total;
+}
+#endif
+
+#if defined(BENCHMARK_MODE)
+// Run scripted benchmark stages, every screen and the transitions between them
+// NOTE: Restart stages go through ENDING to GAMEPLAY again, catching per-restart loading costs
+static void RunBenchmark(int frames, const char *outputFileName)
+{
+    scriptedScreens = true;
+    InitBenchmark();
+
+    RunBenchmarkLoading("startup_loading");
+    RunBenchmarkScreen("logo", frames);
+    RunBenchmarkTransition("logo_to_gameplay", GAMEPLAY);
+    RunBenchmarkScreen("gameplay", frames);
+    RunBenchmarkTransition("gameplay_to_ending", ENDING);
+    RunBenchmarkScreen("ending", frames);
+    RunBenchmarkTransition("ending_to_gameplay", GAMEPLAY);
+    RunBenchmarkScreen("gameplay_restart", frames);
+
+    // NOTE: Renderer scaling stage, forecourt pumps are instanced and frustum culled
+    screensModule->SetForecourtPumpCount(10000);
+    RunBenchmarkTransition("gameplay_to_forecourt", FORECOURT);
+    RunBenchmarkScreen("forecourt_10k", frames);
+
+    ExportBenchmarkResults(outputFileName);
+}
+
+// Run current screen for frames with scripted input
+// NOTE: Trigger held 45 frames and released 15, so input only depends on frame count
+static void RunBenchmarkScreen(const char *name, int frames)
+{
+    BeginBenchmarkStage(name);
+
+    for (int i = 0; (i < frames) && !WindowShouldClose(); i++)
+    {
+        SetScriptedTrigger((i%60) < 45);
+
+        const double frameStartTime = GetTime();
+        UpdateDrawFrame();
+        RecordBenchmarkFrame(GetTime() - frameStartTime);
+    }
+
+    EndBenchmarkStage();
+}
+
+// Run frames until startup loading is done
+static void RunBenchmarkLoading(const char *name)
+{
+    BeginBenchmarkStage(name);
+
+    SetScriptedTrigger(false);
+
+    while (startupLoading && !WindowShouldClose())
+    {
+        const double frameStartTime = GetTime();
+        UpdateDrawFrame();
+        RecordBenchmarkFrame(GetTime() - frameStartTime);
+    }
+
+    EndBenchmarkStage();
+}
+
+// Run transition to screen until it ends
+static void RunBenchmarkTransition(const char *name, int screen)
+{
+    BeginBenchmarkStage(name);
+
+    SetScriptedTrigger(false);
+    TransitionToScreen(screen);
+
+    while (onTransition && !WindowShouldClose())
+    {
+        const double frameStartTime = GetTime();
+        UpdateDrawFrame();
+        RecordBenchmarkFrame(GetTime() - frameStartTime);
+    }
+
+    EndBenchmarkStage();
+}
+#endif
@@ -0,0 +1,324 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Game replay
+*
+*   Compact session recording and playback, see replay.h for the file format.
+*
+**********************************************************************************************/
+
+#include "replay.h"
+
+#include <stdio.h>      // Required for: FILE, fopen(), fread(), fwrite()
+#include <stdlib.h>     // Required for: malloc(), realloc(), free()
+#include <string.h>     // Required for: memcpy(), memcmp()
+#include <limits.h>     // Required for: UINT_MAX
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_VARINT_SIZE     5           // Maximum bytes used by an unsigned int varint
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static int WriteVarint(unsigned char *buffer, unsigned int value);                          // Write variable length integer, returns bytes written
+static bool ReadVarint(const unsigned char *buffer, int size, int *position, unsigned int *value);  // Read variable length integer
+static unsigned int GetNextChangeTick(GameReplay *replay);                                  // Decode next input change step
+
+//----------------------------------------------------------------------------------
+// Replay Functions Definition
+//----------------------------------------------------------------------------------
+
+// Initialize replay for recording a new session
+void InitReplayRecording(GameReplay *replay, unsigned int seed, GameRules rules)
+{
+    UnloadReplay(replay);
+
+    replay->seed = seed;
+    replay->rules = rules;
+}
+
+// Record input of next simulation step
+// NOTE: Only input changes are stored, as steps elapsed since the previous change
+void RecordReplayStep(GameReplay *replay, GameInput input)
+{
+    replay->tick++;
+
+    if (input.pumpDown != replay->inputDown)
+    {
+        if (replay->dataSize + MAX_VARINT_SIZE > replay->dataCapacity)
+        {
+            int capacity = (replay->dataCapacity > 0)? replay->dataCapacity*2 : 256;
+            unsigned char *data = (unsigned char *)realloc(replay->data, capacity);
+            if (data == NULL) return;
+
+            replay->data = data;
+            replay->dataCapacity = capacity;
+        }
+
+        replay->dataSize += WriteVarint(replay->data + replay->dataSize, replay->tick - replay->lastChangeTick);
+        replay->lastChangeTick = replay->tick;
+        replay->inputDown = input.pumpDown;
+    }
+}
+
+// End recording, stores session outcome
+void EndReplayRecording(GameReplay *replay, const GameState *state)
+{
+    replay->endTick = replay->tick;
+    replay->rounds = state->rounds;
+    replay->score = state->score;
+}
+
+// Load replay from file
+GameReplay LoadReplay(const char *fileName)
+{
+    GameReplay replay = { 0 };
+    FILE *file = fopen(fileName, "rb");
+
+    if (file != NULL)
+    {
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        if (size > 0)
+        {
+            unsigned char *fileData = (unsigned char *)malloc(size);
+
+            if ((fileData != NULL) && (fread(fileData, 1, size, file) == (size_t)size)) replay = LoadReplayFromMemory(fileData, (int)size);
+
+            free(fileData);
+        }
+
+        fclose(file);
+    }
+
+    return replay;
+}
+
+// Load replay from file data
+GameReplay LoadReplayFromMemory(const unsigned char *fileData, int dataSize)
+{
+    GameReplay replay = { 0 };
+
+    if ((dataSize < 5) || (memcmp(fileData, "STPR", 4) != 0) || (fileData[4] != REPLAY_FILE_VERSION)) return replay;
+
+    int position = 5;
+    unsigned int values[7] = { 0 };
+    for (int i = 0; i < 7; i++) if (!ReadVarint(fileData, dataSize, &position, &values[i])) return replay;
+
+    replay.seed = values[0];
+    replay.rules.priceRangeMinCents = (int)values[1];
+    replay.rules.priceRangeMaxCents = (int)values[2];
+    replay.rules.pumpSpeed = (int)values[3];
+    replay.rules.hitTolerance = (int)values[4];
+    replay.rules.hitReward = (int)values[5];
+    replay.rules.gameOverScore = (int)values[6];
+
+    // Find input changes stream end, kept encoded
+    int changesPosition = position;
+    unsigned int delta = 0;
+    do
+    {
+        if (!ReadVarint(fileData, dataSize, &position, &delta)) return replay;
+    } while (delta != 0);
+
+    int changesSize = position - 1 - changesPosition;
+    unsigned int endTick = 0;
+    unsigned int rounds = 0;
+    unsigned int score = 0;
+    if (!ReadVarint(fileData, dataSize, &position, &endTick) || !ReadVarint(fileData, dataSize, &position, &rounds) ||
+        !ReadVarint(fileData, dataSize, &position, &score)) return replay;
+
+    replay.data = (unsigned char *)malloc((changesSize > 0)? changesSize : 1);
+    if (replay.data == NULL) return replay;
+
+    memcpy(replay.data, fileData + changesPosition, changesSize);
+    replay.dataSize = changesSize;
+    replay.dataCapacity = changesSize;
+    replay.endTick = endTick;
+    replay.rounds = (int)rounds;
+    replay.score = (int)score;
+
+    RewindReplay(&replay);
+
+    return replay;
+}
+
+// Check if replay loaded successfully
+bool IsReplayValid(GameReplay replay)
+{
+    return (replay.data != NULL);
+}
+
+// Export replay to file
+bool ExportReplay(const GameReplay *replay, const char *fileName)
+{
+    bool success = false;
+    int dataSize = 0;
+    unsigned char *fileData = ExportReplayToMemory(replay, &dataSize);
+
+    if (fileData != NULL)
+    {
+        FILE *file = fopen(fileName, "wb");
+
+        if (file != NULL)
+        {
+            success = (fwrite(fileData, 1, dataSize, file) == (size_t)dataSize);
+            fclose(file);
+        }
+
+        free(fileData);
+    }
+
+    return success;
+}
+
+// Export replay to file data (memory must be freed)
+unsigned char *ExportReplayToMemory(const GameReplay *replay, int *dataSize)
+{
+    const int maxSize = 5 + 7*MAX_VARINT_SIZE + replay->dataSize + 1 + 3*MAX_VARINT_SIZE;
+    unsigned char *fileData = (unsigned char *)malloc(maxSize);
+    int size = 0;
+
+    if (fileData != NULL)
+    {
+        memcpy(fileData, "STPR", 4);
+        fileData[4] = REPLAY_FILE_VERSION;
+        size = 5;
+
+        size += WriteVarint(fileData + size, replay->seed);
+        size += WriteVarint(fileData + size, (unsigned int)replay->rules.priceRangeMinCents);
+        size += WriteVarint(fileData + size, (unsigned int)replay->rules.priceRangeMaxCents);
+        size += WriteVarint(fileData + size, (unsigned int)replay->rules.pumpSpeed);
+        size += WriteVarint(fileData + size, (unsigned int)replay->rules.hitTolerance);
+        size += WriteVarint(fileData + size, (unsigned int)replay->rules.hitReward);
+        size += WriteVarint(fileData + size, (unsigned int)replay->rules.gameOverScore);
+
+        if (replay->dataSize > 0) memcpy(fileData + size, replay->data, replay->dataSize);
+        size += replay->dataSize;
+        fileData[size++] = 0;
+
+        size += WriteVarint(fileData + size, replay->endTick);
+        size += WriteVarint(fileData + size, (unsigned int)replay->rounds);
+        size += WriteVarint(fileData + size, (unsigned int)replay->score);
+    }
+
+    *dataSize = size;
+
+    return fileData;
+}
+
+// Unload replay data
+void UnloadReplay(GameReplay *replay)
+{
+    free(replay->data);
+    *replay = (GameReplay){ 0 };
+}
+
+// Rewind replay playback to first step
+void RewindReplay(GameReplay *replay)
+{
+    replay->tick = 0;
+    replay->lastChangeTick = 0;
+    replay->readPosition = 0;
+    replay->inputDown = false;
+    replay->nextChangeTick = GetNextChangeTick(replay);
+}
+
+// Get input of next simulation step, advances playback
+GameInput GetReplayStepInput(GameReplay *replay)
+{
+    replay->tick++;
+
+    if (replay->tick == replay->nextChangeTick)
+    {
+        replay->inputDown = !replay->inputDown;
+        replay->lastChangeTick = replay->tick;
+        replay->nextChangeTick = GetNextChangeTick(replay);
+    }
+
+    return (GameInput){ .pumpDown = replay->inputDown };
+}
+
+// Check if all recorded steps have been played back
+bool IsReplayFinished(const GameReplay *replay)
+{
+    return (replay->tick >= replay->endTick);
+}
+
+// Simulate whole replay headless, returns final game state
+// NOTE: Steps between input changes are advanced at once with UpdateGameStateSteps()
+GameState SimulateReplay(const GameReplay *replay)
+{
+    GameState state = { 0 };
+    GameReplay cursor = *replay;    // NOTE: Shares encoded data, only playback cursor is modified
+
+    InitGameState(&state, replay->rules, replay->seed);
+    RewindReplay(&cursor);
+
+    while ((cursor.tick < cursor.endTick) && state.gameRunning)
+    {
+        const unsigned int spanStart = cursor.tick + 1;
+        const GameInput input = GetReplayStepInput(&cursor);
+
+        unsigned int spanEnd = cursor.nextChangeTick - 1;
+        if (spanEnd > cursor.endTick) spanEnd = cursor.endTick;
+
+        UpdateGameStateSteps(&state, input, (int)(spanEnd - spanStart + 1));
+        cursor.tick = spanEnd;
+    }
+
+    return state;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Write variable length integer (LEB128), returns bytes written
+static int WriteVarint(unsigned char *buffer, unsigned int value)
+{
+    int size = 0;
+
+    while (value >= 0x80)
+    {
+        buffer[size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+
+    buffer[size++] = (unsigned char)value;
+
+    return size;
+}
+
+// Read variable length integer (LEB128)
+static bool ReadVarint(const unsigned char *buffer, int size, int *position, unsigned int *value)
+{
+    unsigned int result = 0;
+
+    for (int shift = 0; (shift < 7*MAX_VARINT_SIZE) && (*position < size); shift += 7)
+    {
+        const unsigned char byte = buffer[(*position)++];
+        result |= (unsigned int)(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0)
+        {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Decode next input change step, UINT_MAX if no more changes
+static unsigned int GetNextChangeTick(GameReplay *replay)
+{
+    unsigned int delta = 0;
+
+    if (!ReadVarint(replay->data, replay->dataSize, &replay->readPosition, &delta) || (delta == 0)) return UINT_MAX;
+
+    return replay->lastChangeTick + delta;
+}
@@ -0,0 +1,80 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Game replay
+*
+*   Compact session recording: game rules, session seed and the simulation steps where the
+*   pump trigger input changed, delta encoded as variable length integers (a few bytes per
+*   round). Played back step by step for rendering or fast-forwarded headless.
+*
+*   File format (.stpr, little-endian):
+*       "STPR" magic, version byte
+*       varint seed, varint price range min/max cents
+*       varint pump speed, hit tolerance, hit reward, game over score (milli-cents)
+*       varint steps since previous input change, repeated, 0 terminated
+*       varint end step, varint rounds, varint score (recorded outcome, milli-cents)
+*
+*   NOTE: No raylib dependency, so headless tools can load and simulate replays.
+*
+**********************************************************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game_state.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define REPLAY_FILE_VERSION     2           // Version 1 stored float rules and score
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Game replay
+typedef struct GameReplay {
+    unsigned int seed;          // Session random seed
+    GameRules rules;            // Session game rules
+    unsigned char *data;        // Input changes, steps delta encoded as varints
+    int dataSize;
+    int dataCapacity;
+    unsigned int endTick;       // Recorded steps
+    int rounds;                 // Recorded outcome, used to verify playback
+    int score;                  // Milli-cents
+
+    // Recording/playback cursor
+    unsigned int tick;          // Steps recorded or played back
+    unsigned int lastChangeTick;
+    unsigned int nextChangeTick;
+    int readPosition;
+    bool inputDown;
+} GameReplay;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Replay Functions Declaration
+//----------------------------------------------------------------------------------
+void InitReplayRecording(GameReplay *replay, unsigned int seed, GameRules rules);  // Initialize replay for recording a new session
+void RecordReplayStep(GameReplay *replay, GameInput input);                        // Record input of next simulation step
+void EndReplayRecording(GameReplay *replay, const GameState *state);               // End recording, stores session outcome
+
+GameReplay LoadReplay(const char *fileName);                                       // Load replay from file
+GameReplay LoadReplayFromMemory(const unsigned char *fileData, int dataSize);      // Load replay from file data
+bool IsReplayValid(GameReplay replay);                                             // Check if replay loaded successfully
+bool ExportReplay(const GameReplay *replay, const char *fileName);                 // Export replay to file
+unsigned char *ExportReplayToMemory(const GameReplay *replay, int *dataSize);      // Export replay to file data (memory must be freed)
+void UnloadReplay(GameReplay *replay);                                             // Unload replay data
+
+void RewindReplay(GameReplay *replay);                                             // Rewind replay playback to first step
+GameInput GetReplayStepInput(GameReplay *replay);                                  // Get input of next simulation step, advances playback
+bool IsReplayFinished(const GameReplay *replay);                                   // Check if all recorded steps have been played back
+GameState SimulateReplay(const GameReplay *replay);                                // Simulate whole replay headless, returns final game state
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REPLAY_H
@@ -25,12 +25,22 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "input.h"
+#include "hud.h"
+#include "stats_store.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define ENDING_BEST_SESSIONS    5       // High scores listed
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
 //----------------------------------------------------------------------------------
 static int framesCounter = 0;
 static int finishScreen = 0;
+static Hud hud = { 0 };
+static bool viewDirty = false;          // View changed since last drawn, static otherwise
 
 //----------------------------------------------------------------------------------
 // Ending Screen Functions Definition
@@ -41,16 +51,42 @@ void InitEndingScreen(void)
 {
     framesCounter = 0;
     finishScreen = 0;
+    viewDirty = true;
+
+    // Text rows, offsets from screen center, session result on top, stored statistics below
+    // NOTE: Statistics are queried from the store in-memory summary, no file access
+    InitHud(&hud, font);
+    AddHudText(&hud, "GAME OVER", 40, WHITE, HUD_ANCHOR_CENTER, 0, -260);
+    AddHudText(&hud, TextFormat("Rounds Survived: %d", rounds), 40, WHITE, HUD_ANCHOR_CENTER, 0, -200);
+
+    StatsDay today = { 0 };
+    if (GetStatsDay(GetStatsToday(), &today))
+    {
+        AddHudText(&hud, TextFormat("Today: %d rounds, %d hits, best $%.2f from target", today.rounds, today.hits, today.bestDelta),
+            30, LIGHTGRAY, HUD_ANCHOR_CENTER, 0, -140);
+    }
+
+    StatsSession best[ENDING_BEST_SESSIONS] = { 0 };
+    const int bestCount = GetStatsTopSessions(best, ENDING_BEST_SESSIONS);
+    if (bestCount > 0) AddHudText(&hud, "BEST RUNS", 30, GOLD, HUD_ANCHOR_CENTER, 0, -80);
+
+    for (int i = 0; i < bestCount; i++)
+    {
+        AddHudText(&hud, TextFormat("%d.  %d rounds  %04d-%02d-%02d", i + 1, best[i].rounds,
+            best[i].day/10000, (best[i].day/100)%100, best[i].day%100), 30, WHITE, HUD_ANCHOR_CENTER, 0, -40 + i*40);
+    }
+
+    AddHudText(&hud, "Press ENTER to return to play again", 40, WHITE, HUD_ANCHOR_CENTER, 0, 220);
 }
 
 // Ending Screen Update logic
 void UpdateEndingScreen(void)
 {
     // Press enter or tap to return to TITLE screen
-    if (IsKeyPressed(KEY_ENTER) || IsGestureDetected(GESTURE_TAP))
+    if (IsConfirmPressed())
     {
         finishScreen = 1;
-        PlaySound(fxCoin);
+        PlayMixerSound(fxCoin);
     }
 }
 
@@ -59,45 +95,21 @@ void DrawEndingScreen(void)
 {
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), BLUE);
 
-    const int screenWidth = GetScreenWidth();
-    const int screenHeight = GetScreenHeight();
-    const char* gameOverText = "GAME OVER";
-    const int fontSize = 40;
-    const int gameOverTextWidth = MeasureText(gameOverText, fontSize);
-    const int rowCount = 3;
-    const int margin = 80;
-    const int rowHeight = fontSize + margin;
-    const Color color = WHITE;
-    DrawText(gameOverText,
-        // x position
-        screenWidth / 2 - gameOverTextWidth / 2,
-        // y position
-        screenHeight / 2 - (rowCount * rowHeight) / 2,
-        fontSize,
-        color);
-    const char* roundsText = TextFormat("Rounds Survived: %d", rounds);
-    const int roundsTextWidth = MeasureText(roundsText, fontSize);
-    DrawText(roundsText,
-        // x position
-        screenWidth / 2 - roundsTextWidth / 2,
-        // y position
-        screenHeight / 2 - (rowCount * rowHeight) / 2 + rowHeight,
-        fontSize,
-        color);
-    const char* infoText = "Press ENTER to return to play again";
-    const int infoTextWidth = MeasureText(infoText, fontSize);
-    DrawText(infoText,
-        // x position
-        screenWidth / 2 - infoTextWidth / 2,
-        // y position
-        screenHeight / 2 - (rowCount * rowHeight) / 2 + 2 * rowHeight,
-        fontSize,
-        color);
+    DrawHud(&hud);
+
+    viewDirty = false;
+}
+
+// Ending Screen view changed since last drawn?
+bool IsEndingScreenDirty(void)
+{
+    return viewDirty;
 }
 
 // Ending Screen Unload logic
 void UnloadEndingScreen(void)
 {
+    UnloadHud(&hud);
 }
 
 // Ending Screen should finish?
@@ -0,0 +1,290 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Forecourt screen
+*
+*   Stress/showcase mode: a forecourt of many pumps, every pump running its own price state
+*   (idle, pumping towards a target, stopped on hit or miss), tinted by state. Pumps are
+*   frustum culled on CPU, sorted into levels of detail by projected size and drawn with one
+*   instanced draw call per level. Camera circles over the forecourt, so the visible set keeps
+*   changing.
+*
+*   NOTE: Renderer scaling test, run with "--forecourt N" (pumps count) or the benchmark.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "raymath.h"
+#include "screens.h"
+#include "input.h"
+#include "hud.h"
+#include "mesh_instancing.h"
+#include "voxel_mesh.h"
+
+#include <stdlib.h>     // Required for: calloc(), free()
+#include <math.h>       // Required for: sinf(), cosf(), sqrtf(), ceilf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_FORECOURT_PUMPS     100000
+#define FORECOURT_ISLAND_PUMPS  4           // Pumps per island row, islands are separated by a lane
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Forecourt pump state
+typedef enum PumpState {
+    PUMP_STATE_IDLE = 0,        // Waiting for next customer
+    PUMP_STATE_PUMPING,         // Price increasing towards target
+    PUMP_STATE_HIT,             // Stopped within tolerance of target
+    PUMP_STATE_MISSED,          // Stopped outside tolerance of target
+} PumpState;
+
+// Forecourt pump
+typedef struct ForecourtPump {
+    Matrix transform;
+    Vector3 center;             // Bounding sphere center
+    PumpState state;
+    float price;
+    float targetPrice;
+    float stopPrice;            // Price the customer stops at, close to target
+    float speed;                // Price increase per second while pumping
+    float timer;                // Time left on idle and stopped states (seconds)
+} ForecourtPump;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static int pumpCount = 1000;
+static ForecourtPump *pumps = NULL;
+static float pumpRadius = 0.0f;         // Bounding sphere radius, shared by all pumps
+static Vector2 forecourtSize = { 0 };
+static unsigned int randomState = 0;    // Pumps random generator, cheaper than GetRandomValue() for thousands of pumps
+
+static AssetHandle pumpModelAsset = ASSET_INVALID;
+static LodInstances pumpLods = { 0 };
+
+static Camera camera = { 0 };
+static float cameraAngle = 0.0f;
+static const float cameraSpeed = 0.05f;     // Radians per second
+
+static Hud hud = { 0 };
+static int hudDrawn = -1;
+static int hudFullDetail = -1;
+static int finishScreen = 0;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static float GetPumpRandomValue(float min, float max);  // Get random value from pumps random generator
+static void UpdatePump(ForecourtPump *pump, float deltaTime);   // Update pump price state
+static Color GetPumpColor(const ForecourtPump *pump);   // Get pump tint from its state
+
+//----------------------------------------------------------------------------------
+// Forecourt Screen Functions Definition
+//----------------------------------------------------------------------------------
+
+// Set pumps count of next forecourt
+void SetForecourtPumpCount(int count)
+{
+    pumpCount = (count < 1)? 1 : (count > MAX_FORECOURT_PUMPS)? MAX_FORECOURT_PUMPS : count;
+}
+
+// Forecourt Screen Initialization logic
+void InitForecourtScreen(void)
+{
+    finishScreen = 0;
+    randomState = 0x2545f491u;
+
+    // NOTE: Pump model is kept resident, acquiring only adds a reference
+    pumpModelAsset = AcquireAsset(ASSET_MODEL, "resources/pump.vox");
+    const Model model = GetAssetModel(pumpModelAsset);
+    const Mesh mesh = (model.meshCount > 0)? model.meshes[0] : (Mesh){ 0 };
+
+    // Pumps laid out on a grid of islands, mesh centered on its grid cell
+    const BoundingBox bounds = GetMeshBoundingBox(mesh);
+    const Vector3 size = Vector3Subtract(bounds.max, bounds.min);
+    const Vector3 offset = { -(bounds.min.x + bounds.max.x)*0.5f, -bounds.min.y, -(bounds.min.z + bounds.max.z)*0.5f };
+    const float spacingX = size.x*1.5f;
+    const float spacingZ = size.z*2.0f;
+    const float laneWidth = size.z*2.0f;
+    const int columns = (int)ceilf(sqrtf((float)pumpCount));
+    const int rows = (pumpCount + columns - 1)/columns;
+
+    forecourtSize.x = columns*spacingX;
+    forecourtSize.y = rows*spacingZ + (rows/FORECOURT_ISLAND_PUMPS)*laneWidth;
+    pumpRadius = Vector3Length(size)*0.5f;
+
+    pumps = (ForecourtPump *)calloc(pumpCount, sizeof(ForecourtPump));
+
+    for (int i = 0; i < pumpCount; i++)
+    {
+        ForecourtPump *pump = &pumps[i];
+        const int column = i%columns;
+        const int row = i/columns;
+        const Vector3 position = {
+            column*spacingX - forecourtSize.x*0.5f,
+            0.0f,
+            row*spacingZ + (row/FORECOURT_ISLAND_PUMPS)*laneWidth - forecourtSize.y*0.5f
+        };
+
+        pump->transform = MatrixTranslate(position.x + offset.x, offset.y, position.z + offset.z);
+        pump->center = (Vector3){ position.x, size.y*0.5f, position.z };
+        pump->state = PUMP_STATE_IDLE;
+        pump->timer = GetPumpRandomValue(0.0f, 3.0f);
+    }
+
+    pumpLods = LoadLodInstances(model, pumpCount);
+
+    camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 45.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    cameraAngle = 0.0f;
+
+    InitHud(&hud, font);
+    AddHudText(&hud, TextFormat("Forecourt: %i pumps (%s)", pumpCount, pumpLods.levels[0].instancing? "instanced" : "not instanced"), 20, WHITE, HUD_ANCHOR_BOTTOM_LEFT, 20, 90);
+    hudDrawn = AddHudText(&hud, "", 20, WHITE, HUD_ANCHOR_BOTTOM_LEFT, 20, 65);
+    hudFullDetail = AddHudText(&hud, "", 20, WHITE, HUD_ANCHOR_BOTTOM_LEFT, 20, 40);
+}
+
+// Forecourt Screen Update logic
+void UpdateForecourtScreen(void)
+{
+    for (int i = 0; i < pumpCount; i++) UpdatePump(&pumps[i], frameDeltaTime);
+
+    // Camera circles low over the forecourt, looking across it, so most pumps are out of view
+    const float radius = fmaxf(forecourtSize.x, forecourtSize.y)*0.35f;
+    cameraAngle += cameraSpeed*frameDeltaTime;
+    camera.position = (Vector3){ cosf(cameraAngle)*radius, radius*0.3f + 10.0f, sinf(cameraAngle)*radius };
+    camera.target = (Vector3){ -cosf(cameraAngle)*radius*0.25f, 0.0f, -sinf(cameraAngle)*radius*0.25f };
+
+    if (IsConfirmPressed()) finishScreen = 1;
+}
+
+// Forecourt Screen Draw logic
+void DrawForecourtScreen(void)
+{
+    ClearBackground(SKYBLUE);
+
+    BeginMode3D(camera);
+
+        DrawPlane((Vector3){ 0.0f, 0.0f, 0.0f }, (Vector2){ forecourtSize.x + 20.0f, forecourtSize.y + 20.0f }, DARKGRAY);
+
+        // NOTE: Culling uses current 3D mode matrices, visible pumps are packed into their level instances
+        const Frustum frustum = GetCurrentFrustum();
+        int visibleCount = 0;
+
+        ClearLodInstances(&pumpLods);
+
+        for (int i = 0; i < pumpCount; i++)
+        {
+            if (!IsSphereInFrustum(&frustum, pumps[i].center, pumpRadius)) continue;
+
+            float lodFade = 0.0f;
+            const int lod = GetVoxelLod(camera, pumps[i].center, pumpLods.levelCount, &lodFade);
+
+            AddLodInstance(&pumpLods, pumps[i].transform, GetPumpColor(&pumps[i]), lod, lodFade);
+            visibleCount++;
+        }
+
+        DrawLodInstances(&pumpLods);
+
+    EndMode3D();
+
+    SetHudValue(&hud, hudDrawn, "Drawn: %i", visibleCount);
+    SetHudValue(&hud, hudFullDetail, "Full detail: %i", pumpLods.levels[0].count);
+    DrawHud(&hud);
+}
+
+// Forecourt Screen Unload logic
+void UnloadForecourtScreen(void)
+{
+    UnloadHud(&hud);
+    UnloadLodInstances(&pumpLods);
+
+    free(pumps);
+    pumps = NULL;
+
+    ReleaseAsset(pumpModelAsset);
+    pumpModelAsset = ASSET_INVALID;
+}
+
+// Forecourt Screen should finish?
+int FinishForecourtScreen(void)
+{
+    return finishScreen;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Get random value from pumps random generator (xorshift32)
+static float GetPumpRandomValue(float min, float max)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return min + (max - min)*(float)(randomState >> 8)/16777216.0f;
+}
+
+// Update pump price state
+static void UpdatePump(ForecourtPump *pump, float deltaTime)
+{
+    switch (pump->state)
+    {
+        case PUMP_STATE_IDLE:
+        {
+            pump->timer -= deltaTime;
+            if (pump->timer <= 0.0f)
+            {
+                pump->state = PUMP_STATE_PUMPING;
+                pump->price = 0.0f;
+                pump->targetPrice = GetPumpRandomValue(0.25f, 2.0f);
+                pump->stopPrice = pump->targetPrice + GetPumpRandomValue(-0.1f, 0.1f);
+                pump->speed = GetPumpRandomValue(0.15f, 0.75f);
+            }
+        } break;
+        case PUMP_STATE_PUMPING:
+        {
+            pump->price += pump->speed*deltaTime;
+            if (pump->price >= pump->stopPrice)
+            {
+                pump->state = (fabsf(pump->price - pump->targetPrice) < 0.02f)? PUMP_STATE_HIT : PUMP_STATE_MISSED;
+                pump->timer = GetPumpRandomValue(1.0f, 2.0f);
+            }
+        } break;
+        case PUMP_STATE_HIT:
+        case PUMP_STATE_MISSED:
+        {
+            pump->timer -= deltaTime;
+            if (pump->timer <= 0.0f)
+            {
+                pump->state = PUMP_STATE_IDLE;
+                pump->timer = GetPumpRandomValue(0.5f, 3.0f);
+            }
+        } break;
+        default: break;
+    }
+}
+
+// Get pump tint from its state, pumping tint goes to orange as price gets close to target
+static Color GetPumpColor(const ForecourtPump *pump)
+{
+    switch (pump->state)
+    {
+        case PUMP_STATE_PUMPING:
+        {
+            const float amount = Clamp(pump->price/pump->targetPrice, 0.0f, 1.0f);
+            return (Color){ 255, (unsigned char)(255 - 94*amount), (unsigned char)(255 - 255*amount), 255 };
+        }
+        case PUMP_STATE_HIT: return LIME;
+        case PUMP_STATE_MISSED: return RED;
+        default: break;
+    }
+
+    return LIGHTGRAY;
+}
@@ -26,7 +26,18 @@
 #include "raylib.h"
 #include "screens.h"
 #include <math.h>
+#include <stddef.h>
 #include "raymath.h"
+#include "game_state.h"
+#include "input.h"
+#include "replay.h"
+#include "hud.h"
+#include "mesh_instancing.h"
+#include "voxel_mesh.h"
+#include "particles.h"
+#include "price_display.h"
+#include "dynamic_resolution.h"
+#include "stats_store.h"
 
 // TODO: Fade in text near animation end
 // TODO: Game end state
@@ -35,26 +46,79 @@
 
 #define GO_TO_ENDING 0
 
-static bool gameRunning;
+#define MAX_GAMEPLAY_PARTICLES  16384
+#define FUEL_SPRAY_RATE         600.0f      // Droplets per second while pumping
+#define COIN_BURST_PARTICLES    80          // Coins per round hit
 
-static Camera camera;
 // Camera animation
 static const Vector3 cameraTarget = {0, 4.25, 0};
 static const Vector3 cameraAnimationPosition1 = {50, 50, 50};
 static const Vector3 cameraAnimationPosition2 = {0, 10, 15};
 static const float cameraAnimationTime = 2;
-static float cameraAnimationCurrentTime = 0;
 
-static Model pumpModel;
+static const Vector3 pumpPosition = {-5.25, 0, -7};
 
-static float currentPrice = 0.0f;
-static float targetPrice = 0.0f;
-static bool isPumping = false;
-static float pumpSpeed = 0.015f;
-static float score = 0;
-int rounds = 0;
-static int priceRangeMinCents = 25;
-static int priceRangeMaxCents = 200;
+// Feedback particles: fuel spray while pumping, coin burst on round hit
+static const ParticleEmitter fuelSpray = { {-2.2f, 3.4f, 0.5f}, {1.2f, 0.4f, 0.6f}, 0.35f, 1.0f, 0.04f, {240, 170, 30, 255} };   // Left of price display, in camera view
+static const ParticleEmitter coinBurst = { {0.0f, 4.25f, 0.5f}, {0.0f, 3.0f, 1.0f}, 1.6f, 1.2f, 0.12f, {255, 203, 0, 255} };
+
+static const char *replayFileName = "last_session.stpr";
+
+// Gameplay state, kept by the host across screens module reloads on hot reload builds
+// NOTE: Increase GAMEPLAY_DATA_VERSION on layout changes that keep its size, a module with
+// a different layout is not reloaded (restart required)
+#define GAMEPLAY_DATA_VERSION   1
+
+typedef struct GameplayData {
+    Camera camera;
+    float cameraAnimationCurrentTime;
+
+    AssetHandle pumpModelAsset;
+    Model pumpModel;
+    LodInstances pumpLods;              // Pump drawn at its level of detail, dithered between levels while the camera flies in
+
+    // Gameplay simulation, advanced in fixed steps and interpolated for rendering
+    GameState gameState;
+    double simulationTime;              // Time simulated so far, GetTime() base
+    float stepAlpha;
+    bool triggerDown;                   // Trigger state at simulationTime
+    double releaseTime;                 // Last trigger release timestamp
+    float stopLatency;                  // Time from trigger release to stop processed, last round
+    unsigned int pumpStartTick;         // Step the pump trigger was pressed on current round
+    bool viewDirty;                     // View changed since last drawn (camera animation, pumping, round events)
+
+    ParticleSystem particles;
+    float sprayAccumulator;             // Droplets owed to next frame (fractional)
+
+    // Current price odometer and fuel gauge, drawn by shader on the pump display panel
+    PriceDisplay priceDisplay;
+
+    // 3D pass resolution scaled with GPU frame time, HUD is drawn at native resolution
+    DynamicResolution resolution;
+    float resolutionBudget;             // GPU frame time budget (milliseconds), 0 keeps native resolution
+    bool resolutionPostAA;
+
+    // Session replay, recorded while playing or played back instead of trigger input
+    GameReplay replay;
+    bool replayPlayback;
+
+    // Gameplay texts, laid out centered in rows (fontSize + margin apart) and cached
+    Hud hud;
+    int hudTarget;
+    int hudScore;
+    int hudRounds;
+    int hudInstructions;
+} GameplayData;
+
+// Gameplay state defaults, applied by InitGameplayData() on hot reload builds
+#define GAMEPLAY_DATA_DEFAULTS  { .pumpModelAsset = ASSET_INVALID, .resolutionPostAA = true, .hudTarget = -1, .hudScore = -1, .hudRounds = -1, .hudInstructions = -1 }
+
+#if defined(HOT_RELOAD)
+static GameplayData *gameplay = NULL;   // Owned by the host, set to defaults on first load
+#else
+static GameplayData gameplayData = GAMEPLAY_DATA_DEFAULTS;
+static GameplayData *const gameplay = &gameplayData;    // NOTE: Constant address, accessed as a module variable
+#endif
 
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Definition
@@ -62,92 +126,180 @@ static int priceRangeMaxCents = 200;
 
 static void UpdateGameCamera(float deltaTime)
 {
-    cameraAnimationCurrentTime += deltaTime;
-    camera.position = Vector3Lerp(cameraAnimationPosition1, cameraAnimationPosition2, Clamp(cameraAnimationCurrentTime / cameraAnimationTime, 0, 1));
+    // NOTE: Checked before advancing, so the frame reaching the end position is drawn too
+    if (gameplay->cameraAnimationCurrentTime < cameraAnimationTime) gameplay->viewDirty = true;
+
+    gameplay->cameraAnimationCurrentTime += deltaTime;
+    gameplay->camera.position = Vector3Lerp(cameraAnimationPosition1, cameraAnimationPosition2, Clamp(gameplay->cameraAnimationCurrentTime / cameraAnimationTime, 0, 1));
+}
+
+// Preload gameplay assets on CPU side (background thread, no GPU calls)
+// NOTE: Pump model is usually kept resident, so preload only happens if it was released
+void PreloadGameplayScreen(void)
+{
+    PreloadAsset(ASSET_MODEL, "resources/pump.vox");
 }
 
 void InitGameplayScreen(void)
 {
-    gameRunning = true;
+    gameplay->camera.position = cameraAnimationPosition1;
+    gameplay->camera.target = cameraTarget;
+    gameplay->camera.up = (Vector3){0, 1, 0};
+    gameplay->camera.fovy = 10;
+    gameplay->camera.projection = CAMERA_PERSPECTIVE;
+
+    // NOTE: Model stays resident between rounds, acquiring only adds a reference
+    gameplay->pumpModelAsset = AcquireAsset(ASSET_MODEL, "resources/pump.vox");
+    gameplay->pumpModel = GetAssetModel(gameplay->pumpModelAsset);
+    gameplay->pumpLods = LoadLodInstances(gameplay->pumpModel, 1);
+
+    gameplay->particles = LoadParticleSystem(MAX_GAMEPLAY_PARTICLES, (ParticleForces){ 9.8f, 0.8f, 0.0f });
+    gameplay->sprayAccumulator = 0.0f;
 
-    currentPrice = 0.0f;
-    targetPrice = GetRandomValue(priceRangeMinCents, priceRangeMaxCents) / 100.0f;
-    isPumping = false;
+    gameplay->priceDisplay = LoadPriceDisplay();
+    gameplay->resolution = LoadDynamicResolution(gameplay->resolutionBudget, gameplay->resolutionPostAA);
+
+    AssetMemoryStats memoryStats = GetAssetMemoryStats();
+    TraceLog(LOG_DEBUG, "ASSETS: %i resident (CPU: %lld bytes, GPU: %lld bytes)", memoryStats.assetCount, memoryStats.cpuBytes, memoryStats.gpuBytes);
+
+    if (gameplay->replayPlayback)
+    {
+        InitGameState(&gameplay->gameState, gameplay->replay.rules, gameplay->replay.seed);
+        RewindReplay(&gameplay->replay);
+    }
+    else
+    {
+        // NOTE: Pump speed scales with the rounds survived on the previous game
+        GameRules rules = GetDefaultGameRules();
+        rules.pumpSpeed = rules.pumpSpeed*(int)Clamp((float)(rounds*2), 10.0f, 50.0f)/10;
 
-    camera.position = cameraAnimationPosition1;
-    camera.target = cameraTarget;
-    camera.up = (Vector3){0, 1, 0};
-    camera.fovy = 10;
-    camera.projection = CAMERA_PERSPECTIVE;
+        // NOTE: Session seed is the only random value drawn outside the game state
+        const unsigned int seed = (unsigned int)GetRandomValue(0, 0x7fffffff);
+        InitGameState(&gameplay->gameState, rules, seed);
+        InitReplayRecording(&gameplay->replay, seed, rules);
+    }
 
-    pumpModel = LoadModel("resources/pump.vox");
+    // Text rows, offsets from screen center: (row - rowCount/2)*rowHeight, rowCount = 4, rowHeight = 40 + 80
+    InitHud(&gameplay->hud, font);
+    AddHudText(&gameplay->hud, "Gas Pump Game", 40, DARKGRAY, HUD_ANCHOR_CENTER, 0, -240);
+    gameplay->hudTarget = AddHudText(&gameplay->hud, "", 40, DARKGRAY, HUD_ANCHOR_CENTER, 0, -120);
+    gameplay->hudScore = AddHudText(&gameplay->hud, "", 40, DARKGRAY, HUD_ANCHOR_CENTER, 0, 100);
+    AddHudText(&gameplay->hud, "Keep score below $1.00", 20, DARKGRAY, HUD_ANCHOR_CENTER, 0, 140);
+    AddHudText(&gameplay->hud, "Below $0.02 reduces score by $0.25", 20, DARKGRAY, HUD_ANCHOR_CENTER, 0, 165);
+    AddHudText(&gameplay->hud, "Lower score is better", 20, DARKGRAY, HUD_ANCHOR_CENTER, 0, 190);
+    gameplay->hudRounds = AddHudText(&gameplay->hud, "", 40, DARKGRAY, HUD_ANCHOR_CENTER, 0, 210);
+    gameplay->hudInstructions = AddHudText(&gameplay->hud, "", 20, WHITE, HUD_ANCHOR_BOTTOM_LEFT, 20, 40);
 
-    currentPrice = 0.0f;
-    isPumping = false;
-    pumpSpeed = 0.15f * Clamp(rounds * 2 / 10.0f, 1.0f, 5.0f);
-    score = 0;
+    gameplay->simulationTime = GetTime();
+    gameplay->stepAlpha = 0.0f;
+    gameplay->triggerDown = IsTriggerDown();
+    gameplay->releaseTime = 0.0;
+    gameplay->stopLatency = 0.0f;
+    gameplay->pumpStartTick = 0;
+    gameplay->viewDirty = true;
+    ClearTriggerEdges();
     rounds = 0;
 }
 
 void UpdateGameplayScreen(void)
 {
-    const float deltaTime = GetFrameTime();
+    const float deltaTime = frameDeltaTime;
+    const double currentTime = GetTime();
+
+    // Advance simulation in fixed steps up to current time, leftover time is used to interpolate rendering
+    if (currentTime - gameplay->simulationTime > GAME_MAX_STEP_TIME) gameplay->simulationTime = currentTime - GAME_MAX_STEP_TIME;
 
-    if (IsKeyDown(KEY_SPACE) || IsMouseButtonDown(MOUSE_LEFT_BUTTON))
+    while (gameplay->simulationTime + GAME_STEP_TIME <= currentTime)
     {
-        if (!isPumping)
+        gameplay->simulationTime += GAME_STEP_TIME;
+
+        // NOTE: Trigger edges are applied on the step they happened, not on the frame they were processed
+        InputEdge edge = { 0 };
+        while (PopTriggerEdge(gameplay->simulationTime, &edge))
         {
-            isPumping = true;
+            gameplay->triggerDown = edge.down;
+            if (!edge.down) gameplay->releaseTime = edge.time;
         }
-        currentPrice = currentPrice + (pumpSpeed * deltaTime);
-    }
-    else if (isPumping)
-    {
-        isPumping = false;
-        // Game over
-        const float roundDelta = fabsf(currentPrice - targetPrice);
-        if (roundDelta < 0.02f)
+
+        if (!gameplay->gameState.gameRunning || (gameplay->replayPlayback && IsReplayFinished(&gameplay->replay))) break;
+
+        GameInput input = { .pumpDown = gameplay->triggerDown };
+        if (gameplay->replayPlayback) input = GetReplayStepInput(&gameplay->replay);
+        else RecordReplayStep(&gameplay->replay, input);
+
+        const int roundTarget = gameplay->gameState.targetPrice;
+        const int roundPrice = gameplay->gameState.currentPrice;    // Price does not change on the stop step
+
+        const GameEvent event = UpdateGameState(&gameplay->gameState, input);
+        if (event != GAME_EVENT_NONE) gameplay->viewDirty = true;
+        if (event == GAME_EVENT_PUMP_STARTED) gameplay->pumpStartTick = gameplay->gameState.tick;
+
+        if ((event == GAME_EVENT_ROUND_HIT) || (event == GAME_EVENT_ROUND_MISSED))
         {
-            score -= 0.25f;
-            if (score < 0.0f)
+            PlayMixerSound((event == GAME_EVENT_ROUND_HIT)? fxCoin : fxError);
+            if (event == GAME_EVENT_ROUND_HIT) EmitParticles(&gameplay->particles, coinBurst, COIN_BURST_PARTICLES);
+            rounds = gameplay->gameState.rounds;
+
+            gameplay->stopLatency = (float)(currentTime - gameplay->releaseTime);
+            TraceLog(LOG_DEBUG, "GAMEPLAY: Round %i stopped %i cents from target, input to stop latency: %.2f ms",
+                gameplay->gameState.rounds, gameplay->gameState.lastRoundDelta/GAME_CENT, gameplay->stopLatency*1000.0f);
+
+            // NOTE: Only played rounds are recorded, replays played back are not
+            if (!gameplay->replayPlayback)
             {
-                score = 0.0f;
+                const float pumpTime = (float)((gameplay->gameState.tick - gameplay->pumpStartTick)*GAME_STEP_TIME);
+                const float stopPrice = (float)GetGamePriceCents(roundPrice)/100.0f;
+                AddStatsRound((StatsRound){ gameplay->gameState.rounds, (float)roundTarget/GAME_DOLLAR, stopPrice, pumpTime, gameplay->stopLatency, (event == GAME_EVENT_ROUND_HIT) });
             }
-            PlaySound(fxCoin);
-        }
-        else 
-        {
-            PlaySound(fxError);
         }
-        rounds += 1;
+    }
 
-        score += roundDelta;
-        const bool isEndGame = score > 1.0f;
-        if (isEndGame)
-        {
-            gameRunning = false;
-        }
-        else
-        {
-            // Reset for another try
-            currentPrice = 0.0f;
-            targetPrice = GetRandomValue(priceRangeMinCents, priceRangeMaxCents) / 100.0f;
-        }
+    gameplay->stepAlpha = (float)((currentTime - gameplay->simulationTime)/GAME_STEP_TIME);
+
+    // NOTE: Price only changes while pumping, otherwise texts stay the same until next round event
+    if (gameplay->gameState.isPumping)
+    {
+        gameplay->viewDirty = true;
+
+        gameplay->sprayAccumulator += FUEL_SPRAY_RATE*deltaTime;
+        const int droplets = (int)gameplay->sprayAccumulator;
+        gameplay->sprayAccumulator -= droplets;
+        EmitParticles(&gameplay->particles, fuelSpray, droplets);
     }
 
+    UpdateParticleSystem(&gameplay->particles, deltaTime);
+    if (gameplay->particles.particles.count > 0) gameplay->viewDirty = true;
+
     // UpdateCamera(&camera, CAMERA_THIRD_PERSON);
     UpdateGameCamera(deltaTime);
+
+    // NOTE: Scale changes only show on next drawn frame, they do not make the view dirty
+    UpdateDynamicResolution(&gameplay->resolution);
 }
 
 void DrawGameplayScreen(void)
 {
+    BeginDynamicResolution(&gameplay->resolution);
+
     ClearBackground(BLACK);
 
-    BeginMode3D(camera);
+    BeginMode3D(gameplay->camera);
     {
         //DrawGrid(10, 1.0);
 
-        DrawModel(pumpModel, (Vector3){-5.25, 0, -7}, 1.0, WHITE);
+        float lodFade = 0.0f;
+        const int lod = GetVoxelLod(gameplay->camera, pumpPosition, gameplay->pumpLods.levelCount, &lodFade);
+
+        ClearLodInstances(&gameplay->pumpLods);
+        AddLodInstance(&gameplay->pumpLods, MatrixTranslate(pumpPosition.x, pumpPosition.y, pumpPosition.z), WHITE, lod, lodFade);
+        DrawLodInstances(&gameplay->pumpLods);
+        DrawParticleSystem(&gameplay->particles);
+
+        // Current price rolls on the pump display panel, just in front of its voxels
+        // NOTE: Displayed cents come from the integer price, sub-cent remainder only rolls the cents wheel
+        const int displayPrice = GetGameStatePrice(&gameplay->gameState, gameplay->stepAlpha);
+        DrawPriceDisplay(gameplay->priceDisplay, (Vector3){0.0f, 4.25f, -0.7f}, (Vector2){1.4f, 0.6f}, GetGamePriceCents(displayPrice),
+            (float)(displayPrice%GAME_CENT)/GAME_CENT, GetGamePriceCents(gameplay->gameState.targetPrice));
 
         const float cameraAnimationTargetScale = 1.0;
         const Color cameraAnimationTargetColor = MAROON;
@@ -156,107 +308,111 @@ void DrawGameplayScreen(void)
     }
     EndMode3D();
 
-    if (Clamp(cameraAnimationCurrentTime / cameraAnimationTime, 0, 1) >= 0.95)
-    {
-        const int screenWidth = GetScreenWidth();
-        const int screenHeight = GetScreenHeight();
-        const char* titleText = "Gas Pump Game";
-        const int fontSize = 40;
-        const int titleTextWidth = MeasureText(titleText, fontSize);
-        const int rowCount = 4;
-        const int margin = 80;
-        const int rowHeight = fontSize + margin;
-        DrawText(titleText,
-            // x position
-            screenWidth / 2 - titleTextWidth / 2,
-            // y position
-            screenHeight / 2 - (rowCount * rowHeight) / 2,
-            fontSize,
-            DARKGRAY);
-        const char* targetText = TextFormat("Target: $%.2f", targetPrice);
-        const int targetTextWidth = MeasureText(targetText, fontSize);
-        DrawText(targetText,
-            // x position
-            screenWidth / 2 - targetTextWidth / 2,
-            // y position
-            screenHeight / 2 - (rowCount * rowHeight) / 2 + rowHeight,
-            fontSize,
-            DARKGRAY);
-        const char* currentText = TextFormat("Current: $%.2f", currentPrice);
-        const int currentTextWidth = MeasureText(currentText, fontSize);
-        DrawText(currentText,
-            // x position
-            screenWidth / 2 - currentTextWidth / 2,
-            // y position
-            screenHeight / 2 - (rowCount * rowHeight) / 2 + 2 * rowHeight,
-            fontSize,
-            DARKGRAY);
-        const char* scoreText = TextFormat("Score: $%.2f", score);
-        const int scoreTextWidth = MeasureText(scoreText, fontSize);
-        DrawText(scoreText,
-            // x position
-            screenWidth / 2 - scoreTextWidth / 2,
-            // y position
-            screenHeight / 2 - (rowCount * rowHeight) / 2 + 3 * rowHeight - 20,
-            fontSize,
-            DARKGRAY);
-        const char* scoreLabelText = "Keep score below $1.00";
-        const int scoreLabelFontSize = 20;
-        const int scoreLabelTextWidth = MeasureText(scoreLabelText, scoreLabelFontSize);
-        DrawText(scoreLabelText,
-            // x position
-            screenWidth / 2 - scoreLabelTextWidth / 2,
-            // y position
-            screenHeight / 2 - (rowCount * rowHeight) / 2 + 4 * rowHeight - 100,
-            scoreLabelFontSize,
-            DARKGRAY);
-        const char* scoreLabel2Text = "Below $0.02 reduces score by $0.25";
-        const int scoreLabel2FontSize = 20;
-        const int scoreLabel2TextWidth = MeasureText(scoreLabel2Text, scoreLabel2FontSize);
-        DrawText(scoreLabel2Text,
-            // x position
-            screenWidth / 2 - scoreLabel2TextWidth / 2,
-            // y position
-            screenHeight / 2 - (rowCount * rowHeight) / 2 + 4 * rowHeight - 75,
-            scoreLabel2FontSize,
-            DARKGRAY);
-        const char* scoreLabel3Text = "Lower score is better";
-        const int scoreLabel3FontSize = 20;
-        const int scoreLabel3TextWidth = MeasureText(scoreLabel3Text, scoreLabel3FontSize);
-        DrawText(scoreLabel3Text,
-            // x position
-            screenWidth / 2 - scoreLabel3TextWidth / 2,
-            // y position
-            screenHeight / 2 - (rowCount * rowHeight) / 2 + 4 * rowHeight - 50,
-            scoreLabel3FontSize,
-            DARKGRAY);
-        const char* roundsText = TextFormat("Rounds: %d", rounds);
-        const int roundsTextWidth = MeasureText(roundsText, fontSize);
-        DrawText(roundsText,
-            // x position
-            screenWidth / 2 - roundsTextWidth / 2,
-            // y position
-            screenHeight / 2 - (rowCount * rowHeight) / 2 + 5 * rowHeight - 150,
-            fontSize,
-            DARKGRAY);
-    }
+    EndDynamicResolution(&gameplay->resolution);
+
+    // NOTE: Texts are only formatted and re-rendered when their displayed value changes
+    const bool panelVisible = (Clamp(gameplay->cameraAnimationCurrentTime / cameraAnimationTime, 0, 1) >= 0.95);
+    for (int i = 0; i < gameplay->hud.textCount; i++) if (i != gameplay->hudInstructions) SetHudTextVisible(&gameplay->hud, i, panelVisible);
+
+    // NOTE: Target and score are whole cents, displayed exactly as scored
+    SetHudCents(&gameplay->hud, gameplay->hudTarget, "Target: ", gameplay->gameState.targetPrice/GAME_CENT);
+    SetHudCents(&gameplay->hud, gameplay->hudScore, "Score: ", gameplay->gameState.score/GAME_CENT);
+    SetHudValue(&gameplay->hud, gameplay->hudRounds, "Rounds: %d", rounds);
 
     // Draw pump instructions
-    if (!isPumping)
-    {
-        DrawText("Hold SPACE or LEFT MOUSE BUTTON to pump", 20, GetScreenHeight() - 40, 20, WHITE);
-    }
-    else
-    {
-        DrawText("Release to stop pumping", 20, GetScreenHeight() - 40, 20, WHITE);
-    }
+    SetHudText(&gameplay->hud, gameplay->hudInstructions, gameplay->gameState.isPumping? "Release to stop pumping" : "Hold SPACE or LEFT MOUSE BUTTON to pump");
+
+    DrawHud(&gameplay->hud);
+
+    gameplay->viewDirty = false;
+}
+
+// Check if gameplay view changed since last drawn
+bool IsGameplayScreenDirty(void)
+{
+    return gameplay->viewDirty;
 }
 
 void UnloadGameplayScreen(void)
 {
+    // NOTE: Abandoned sessions are saved too, recorded outcome is the state when leaving
+    if (!gameplay->replayPlayback)
+    {
+        EndReplayRecording(&gameplay->replay, &gameplay->gameState);
+        if (gameplay->gameState.rounds > 0) EndStatsSession(gameplay->gameState.rounds, (float)gameplay->gameState.score/GAME_DOLLAR);
+#if !defined(PLATFORM_WEB)
+        if (ExportReplay(&gameplay->replay, replayFileName)) TraceLog(LOG_INFO, "GAMEPLAY: Session replay saved to %s (%i bytes of input)", replayFileName, gameplay->replay.dataSize);
+#endif
+    }
+
+    UnloadReplay(&gameplay->replay);
+    gameplay->replayPlayback = false;
+
+    UnloadHud(&gameplay->hud);
+    UnloadLodInstances(&gameplay->pumpLods);
+    UnloadParticleSystem(&gameplay->particles);
+    UnloadPriceDisplay(&gameplay->priceDisplay);
+    UnloadDynamicResolution(&gameplay->resolution);
+
+    ReleaseAsset(gameplay->pumpModelAsset);
+    gameplay->pumpModelAsset = ASSET_INVALID;
+    gameplay->pumpModel = (Model){ 0 };
 }
 
 int FinishGameplayScreen(void)
 {
-    return !gameRunning;
+    return !gameplay->gameState.gameRunning || (gameplay->replayPlayback && IsReplayFinished(&gameplay->replay));
+}
+
+// Get time from trigger release to the stop being processed on last round (seconds)
+float GetGameplayStopLatency(void)
+{
+    return gameplay->stopLatency;
+}
+
+// Set replay file to be played back by next gameplay session, instead of trigger input
+bool SetGameplayReplay(const char *fileName)
+{
+    UnloadReplay(&gameplay->replay);
+    gameplay->replay = LoadReplay(fileName);
+    gameplay->replayPlayback = IsReplayValid(gameplay->replay);
+
+    if (gameplay->replayPlayback) TraceLog(LOG_INFO, "GAMEPLAY: Replay loaded from %s (%u steps, %i rounds)", fileName, gameplay->replay.endTick, gameplay->replay.rounds);
+    else TraceLog(LOG_WARNING, "GAMEPLAY: Failed to load replay %s", fileName);
+
+    return gameplay->replayPlayback;
+}
+
+// Set GPU frame time budget (milliseconds) 3D pass resolution is scaled to, 0 keeps native resolution
+void SetGameplayResolutionBudget(float budget, bool postAA)
+{
+    gameplay->resolutionBudget = (budget > 0.0f)? budget : 0.0f;
+    gameplay->resolutionPostAA = postAA;
+}
+
+// Get gameplay state size (bytes) and layout version, stored by the host on hot reload builds
+int GetGameplayDataSize(int *version)
+{
+    *version = GAMEPLAY_DATA_VERSION;
+    return (int)sizeof(GameplayData);
+}
+
+// Set gameplay state storage, owned by the host so it survives screens module reloads
+// NOTE: Only used on hot reload builds, otherwise state is a module variable
+void SetGameplayData(void *data)
+{
+#if defined(HOT_RELOAD)
+    gameplay = (GameplayData *)data;
+#else
+    (void)data;
+#endif
+}
+
+// Init gameplay state storage to defaults, called by the host after SetGameplayData() on first load
+// NOTE: Static builds state is initialized with the same defaults
+void InitGameplayData(void)
+{
+    static const GameplayData defaults = GAMEPLAY_DATA_DEFAULTS;
+
+    *gameplay = defaults;
 }
@@ -25,13 +25,38 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "tween.h"      // NOTE: Logo animation stages are driven by elapsed time, not frames
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Logo animation timeline stages
+typedef enum LogoStage {
+    LOGO_STAGE_BLINK = 0,           // Top-left square corner blink
+    LOGO_STAGE_TOP_LEFT,            // Bars animation: top and left
+    LOGO_STAGE_BOTTOM_RIGHT,        // Bars animation: bottom and right
+    LOGO_STAGE_LETTERS,             // "raylib" text-write animation
+    LOGO_STAGE_HOLD,                // Full logo, "powered by" shown
+    LOGO_STAGE_FADE,                // Fade out everything
+    LOGO_STAGE_COUNT
+} LogoStage;
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
 //----------------------------------------------------------------------------------
-static int framesCounter = 0;
+// NOTE: Stage durations match the original 60 fps frame counts (80, 30, 30, 10*12, 200 and 50 frames)
+static const float logoStageDurations[LOGO_STAGE_COUNT] = { 80.0f/60.0f, 30.0f/60.0f, 30.0f/60.0f, 2.0f, 200.0f/60.0f, 50.0f/60.0f };
+static const float logoLetterTime = 0.2f;           // Time between "raylib" letters (seconds)
+static const float logoBlinkTime = 10.0f/60.0f;     // Corner blink half period (seconds)
+static const float logoPoweredByDelay = 20.0f/60.0f;    // Time from letters end to "powered by" shown (seconds)
+
+static Timeline timeline = { 0 };
 static int finishScreen = 0;
 
+static bool blinkVisible = false;
+static bool poweredByVisible = false;
+
 static int logoPositionX = 0;
 static int logoPositionY = 0;
 
@@ -43,7 +68,7 @@ static int leftSideRecHeight = 0;
 static int bottomSideRecWidth = 0;
 static int rightSideRecHeight = 0;
 
-static int state = 0;              // Logo animation states
+static int state = 0;              // Logo animation draw states (LOGO_STAGE_LETTERS and later are drawn the same)
 static float alpha = 1.0f;         // Useful for fading
 
 //----------------------------------------------------------------------------------
@@ -54,8 +79,10 @@ static float alpha = 1.0f;         // Useful for fading
 void InitLogoScreen(void)
 {
     finishScreen = 0;
-    framesCounter = 0;
+    timeline = CreateTimeline(logoStageDurations, LOGO_STAGE_COUNT);
     lettersCount = 0;
+    blinkVisible = false;
+    poweredByVisible = false;
 
     logoPositionX = GetScreenWidth()/2 - 128;
     logoPositionY = GetScreenHeight()/2 - 128;
@@ -70,57 +97,39 @@ void InitLogoScreen(void)
 }
 
 // Logo Screen Update logic
+// NOTE: Animation values are computed from the timeline, so they look the same at any frame rate
 void UpdateLogoScreen(void)
 {
-    if (state == 0)                 // State 0: Top-left square corner blink logic
-    {
-        framesCounter++;
+    UpdateTimeline(&timeline, frameDeltaTime);
 
-        if (framesCounter == 80)
-        {
-            state = 1;
-            framesCounter = 0;      // Reset counter... will be used later...
-        }
-    }
-    else if (state == 1)            // State 1: Bars animation logic: top and left
-    {
-        topSideRecWidth += 8;
-        leftSideRecHeight += 8;
+    const int stage = timeline.stage;
+    const float progress = GetTimelineProgress(timeline);
 
-        if (topSideRecWidth == 256) state = 2;
-    }
-    else if (state == 2)            // State 2: Bars animation logic: bottom and right
-    {
-        bottomSideRecWidth += 8;
-        rightSideRecHeight += 8;
+    state = (stage < LOGO_STAGE_LETTERS)? stage : LOGO_STAGE_LETTERS;
 
-        if (bottomSideRecWidth == 256) state = 3;
-    }
-    else if (state == 3)            // State 3: "raylib" text-write animation logic
+    // State 0: Top-left square corner blink logic
+    blinkVisible = (stage == LOGO_STAGE_BLINK) && ((int)(timeline.stageTime/logoBlinkTime)%2);
+
+    // State 1 and 2: Bars animation logic, bars grow from 16 to 256
+    if (stage == LOGO_STAGE_TOP_LEFT) topSideRecWidth = 16 + (int)(240*progress);
+    else if (stage > LOGO_STAGE_TOP_LEFT) topSideRecWidth = 256;
+    leftSideRecHeight = topSideRecWidth;
+
+    if (stage == LOGO_STAGE_BOTTOM_RIGHT) bottomSideRecWidth = 16 + (int)(240*progress);
+    else if (stage > LOGO_STAGE_BOTTOM_RIGHT) bottomSideRecWidth = 256;
+    rightSideRecHeight = bottomSideRecWidth;
+
+    // State 3: "raylib" text-write animation logic, then hold and fade out everything
+    if (stage == LOGO_STAGE_LETTERS) lettersCount = (int)(timeline.stageTime/logoLetterTime);
+    else if (stage > LOGO_STAGE_LETTERS) lettersCount = 10;
+
+    poweredByVisible = ((stage == LOGO_STAGE_HOLD) && (timeline.stageTime > logoPoweredByDelay)) || (stage > LOGO_STAGE_HOLD);
+
+    if (stage == LOGO_STAGE_FADE) alpha = 1.0f - progress;
+    else if (IsTimelineFinished(timeline))
     {
-        framesCounter++;
-
-        if (lettersCount < 10)
-        {
-            if (framesCounter/12)   // Every 12 frames, one more letter!
-            {
-                lettersCount++;
-                framesCounter = 0;
-            }
-        }
-        else    // When all letters have appeared, just fade out everything
-        {
-            if (framesCounter > 200)
-            {
-                alpha -= 0.02f;
-
-                if (alpha <= 0.0f)
-                {
-                    alpha = 0.0f;
-                    finishScreen = 1;   // Jump to next screen
-                }
-            }
-        }
+        alpha = 0.0f;
+        finishScreen = 1;   // Jump to next screen
     }
 }
 
@@ -129,7 +138,7 @@ void DrawLogoScreen(void)
 {
     if (state == 0)         // Draw blinking top-left square corner
     {
-        if ((framesCounter/10)%2) DrawRectangle(logoPositionX, logoPositionY, 16, 16, BLACK);
+        if (blinkVisible) DrawRectangle(logoPositionX, logoPositionY, 16, 16, BLACK);
     }
     else if (state == 1)    // Draw bars animation: top and left
     {
@@ -156,8 +165,15 @@ void DrawLogoScreen(void)
 
         DrawText(TextSubtext("raylib", 0, lettersCount), GetScreenWidth()/2 - 44, GetScreenHeight()/2 + 48, 50, Fade(BLACK, alpha));
 
-        if (framesCounter > 20) DrawText("powered by", logoPositionX, logoPositionY - 27, 20, Fade(DARKGRAY, alpha));
+        if (poweredByVisible) DrawText("powered by", logoPositionX, logoPositionY - 27, 20, Fade(DARKGRAY, alpha));
     }
+
+    // Draw startup assets loading progress bar, under the logo
+    // NOTE: Bar fades with the logo once loading is done, kept visible while still loading
+    const float progress = startupProgress;
+    const float barAlpha = (progress < 1.0f)? 1.0f : alpha;
+    DrawRectangle(logoPositionX, logoPositionY + 280, (int)(256*progress), 8, Fade(LIGHTGRAY, barAlpha));
+    DrawRectangleLines(logoPositionX, logoPositionY + 280, 256, 8, Fade(GRAY, barAlpha));
 }
 
 // Logo Screen Unload logic
@@ -167,7 +183,8 @@ void UnloadLogoScreen(void)
 }
 
 // Logo Screen should finish?
+// NOTE: Logo screen is kept (faded out) until startup assets are loaded
 int FinishLogoScreen(void)
 {
-    return finishScreen;
+    return (finishScreen && (startupProgress >= 1.0f));
 }
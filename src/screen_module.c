@@ -0,0 +1,54 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Screens module
+*
+*   Screens functions table, the screens code as seen by the host. On hot reload builds the
+*   screens are built into a shared library exporting GetScreensModule(), so the host can load
+*   a rebuilt library while the game runs; otherwise it is linked statically.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "screens.h"
+
+#include <stddef.h>     // Required for: NULL
+
+#if defined(HOT_RELOAD) && defined(__GNUC__)
+    #define SCREENS_EXPORT __attribute__((visibility("default")))
+#else
+    #define SCREENS_EXPORT
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+
+// Screens registered by GameScreen
+static const ScreenFunctions screens[] = {
+    [LOGO] = { NULL, InitLogoScreen, UpdateLogoScreen, DrawLogoScreen, NULL, UnloadLogoScreen, FinishLogoScreen, GAMEPLAY, "logo", false },
+    [GAMEPLAY] = { PreloadGameplayScreen, InitGameplayScreen, UpdateGameplayScreen, DrawGameplayScreen, IsGameplayScreenDirty, UnloadGameplayScreen, FinishGameplayScreen, ENDING, "gameplay", true },
+    [ENDING] = { NULL, InitEndingScreen, UpdateEndingScreen, DrawEndingScreen, IsEndingScreenDirty, UnloadEndingScreen, FinishEndingScreen, GAMEPLAY, "ending", false },
+    [FORECOURT] = { PreloadGameplayScreen, InitForecourtScreen, UpdateForecourtScreen, DrawForecourtScreen, NULL, UnloadForecourtScreen, FinishForecourtScreen, GAMEPLAY, "forecourt", false },
+};
+
+//----------------------------------------------------------------------------------
+// Screens Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Get screens module
+// NOTE: Screens data is the gameplay state, other screens keep their state in module variables
+SCREENS_EXPORT const ScreensModule *GetScreensModule(void)
+{
+    static ScreensModule module = { 0 };
+
+    module.version = SCREENS_MODULE_VERSION;
+    module.dataSize = GetGameplayDataSize(&module.dataVersion);
+    module.SetData = SetGameplayData;
+    module.InitData = InitGameplayData;
+    module.screens = screens;
+    module.SetGameplayReplay = SetGameplayReplay;
+    module.SetGameplayResolutionBudget = SetGameplayResolutionBudget;
+    module.SetForecourtPumpCount = SetForecourtPumpCount;
+
+    return &module;
+}
@@ -26,10 +26,58 @@
 #ifndef SCREENS_H
 #define SCREENS_H
 
+#include "audio_mixer.h"    // Required for: MixerSound
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
-typedef enum GameScreen { UNKNOWN = -1, LOGO = 0, GAMEPLAY, ENDING } GameScreen;
+typedef enum GameScreen { UNKNOWN = -1, LOGO = 0, GAMEPLAY, ENDING, FORECOURT } GameScreen;
+#define SCREENS_MODULE_VERSION  2       // Screens module interface version, increase on ScreensModule or ScreenFunctions changes
+
+// Asset types managed by the assets registry
+typedef enum AssetType { ASSET_MODEL = 0, ASSET_SOUND, ASSET_FONT, ASSET_MUSIC } AssetType;
+
+// Asset handle, index into the assets registry
+typedef int AssetHandle;
+#define ASSET_INVALID   -1
+
+// Screen functions table entry
+typedef struct ScreenFunctions {
+    void (*Preload)(void);      // Preload screen assets on CPU side, runs on background thread (optional)
+    void (*Init)(void);
+    void (*Update)(void);
+    void (*Draw)(void);
+    bool (*IsDirty)(void);      // Check if screen view changed since last drawn (optional, always drawn if NULL)
+    void (*Unload)(void);
+    int (*Finish)(void);
+    GameScreen nextScreen;      // Screen to transition to when Finish() returns 1
+    const char *name;           // Profiler section name
+    bool hostData;              // Screen state lives in screens data, kept across module reloads (restarted otherwise)
+} ScreenFunctions;
+
+// Screens module, screens code as seen by the host (shared library on hot reload builds)
+// NOTE: Screens data is owned by the host, initialized by InitData() on first load and kept across module reloads,
+// a module is only reloaded if its data version and size match the loaded one
+typedef struct ScreensModule {
+    int version;                            // SCREENS_MODULE_VERSION the module was built with
+    int dataVersion;                        // Screens data layout version
+    int dataSize;                           // Screens data size (bytes)
+    void (*SetData)(void *data);            // Set screens data, before any screen is initialized
+    void (*InitData)(void);                 // Init screens data to defaults, after first SetData() call
+    const ScreenFunctions *screens;         // Screens functions, by GameScreen
+    bool (*SetGameplayReplay)(const char *fileName);                // Host calls, set by command line options
+    void (*SetGameplayResolutionBudget)(float budget, bool postAA);
+    void (*SetForecourtPumpCount)(int count);
+} ScreensModule;
+
+typedef const ScreensModule *(*GetScreensModuleFunc)(void);
+
+// Memory used by resident assets
+typedef struct AssetMemoryStats {
+    int assetCount;             // Number of resident assets
+    long long cpuBytes;         // Asset data kept on CPU side (mesh arrays, PCM samples, glyphs)
+    long long gpuBytes;         // Asset data uploaded to GPU (vertex buffers, textures)
+} AssetMemoryStats;
 
 //----------------------------------------------------------------------------------
 // Global Variables Declaration (shared by several modules)
@@ -37,14 +85,39 @@ typedef enum GameScreen { UNKNOWN = -1, LOGO = 0, GAMEPLAY, ENDING } GameScreen;
 extern GameScreen currentScreen;
 extern Font font;
 extern Music music;
-extern Sound fxCoin;
-extern Sound fxError;
+extern MixerSound fxCoin;
+extern MixerSound fxError;
+extern float startupProgress;       // Startup assets loading progress [0.0f..1.0f]
+extern float frameDeltaTime;        // Time since previous frame update (seconds), use instead of GetFrameTime(), frames are not always drawn
 extern int rounds;
 
 #ifdef __cplusplus
 extern "C" {            // Prevents name mangling of functions
 #endif
 
+//----------------------------------------------------------------------------------
+// Assets Functions Declaration
+//----------------------------------------------------------------------------------
+AssetHandle AcquireAsset(AssetType type, const char *fileName);     // Acquire asset reference, loading it if not resident yet
+AssetHandle RequestAsset(AssetType type, const char *fileName);     // Request asset reference, loaded asynchronously by loader threads
+int UpdateAssetLoading(float timeBudget);                           // Update asynchronous loading, uploads decoded assets until time budget (seconds) is spent
+void WaitAssetLoading(void);                                        // Wait for all requested assets to be loaded, finishing them synchronously
+float GetAssetLoadingProgress(void);                                // Get asynchronous loading progress [0.0f..1.0f], 1.0f when nothing is loading
+bool IsAssetReady(AssetHandle handle);                              // Check if asset is loaded and its data available (false if loading or failed)
+bool PreloadAsset(AssetType type, const char *fileName);            // Preload asset data on CPU side, can be called from any thread
+void ReleaseAsset(AssetHandle handle);                              // Release asset reference, asset is unloaded when no references are left
+Model GetAssetModel(AssetHandle handle);                            // Get model from asset handle
+MixerSound GetAssetSound(AssetHandle handle);                       // Get mixer sound from asset handle
+Font GetAssetFont(AssetHandle handle);                              // Get font from asset handle
+Music GetAssetMusic(AssetHandle handle);                            // Get music stream from asset handle
+void UnloadAssets(void);                                            // Unload all resident assets, regardless of their references
+AssetMemoryStats GetAssetMemoryStats(void);                         // Get memory currently used by resident assets
+
+//----------------------------------------------------------------------------------
+// Screens Module Functions Declaration
+//----------------------------------------------------------------------------------
+const ScreensModule *GetScreensModule(void);    // Get screens module (exported by screens library on hot reload builds)
+
 //----------------------------------------------------------------------------------
 // Logo Screen Functions Declaration
 //----------------------------------------------------------------------------------
@@ -57,11 +130,19 @@ int FinishLogoScreen(void);
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Declaration
 //----------------------------------------------------------------------------------
+void PreloadGameplayScreen(void);       // Preload gameplay assets on CPU side (background thread, no GPU calls)
 void InitGameplayScreen(void);
 void UpdateGameplayScreen(void);
 void DrawGameplayScreen(void);
+bool IsGameplayScreenDirty(void);       // Check if screen view changed since last drawn
 void UnloadGameplayScreen(void);
 int FinishGameplayScreen(void);
+float GetGameplayStopLatency(void);     // Get time from trigger release to the stop being processed on last round (seconds)
+bool SetGameplayReplay(const char *fileName);   // Set replay file to be played back by next gameplay session
+void SetGameplayResolutionBudget(float budget, bool postAA);    // Set GPU frame time budget (milliseconds) 3D pass resolution is scaled to, 0 keeps native
+int GetGameplayDataSize(int *version);  // Get gameplay state size (bytes) and layout version, stored by the host on hot reload builds
+void SetGameplayData(void *data);       // Set gameplay state storage, owned by the host (hot reload builds only)
+void InitGameplayData(void);            // Init gameplay state storage to defaults, after first SetGameplayData()
 
 //----------------------------------------------------------------------------------
 // Ending Screen Functions Declaration
@@ -69,9 +150,20 @@ int FinishGameplayScreen(void);
 void InitEndingScreen(void);
 void UpdateEndingScreen(void);
 void DrawEndingScreen(void);
+bool IsEndingScreenDirty(void);         // Check if screen view changed since last drawn
 void UnloadEndingScreen(void);
 int FinishEndingScreen(void);
 
+//----------------------------------------------------------------------------------
+// Forecourt Screen Functions Declaration
+//----------------------------------------------------------------------------------
+void SetForecourtPumpCount(int count);  // Set pumps count of next forecourt
+void InitForecourtScreen(void);
+void UpdateForecourtScreen(void);
+void DrawForecourtScreen(void);
+void UnloadForecourtScreen(void);
+int FinishForecourtScreen(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,394 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - SDF fonts
+*
+*   Signed distance field generation from image fonts, .sdf files and SDF text shader.
+*
+*   Image font glyphs are made of whole pixels, so distances are computed exactly: every atlas
+*   sample measures its distance to the nearest pixel square on the other side of the outline.
+*   Atlas value 0.5 is the outline, higher is inside, SDF_FONT_SPREAD maps to 0.0 and 1.0.
+*
+*   SDF font file layout (.sdf, little-endian):
+*
+*     SdfFontFileHeader       magic "SDF0", version, base size, glyphs count, padding, atlas size
+*     SdfFontFileGlyph        glyphs[glyphCount], codepoint, metrics and atlas rectangle
+*     unsigned char           atlas[atlasWidth*atlasHeight]
+*
+*   NOTE: Font metrics are in atlas pixels (base size is the glyphs height times the samples
+*   per font pixel), so raylib text functions scale glyphs as for any other font
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "rlgl.h"       // Required for: rlGetVersion(), rlGetShaderIdDefault()
+#include "sdf_font.h"
+
+#include <stdlib.h>     // Required for: malloc(), calloc(), free()
+#include <string.h>     // Required for: memcpy(), memcmp()
+#include <math.h>       // Required for: sqrtf(), fmaxf(), floorf(), ceilf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SDF_FONT_FILE_VERSION       1       // Increase when generation changes to invalidate baked fonts
+#define SDF_FONT_ATLAS_WIDTH        1024    // Glyphs are packed in rows, atlas height fits the rows used
+#define MAX_SDF_FONT_GLYPHS         256
+
+// NOTE: Body is shared by every GLSL version, prefixes define IN, TEXTURE, OUTPUT and WIDTH.
+// Outline is antialiased over the distance change between neighbour fragments, so edges stay one
+// pixel wide at any scale
+#define FONT_SDF_FS_BODY \
+    "IN vec2 fragTexCoord;\n" \
+    "IN vec4 fragColor;\n" \
+    "uniform sampler2D texture0;\n" \
+    "void main()\n" \
+    "{\n" \
+    "    float dist = TEXTURE(texture0, fragTexCoord).r - 0.5;\n" \
+    "    float width = max(WIDTH(dist), 0.001);\n" \
+    "    float alpha = smoothstep(-width, width, dist);\n" \
+    "    OUTPUT = vec4(fragColor.rgb, fragColor.a*alpha);\n" \
+    "}\n"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// SDF font file header
+typedef struct SdfFontFileHeader {
+    char magic[4];
+    unsigned int version;
+    int baseSize;
+    int glyphCount;
+    int glyphPadding;
+    int atlasWidth;
+    int atlasHeight;
+} SdfFontFileHeader;
+
+// SDF font file glyph
+typedef struct SdfFontFileGlyph {
+    int value;
+    int offsetX;
+    int offsetY;
+    int advanceX;
+    float x;                    // Atlas rectangle (pixels)
+    float y;
+    float width;
+    float height;
+} SdfFontFileGlyph;
+
+// Image font glyph pixels, solid if opaque
+typedef struct SdfGlyphSource {
+    const Color *pixels;
+    int stride;
+    Rectangle rec;
+} SdfGlyphSource;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *fontSdfFsCode330 = "#version 330\n#define IN in\n#define TEXTURE texture\n#define WIDTH(d) fwidth(d)\nout vec4 finalColor;\n#define OUTPUT finalColor\n" FONT_SDF_FS_BODY;
+static const char *fontSdfFsCode300es = "#version 300 es\nprecision mediump float;\n#define IN in\n#define TEXTURE texture\n#define WIDTH(d) fwidth(d)\nout vec4 finalColor;\n#define OUTPUT finalColor\n" FONT_SDF_FS_BODY;
+static const char *fontSdfFsCode120 = "#version 120\n#define IN varying\n#define TEXTURE texture2D\n#define WIDTH(d) fwidth(d)\n#define OUTPUT gl_FragColor\n" FONT_SDF_FS_BODY;
+static const char *fontSdfFsCode100 = "#version 100\n#extension GL_OES_standard_derivatives : enable\nprecision mediump float;\n"
+    "#ifdef GL_OES_standard_derivatives\n#define WIDTH(d) fwidth(d)\n#else\n#define WIDTH(d) 0.1\n#endif\n"
+    "#define IN varying\n#define TEXTURE texture2D\n#define OUTPUT gl_FragColor\n" FONT_SDF_FS_BODY;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static bool IsGlyphPixelSolid(SdfGlyphSource glyph, int x, int y);     // Check if glyph pixel is solid, pixels outside glyph are empty
+static unsigned char GetGlyphDistance(SdfGlyphSource glyph, float x, float y);  // Get encoded signed distance to glyph outline at position (font pixels)
+static bool IsKeyColor(Color color, Color key);                         // Check if color is image font key color
+
+//----------------------------------------------------------------------------------
+// SDF Font Functions Definition
+//----------------------------------------------------------------------------------
+
+// Generate SDF font from image font (CPU only), atlas returned apart, font texture is not loaded
+// NOTE: Glyphs are separated as LoadFontFromImage() does: key color around every glyph, the first
+// glyph pixel gives glyphs and lines spacing, glyphs go in codepoint order from firstChar
+Font GenFontSdfFromImage(Image image, Color key, int firstChar, Image *atlas)
+{
+    Font font = { 0 };
+    *atlas = (Image){ 0 };
+
+    Image source = ImageCopy(image);
+    ImageFormat(&source, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    const Color *pixels = (const Color *)source.data;
+    const int width = source.width;
+    const int height = source.height;
+    int charSpacing = 0;
+    int lineSpacing = 0;
+    bool found = false;
+
+    for (int y = 0; (y < height) && !found; y++)
+    {
+        for (int x = 0; (x < width) && !found; x++)
+        {
+            if (!IsKeyColor(pixels[y*width + x], key))
+            {
+                charSpacing = x;
+                lineSpacing = y;
+                found = true;
+            }
+        }
+    }
+
+    if (!found || (charSpacing == 0) || (lineSpacing == 0))
+    {
+        TraceLog(LOG_WARNING, "FONT: SDF source image is not an image font (no key color separation)");
+        UnloadImage(source);
+        return font;
+    }
+
+    int charHeight = 0;
+    while ((lineSpacing + charHeight < height) && !IsKeyColor(pixels[(lineSpacing + charHeight)*width + charSpacing], key)) charHeight++;
+
+    // Glyph rectangles in source image
+    Rectangle sourceRecs[MAX_SDF_FONT_GLYPHS] = { 0 };
+    int glyphCount = 0;
+
+    for (int lineY = lineSpacing; (lineY + charHeight <= height) && (glyphCount < MAX_SDF_FONT_GLYPHS); lineY += charHeight + lineSpacing)
+    {
+        int x = charSpacing;
+
+        while ((x < width) && !IsKeyColor(pixels[lineY*width + x], key) && (glyphCount < MAX_SDF_FONT_GLYPHS))
+        {
+            int charWidth = 0;
+            while ((x + charWidth < width) && !IsKeyColor(pixels[lineY*width + x + charWidth], key)) charWidth++;
+
+            sourceRecs[glyphCount++] = (Rectangle){ (float)x, (float)lineY, (float)charWidth, (float)charHeight };
+            x += charWidth + charSpacing;
+        }
+    }
+
+    // Atlas layout, glyphs in rows with padding around every glyph for the distance spread
+    const int padding = (int)ceilf(SDF_FONT_SPREAD*SDF_FONT_SAMPLES);
+    const int cellHeight = charHeight*SDF_FONT_SAMPLES + 2*padding;
+    int atlasHeight = cellHeight;
+    int cellX = 0;
+
+    font.baseSize = charHeight*SDF_FONT_SAMPLES;
+    font.glyphCount = glyphCount;
+    font.glyphPadding = padding;
+    font.recs = (Rectangle *)RL_CALLOC(glyphCount, sizeof(Rectangle));
+    font.glyphs = (GlyphInfo *)RL_CALLOC(glyphCount, sizeof(GlyphInfo));
+
+    for (int i = 0; i < glyphCount; i++)
+    {
+        const int cellWidth = (int)sourceRecs[i].width*SDF_FONT_SAMPLES + 2*padding;
+
+        if (cellX + cellWidth > SDF_FONT_ATLAS_WIDTH)
+        {
+            cellX = 0;
+            atlasHeight += cellHeight;
+        }
+
+        font.recs[i] = (Rectangle){ (float)(cellX + padding), (float)(atlasHeight - cellHeight + padding), sourceRecs[i].width*SDF_FONT_SAMPLES, (float)(charHeight*SDF_FONT_SAMPLES) };
+        font.glyphs[i].value = firstChar + i;
+        cellX += cellWidth;
+    }
+
+    *atlas = GenImageColor(SDF_FONT_ATLAS_WIDTH, atlasHeight, BLACK);
+    ImageFormat(atlas, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+    unsigned char *distances = (unsigned char *)atlas->data;
+
+    for (int i = 0; i < glyphCount; i++)
+    {
+        const SdfGlyphSource glyph = { pixels, width, sourceRecs[i] };
+        const int cellLeft = (int)font.recs[i].x - padding;
+        const int cellTop = (int)font.recs[i].y - padding;
+        const int cellWidth = (int)font.recs[i].width + 2*padding;
+
+        for (int y = 0; y < cellHeight; y++)
+        {
+            for (int x = 0; x < cellWidth; x++)
+            {
+                // Sample at atlas pixel center, in glyph font pixels
+                const float fontX = ((float)(x - padding) + 0.5f)/SDF_FONT_SAMPLES;
+                const float fontY = ((float)(y - padding) + 0.5f)/SDF_FONT_SAMPLES;
+
+                distances[(cellTop + y)*SDF_FONT_ATLAS_WIDTH + cellLeft + x] = GetGlyphDistance(glyph, fontX, fontY);
+            }
+        }
+    }
+
+    UnloadImage(source);
+
+    TraceLog(LOG_INFO, "FONT: SDF font generated: %i glyphs, atlas %ix%i", glyphCount, atlas->width, atlas->height);
+
+    return font;
+}
+
+// Export SDF font glyphs and atlas to binary file (.sdf)
+bool ExportFontSdf(Font font, Image atlas, const char *fileName)
+{
+    if ((font.glyphCount <= 0) || (atlas.data == NULL) || (atlas.format != PIXELFORMAT_UNCOMPRESSED_GRAYSCALE)) return false;
+
+    SdfFontFileHeader header = { 0 };
+    memcpy(header.magic, "SDF0", 4);
+    header.version = SDF_FONT_FILE_VERSION;
+    header.baseSize = font.baseSize;
+    header.glyphCount = font.glyphCount;
+    header.glyphPadding = font.glyphPadding;
+    header.atlasWidth = atlas.width;
+    header.atlasHeight = atlas.height;
+
+    const unsigned int glyphsOffset = sizeof(SdfFontFileHeader);
+    const unsigned int atlasOffset = glyphsOffset + font.glyphCount*sizeof(SdfFontFileGlyph);
+    const unsigned int dataSize = atlasOffset + atlas.width*atlas.height;
+    unsigned char *data = (unsigned char *)RL_CALLOC(dataSize, 1);
+
+    memcpy(data, &header, sizeof(SdfFontFileHeader));
+
+    for (int i = 0; i < font.glyphCount; i++)
+    {
+        const SdfFontFileGlyph glyph = { font.glyphs[i].value, font.glyphs[i].offsetX, font.glyphs[i].offsetY, font.glyphs[i].advanceX,
+            font.recs[i].x, font.recs[i].y, font.recs[i].width, font.recs[i].height };
+        memcpy(data + glyphsOffset + i*sizeof(SdfFontFileGlyph), &glyph, sizeof(SdfFontFileGlyph));
+    }
+
+    memcpy(data + atlasOffset, atlas.data, atlas.width*atlas.height);
+
+    bool success = SaveFileData(fileName, data, dataSize);
+    RL_FREE(data);
+
+    return success;
+}
+
+// Load SDF font from binary file data (CPU only), atlas returned apart
+Font LoadFontSdfFromMemory(const unsigned char *fileData, int dataSize, Image *atlas)
+{
+    Font font = { 0 };
+    *atlas = (Image){ 0 };
+
+    SdfFontFileHeader header = { 0 };
+    if ((fileData != NULL) && (dataSize >= (int)sizeof(SdfFontFileHeader))) memcpy(&header, fileData, sizeof(SdfFontFileHeader));
+
+    const long long glyphsOffset = sizeof(SdfFontFileHeader);
+    const long long atlasOffset = glyphsOffset + (long long)header.glyphCount*sizeof(SdfFontFileGlyph);
+    const bool valid = (memcmp(header.magic, "SDF0", 4) == 0) && (header.version == SDF_FONT_FILE_VERSION) &&
+        (header.glyphCount > 0) && (header.glyphCount <= MAX_SDF_FONT_GLYPHS) && (header.atlasWidth > 0) && (header.atlasHeight > 0) &&
+        (atlasOffset + (long long)header.atlasWidth*header.atlasHeight <= dataSize);
+
+    if (!valid)
+    {
+        TraceLog(LOG_WARNING, "FONT: SDF font data is outdated or invalid");
+        return font;
+    }
+
+    font.baseSize = header.baseSize;
+    font.glyphCount = header.glyphCount;
+    font.glyphPadding = header.glyphPadding;
+    font.recs = (Rectangle *)RL_CALLOC(font.glyphCount, sizeof(Rectangle));
+    font.glyphs = (GlyphInfo *)RL_CALLOC(font.glyphCount, sizeof(GlyphInfo));
+
+    for (int i = 0; i < font.glyphCount; i++)
+    {
+        SdfFontFileGlyph glyph = { 0 };
+        memcpy(&glyph, fileData + glyphsOffset + i*sizeof(SdfFontFileGlyph), sizeof(SdfFontFileGlyph));
+
+        font.glyphs[i].value = glyph.value;
+        font.glyphs[i].offsetX = glyph.offsetX;
+        font.glyphs[i].offsetY = glyph.offsetY;
+        font.glyphs[i].advanceX = glyph.advanceX;
+        font.recs[i] = (Rectangle){ glyph.x, glyph.y, glyph.width, glyph.height };
+    }
+
+    atlas->width = header.atlasWidth;
+    atlas->height = header.atlasHeight;
+    atlas->mipmaps = 1;
+    atlas->format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+    atlas->data = RL_MALLOC(header.atlasWidth*header.atlasHeight);
+    memcpy(atlas->data, fileData + atlasOffset, header.atlasWidth*header.atlasHeight);
+
+    return font;
+}
+
+// Upload SDF atlas as font texture (bilinear filtered), atlas is not unloaded
+void UploadFontSdf(Font *font, Image atlas)
+{
+    font->texture = LoadTextureFromImage(atlas);
+    SetTextureFilter(font->texture, TEXTURE_FILTER_BILINEAR);
+}
+
+// Check if font is a SDF font (single channel atlas)
+// NOTE: Image fonts and raylib default font are loaded with alpha, only SDF atlases are single channel
+bool IsFontSdf(Font font)
+{
+    return (font.texture.id > 0) && (font.texture.format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+}
+
+// Load SDF text shader (call after window initialization)
+// NOTE: Shader uses raylib default vertex shader, returns an empty shader if compilation failed
+Shader LoadFontSdfShader(void)
+{
+    Shader shader = { 0 };
+
+    switch (rlGetVersion())
+    {
+        case RL_OPENGL_21: shader = LoadShaderFromMemory(NULL, fontSdfFsCode120); break;
+        case RL_OPENGL_ES_20: shader = LoadShaderFromMemory(NULL, fontSdfFsCode100); break;
+        case RL_OPENGL_ES_30: shader = LoadShaderFromMemory(NULL, fontSdfFsCode300es); break;
+        default: shader = LoadShaderFromMemory(NULL, fontSdfFsCode330); break;
+    }
+
+    // NOTE: On compilation failure default shader is returned, it must not be unloaded
+    if (!IsShaderReady(shader) || (shader.id == rlGetShaderIdDefault()))
+    {
+        TraceLog(LOG_WARNING, "FONT: Failed to load SDF text shader");
+        shader = (Shader){ 0 };
+    }
+
+    return shader;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Check if glyph pixel is solid, pixels outside glyph are empty
+static bool IsGlyphPixelSolid(SdfGlyphSource glyph, int x, int y)
+{
+    if ((x < 0) || (y < 0) || (x >= (int)glyph.rec.width) || (y >= (int)glyph.rec.height)) return false;
+
+    return (glyph.pixels[((int)glyph.rec.y + y)*glyph.stride + (int)glyph.rec.x + x].a > 127);
+}
+
+// Get encoded signed distance to glyph outline at position (font pixels)
+// NOTE: Distance to the outline is the distance to the nearest pixel square of the other state
+static unsigned char GetGlyphDistance(SdfGlyphSource glyph, float x, float y)
+{
+    const int pixelX = (int)floorf(x);
+    const int pixelY = (int)floorf(y);
+    const int radius = (int)ceilf(SDF_FONT_SPREAD) + 1;
+    const bool inside = IsGlyphPixelSolid(glyph, pixelX, pixelY);
+    float distance = SDF_FONT_SPREAD;
+
+    for (int j = pixelY - radius; j <= pixelY + radius; j++)
+    {
+        for (int i = pixelX - radius; i <= pixelX + radius; i++)
+        {
+            if (IsGlyphPixelSolid(glyph, i, j) == inside) continue;
+
+            const float dx = fmaxf(fmaxf((float)i - x, x - (float)(i + 1)), 0.0f);
+            const float dy = fmaxf(fmaxf((float)j - y, y - (float)(j + 1)), 0.0f);
+            const float d = sqrtf(dx*dx + dy*dy);
+
+            if (d < distance) distance = d;
+        }
+    }
+
+    float value = 0.5f + (inside? distance : -distance)/(2.0f*SDF_FONT_SPREAD);
+    if (value < 0.0f) value = 0.0f;
+    else if (value > 1.0f) value = 1.0f;
+
+    return (unsigned char)(value*255.0f + 0.5f);
+}
+
+// Check if color is image font key color
+static bool IsKeyColor(Color color, Color key)
+{
+    return (color.r == key.r) && (color.g == key.g) && (color.b == key.b) && (color.a == key.a);
+}
@@ -0,0 +1,42 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - SDF fonts
+*
+*   Signed distance field fonts generated from raylib image fonts (glyphs separated by a key
+*   color, i.e. mecha.png). Every font pixel is sampled several times and its distance to the
+*   glyph outline stored in a single channel atlas, so text drawn with the SDF shader keeps
+*   sharp edges at any size. Atlases are baked at build time (.sdf, packed in the assets
+*   archive) and are usable as regular raylib fonts (DrawTextEx(), MeasureTextEx()).
+*
+**********************************************************************************************/
+
+#ifndef SDF_FONT_H
+#define SDF_FONT_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SDF_FONT_SAMPLES        4           // Atlas pixels per font pixel
+#define SDF_FONT_SPREAD         1.0f        // Distance range encoded around outlines (font pixels)
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// SDF Font Functions Declaration
+//----------------------------------------------------------------------------------
+Font GenFontSdfFromImage(Image image, Color key, int firstChar, Image *atlas);  // Generate SDF font from image font (CPU only), atlas returned apart, font texture is not loaded
+bool ExportFontSdf(Font font, Image atlas, const char *fileName);              // Export SDF font glyphs and atlas to binary file (.sdf)
+Font LoadFontSdfFromMemory(const unsigned char *fileData, int dataSize, Image *atlas);  // Load SDF font from binary file data (CPU only), atlas returned apart
+void UploadFontSdf(Font *font, Image atlas);                // Upload SDF atlas as font texture (bilinear filtered), atlas is not unloaded
+bool IsFontSdf(Font font);                                  // Check if font is a SDF font (single channel atlas)
+Shader LoadFontSdfShader(void);                             // Load SDF text shader (call after window initialization)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SDF_FONT_H
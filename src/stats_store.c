@@ -0,0 +1,755 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Statistics store
+*
+*   In memory summary, append-only log and background compaction into the index file.
+*
+*   Every record carries a sequence number, the index stores the last one it includes, so a
+*   log left behind by an interrupted compaction (index written, log not truncated yet) is not
+*   applied twice. Records are applied to the summary when added, the writer only persists them.
+*
+*   NOTE: Render thread only takes the store mutex to apply and copy records, never for file I/O
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "stats_store.h"
+#include "threads.h"    // Required for: StartThread(), LoadMutex(), LoadCondition()
+
+#include <stdio.h>      // Required for: FILE, fopen(), fread(), fwrite(), remove(), rename()
+#include <stdlib.h>     // Required for: malloc(), free()
+#include <string.h>     // Required for: memcpy(), memcmp(), memmove()
+#include <math.h>       // Required for: fabsf()
+#include <time.h>       // Required for: time(), localtime()
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/emscripten.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define STATS_RECORD_SIZE           32          // Log record size (bytes)
+#define STATS_TOP_SESSION_SIZE      20          // Index top session record size (bytes)
+#define STATS_DAY_SIZE              28          // Index day record size (bytes)
+#define STATS_INDEX_HEADER_SIZE     28
+#define MAX_STATS_INDEX_SIZE        (STATS_INDEX_HEADER_SIZE + MAX_STATS_TOP_SESSIONS*STATS_TOP_SESSION_SIZE + MAX_STATS_DAYS*STATS_DAY_SIZE)
+#define MAX_STATS_PENDING           256         // Records waiting to be written
+#define STATS_COMPACT_RECORDS       64          // Log records compacted into the index once reached
+
+#if defined(PLATFORM_WEB)
+    #define STATS_DIRECTORY         "/stats/"   // IndexedDB backed directory (IDBFS)
+#else
+    #define STATS_DIRECTORY         ""
+#endif
+#define STATS_LOG_FILE              STATS_DIRECTORY "stats.log"
+#define STATS_INDEX_FILE            STATS_DIRECTORY "stats.idx"
+#define STATS_INDEX_TEMP_FILE       STATS_DIRECTORY "stats.idx.tmp"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Log record type
+typedef enum StatsRecordType {
+    STATS_RECORD_ROUND = 1,
+    STATS_RECORD_SESSION,
+} StatsRecordType;
+
+// Log record
+typedef struct StatsRecord {
+    unsigned int sequence;      // Record number, first is 1
+    int type;
+    bool hit;
+    int round;                  // Round number, rounds survived for session records
+    int day;                    // YYYYMMDD (local time)
+    float values[4];            // Round: target price, stop price, pump time, stop latency. Session: score
+} StatsRecord;
+
+// Statistics summary, persisted as the index file
+typedef struct StatsSummary {
+    unsigned int lastSequence;  // Last record applied
+    int sessionCount;
+    int roundCount;
+    int currentHits;            // Session not ended yet
+    float currentBestDelta;     // Negative if no round yet
+    StatsSession top[MAX_STATS_TOP_SESSIONS];   // Most rounds first
+    int topCount;
+    StatsDay days[MAX_STATS_DAYS];              // Sorted by day
+    int dayCount;
+} StatsSummary;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static bool storeReady = false;
+static bool storeLoaded = false;                // Files loaded into the summary
+static Mutex *statsMutex = NULL;                // Summary and pending records
+static Condition *statsPending = NULL;          // Signaled when records are queued or on shutdown
+static StatsSummary summary = { 0 };
+static StatsRecord pending[MAX_STATS_PENDING] = { 0 };
+static int pendingCount = 0;
+
+static Thread *writerThread = NULL;             // Writer thread, NULL if not available
+static bool writerShutdown = false;
+static int logRecords = 0;                      // Writer side, records in log since last compaction
+static bool compactNeeded = false;              // Writer side, log has invalid data to be dropped
+
+#if defined(PLATFORM_WEB)
+static bool filesChanged = false;               // Files written since last IndexedDB synchronization
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static void StatsWriterThread(void *userData);                              // Load files, then write records until shutdown
+static void LoadStatsStore(void);                                           // Load files into summary, records added meanwhile are applied on top
+static void WritePendingRecords(int compactRecords);                        // Append pending records to log, compacting it once it has enough records
+static void CompactStatsLog(void);                                          // Write summary to index file and truncate log
+static void AddStatsRecord(StatsRecord record);                             // Apply record to summary and queue it to be written
+static void ApplyStatsRecord(StatsSummary *stats, const StatsRecord *record);   // Apply record to summary
+static StatsDay *GetSummaryDay(StatsSummary *stats, int day);               // Get day totals, inserted if not found (NULL if older than all days kept)
+static int FindSummaryDay(const StatsSummary *stats, int day);              // Find first day index not before day (binary search)
+static unsigned char *LoadStatsFileData(const char *fileName, int *dataSize);   // Load file data (memory must be freed)
+static bool LoadStatsIndex(StatsSummary *stats, const unsigned char *data, int dataSize);  // Load summary from index file data
+static int ExportStatsIndex(const StatsSummary *stats, unsigned char *data);   // Export summary to index file data, returns size
+static void WriteStatsRecord(unsigned char *buffer, const StatsRecord *record);    // Write log record
+static bool ReadStatsRecord(const unsigned char *buffer, StatsRecord *record);     // Read log record, false if corrupted
+static unsigned int GetStatsChecksum(const unsigned char *data, int size);  // Compute FNV-1a checksum
+static void WriteUInt(unsigned char *buffer, unsigned int value);           // Write unsigned int as little-endian bytes
+static unsigned int ReadUInt(const unsigned char *buffer);                  // Read unsigned int from little-endian bytes
+static void WriteFloat(unsigned char *buffer, float value);                 // Write float as little-endian bytes
+static float ReadFloat(const unsigned char *buffer);                        // Read float from little-endian bytes
+
+//----------------------------------------------------------------------------------
+// Statistics Store Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load statistics and start writer thread
+// NOTE: Files are loaded by the writer thread (or next updates without it), queries return
+// only records added this session until then
+bool InitStatsStore(void)
+{
+    if (storeReady) return true;
+
+    statsMutex = LoadMutex();
+    statsPending = LoadCondition();
+    summary = (StatsSummary){ 0 };
+    summary.currentBestDelta = -1.0f;
+    pendingCount = 0;
+    storeLoaded = false;
+    writerShutdown = false;
+    logRecords = 0;
+    compactNeeded = false;
+    storeReady = true;
+
+#if defined(PLATFORM_WEB)
+    // NOTE: IndexedDB content is copied into the directory asynchronously, checked by UpdateStatsStore()
+    filesChanged = false;
+    EM_ASM({
+        Module.statsSynced = 0;
+        Module.statsSyncing = 0;
+        try { FS.mkdir('/stats'); } catch (e) {}
+        FS.mount(IDBFS, {}, '/stats');
+        FS.syncfs(true, function(err) { Module.statsSynced = 1; });
+    });
+#else
+    writerThread = StartThread(StatsWriterThread, NULL);
+    if (writerThread == NULL) TraceLog(LOG_INFO, "STATS: Writer thread not available, records written on updates");
+#endif
+
+    return true;
+}
+
+// Write pending records and compact log, waits for the writer
+void CloseStatsStore(void)
+{
+    if (!storeReady) return;
+
+    if (writerThread != NULL)
+    {
+        LockMutex(statsMutex);
+        writerShutdown = true;
+        SignalCondition(statsPending);
+        UnlockMutex(statsMutex);
+
+        JoinThread(writerThread);
+        writerThread = NULL;
+    }
+    else if (storeLoaded)
+    {
+        WritePendingRecords(0);
+#if defined(PLATFORM_WEB)
+        EM_ASM({ FS.syncfs(false, function(err) {}); });
+#endif
+    }
+
+    UnloadCondition(statsPending);
+    UnloadMutex(statsMutex);
+    statsPending = NULL;
+    statsMutex = NULL;
+
+    storeReady = false;
+}
+
+// Write pending records without writer thread, synchronizes files on web
+void UpdateStatsStore(void)
+{
+    if (!storeReady || (writerThread != NULL)) return;
+
+    if (!storeLoaded)
+    {
+#if defined(PLATFORM_WEB)
+        if (EM_ASM_INT({ return Module.statsSynced; }) == 0) return;
+#endif
+        LoadStatsStore();
+    }
+
+    if (pendingCount > 0)
+    {
+        WritePendingRecords(STATS_COMPACT_RECORDS);
+#if defined(PLATFORM_WEB)
+        filesChanged = true;
+#endif
+    }
+
+#if defined(PLATFORM_WEB)
+    // NOTE: Only one synchronization in flight, files changed meanwhile are synchronized next
+    if (filesChanged && (EM_ASM_INT({ return Module.statsSyncing; }) == 0))
+    {
+        filesChanged = false;
+        EM_ASM({
+            Module.statsSyncing = 1;
+            FS.syncfs(false, function(err) { Module.statsSyncing = 0; });
+        });
+    }
+#endif
+}
+
+// Add round result to current session
+void AddStatsRound(StatsRound round)
+{
+    StatsRecord record = { 0 };
+    record.type = STATS_RECORD_ROUND;
+    record.hit = round.hit;
+    record.round = round.round;
+    record.values[0] = round.targetPrice;
+    record.values[1] = round.stopPrice;
+    record.values[2] = round.pumpTime;
+    record.values[3] = round.stopLatency;
+
+    AddStatsRecord(record);
+}
+
+// End current session, adding it to high scores
+void EndStatsSession(int rounds, float score)
+{
+    StatsRecord record = { 0 };
+    record.type = STATS_RECORD_SESSION;
+    record.round = rounds;
+    record.values[0] = score;
+
+    AddStatsRecord(record);
+}
+
+// Get best sessions (most rounds first), returns number of sessions
+int GetStatsTopSessions(StatsSession *sessions, int count)
+{
+    if (!storeReady) return 0;
+
+    LockMutex(statsMutex);
+
+    if (count > summary.topCount) count = summary.topCount;
+    if (count > 0) memcpy(sessions, summary.top, count*sizeof(StatsSession));
+
+    UnlockMutex(statsMutex);
+
+    return (count > 0)? count : 0;
+}
+
+// Get day totals, false if nothing recorded that day
+bool GetStatsDay(int day, StatsDay *stats)
+{
+    if (!storeReady) return false;
+
+    LockMutex(statsMutex);
+
+    const int index = FindSummaryDay(&summary, day);
+    const bool found = (index < summary.dayCount) && (summary.days[index].day == day);
+    if (found) *stats = summary.days[index];
+
+    UnlockMutex(statsMutex);
+
+    return found;
+}
+
+// Get today date as YYYYMMDD (local time)
+// NOTE: localtime() is not thread-safe, only called from the main thread
+int GetStatsToday(void)
+{
+    const time_t now = time(NULL);
+    const struct tm *date = localtime(&now);
+
+    return (date != NULL)? (date->tm_year + 1900)*10000 + (date->tm_mon + 1)*100 + date->tm_mday : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Load files, then write records until shutdown
+static void StatsWriterThread(void *userData)
+{
+    (void)userData;
+
+    LoadStatsStore();
+
+    LockMutex(statsMutex);
+
+    while (true)
+    {
+        while ((pendingCount == 0) && !writerShutdown) WaitCondition(statsPending, statsMutex);
+
+        const bool finished = writerShutdown && (pendingCount == 0);
+        UnlockMutex(statsMutex);
+
+        if (finished) break;
+
+        WritePendingRecords(STATS_COMPACT_RECORDS);
+
+        LockMutex(statsMutex);
+    }
+
+    // NOTE: Log is compacted on close, so next session starts from the index only
+    if ((logRecords > 0) || compactNeeded) CompactStatsLog();
+}
+
+// Load files into summary, records added meanwhile are applied on top
+static void LoadStatsStore(void)
+{
+    StatsSummary *loaded = (StatsSummary *)malloc(sizeof(StatsSummary));
+    if (loaded == NULL) return;
+
+    *loaded = (StatsSummary){ 0 };
+    loaded->currentBestDelta = -1.0f;
+
+    int dataSize = 0;
+    unsigned char *data = LoadStatsFileData(STATS_INDEX_FILE, &dataSize);
+    if ((data != NULL) && !LoadStatsIndex(loaded, data, dataSize))
+    {
+        TraceLog(LOG_WARNING, "STATS: [%s] Invalid index file, ignored", STATS_INDEX_FILE);
+        *loaded = (StatsSummary){ 0 };
+        loaded->currentBestDelta = -1.0f;
+    }
+    free(data);
+
+    // NOTE: Records already compacted into the index are skipped, torn or corrupted records
+    // are dropped on next compaction (records appended after them would be misaligned)
+    const unsigned int indexSequence = loaded->lastSequence;
+    data = LoadStatsFileData(STATS_LOG_FILE, &dataSize);
+    logRecords = 0;
+
+    for (int position = 0; (data != NULL) && (position < dataSize); position += STATS_RECORD_SIZE)
+    {
+        StatsRecord record = { 0 };
+
+        if ((position + STATS_RECORD_SIZE > dataSize) || !ReadStatsRecord(data + position, &record))
+        {
+            compactNeeded = true;
+            break;
+        }
+
+        if (record.sequence > indexSequence)
+        {
+            ApplyStatsRecord(loaded, &record);
+            logRecords++;
+        }
+    }
+    free(data);
+
+    LockMutex(statsMutex);
+
+    // Records added before loading finished, sequence continues from loaded ones
+    for (int i = 0; i < pendingCount; i++)
+    {
+        pending[i].sequence = loaded->lastSequence + 1;
+        ApplyStatsRecord(loaded, &pending[i]);
+    }
+
+    summary = *loaded;
+    storeLoaded = true;
+
+    UnlockMutex(statsMutex);
+
+    TraceLog(LOG_INFO, "STATS: Statistics loaded (%i sessions, %i rounds, %i log records)", loaded->sessionCount, loaded->roundCount, logRecords);
+
+    free(loaded);
+}
+
+// Append pending records to log, compacting it once it has enough records
+// NOTE: Writes happen on writer thread, or on main thread without it, records are copied out under the mutex
+static void WritePendingRecords(int compactRecords)
+{
+    static unsigned char buffer[MAX_STATS_PENDING*STATS_RECORD_SIZE] = { 0 };
+
+    LockMutex(statsMutex);
+
+    const int count = pendingCount;
+    for (int i = 0; i < count; i++) WriteStatsRecord(buffer + i*STATS_RECORD_SIZE, &pending[i]);
+    pendingCount = 0;
+
+    UnlockMutex(statsMutex);
+
+    if (count > 0)
+    {
+        FILE *file = fopen(STATS_LOG_FILE, "ab");
+
+        if (file != NULL)
+        {
+            if (fwrite(buffer, STATS_RECORD_SIZE, count, file) == (size_t)count) logRecords += count;
+            else compactNeeded = true;
+
+            fclose(file);
+        }
+        else TraceLog(LOG_WARNING, "STATS: [%s] Failed to open log file", STATS_LOG_FILE);
+    }
+
+    if (((logRecords > 0) && (logRecords >= compactRecords)) || compactNeeded) CompactStatsLog();
+}
+
+// Write summary to index file and truncate log
+// NOTE: Index is written to a temporary file first, log is only truncated once it is in place
+static void CompactStatsLog(void)
+{
+    static unsigned char data[MAX_STATS_INDEX_SIZE] = { 0 };
+    StatsSummary *snapshot = (StatsSummary *)malloc(sizeof(StatsSummary));
+    if (snapshot == NULL) return;
+
+    LockMutex(statsMutex);
+    *snapshot = summary;
+    UnlockMutex(statsMutex);
+
+    const int dataSize = ExportStatsIndex(snapshot, data);
+    free(snapshot);
+
+    bool success = false;
+    FILE *file = fopen(STATS_INDEX_TEMP_FILE, "wb");
+
+    if (file != NULL)
+    {
+        success = (fwrite(data, 1, dataSize, file) == (size_t)dataSize);
+        success = (fclose(file) == 0) && success;
+    }
+
+    // NOTE: rename() does not replace existing files on Windows
+    if (success && (rename(STATS_INDEX_TEMP_FILE, STATS_INDEX_FILE) != 0))
+    {
+        remove(STATS_INDEX_FILE);
+        success = (rename(STATS_INDEX_TEMP_FILE, STATS_INDEX_FILE) == 0);
+    }
+
+    if (success)
+    {
+        file = fopen(STATS_LOG_FILE, "wb");
+        if (file != NULL) fclose(file);
+
+        logRecords = 0;
+        compactNeeded = false;
+    }
+    else TraceLog(LOG_WARNING, "STATS: [%s] Failed to write index file", STATS_INDEX_FILE);
+}
+
+// Apply record to summary and queue it to be written
+static void AddStatsRecord(StatsRecord record)
+{
+    if (!storeReady) return;
+
+    record.day = GetStatsToday();
+
+    LockMutex(statsMutex);
+
+    record.sequence = summary.lastSequence + 1;
+    ApplyStatsRecord(&summary, &record);
+
+    if (pendingCount < MAX_STATS_PENDING)
+    {
+        pending[pendingCount++] = record;
+        SignalCondition(statsPending);
+    }
+    else TraceLog(LOG_WARNING, "STATS: Pending records queue full, record not saved");
+
+    UnlockMutex(statsMutex);
+}
+
+// Apply record to summary
+static void ApplyStatsRecord(StatsSummary *stats, const StatsRecord *record)
+{
+    if (record->sequence > stats->lastSequence) stats->lastSequence = record->sequence;
+
+    StatsDay *day = GetSummaryDay(stats, record->day);
+
+    if (record->type == STATS_RECORD_ROUND)
+    {
+        const float delta = fabsf(record->values[1] - record->values[0]);
+
+        stats->roundCount++;
+        if (record->hit) stats->currentHits++;
+        if ((stats->currentBestDelta < 0.0f) || (delta < stats->currentBestDelta)) stats->currentBestDelta = delta;
+
+        if (day != NULL)
+        {
+            day->rounds++;
+            if (record->hit) day->hits++;
+            if ((day->bestDelta < 0.0f) || (delta < day->bestDelta)) day->bestDelta = delta;
+            day->pumpTimeSum += record->values[2];
+            day->stopLatencySum += record->values[3];
+        }
+    }
+    else if (record->type == STATS_RECORD_SESSION)
+    {
+        const StatsSession session = { record->day, record->round, record->values[0], stats->currentHits, stats->currentBestDelta };
+
+        stats->sessionCount++;
+        stats->currentHits = 0;
+        stats->currentBestDelta = -1.0f;
+        if (day != NULL) day->sessions++;
+
+        // Insert keeping most rounds first, lower score first on same rounds
+        int position = stats->topCount;
+        while ((position > 0) && ((stats->top[position - 1].rounds < session.rounds) ||
+            ((stats->top[position - 1].rounds == session.rounds) && (stats->top[position - 1].score > session.score)))) position--;
+
+        if (position < MAX_STATS_TOP_SESSIONS)
+        {
+            if (stats->topCount < MAX_STATS_TOP_SESSIONS) stats->topCount++;
+            memmove(&stats->top[position + 1], &stats->top[position], (stats->topCount - 1 - position)*sizeof(StatsSession));
+            stats->top[position] = session;
+        }
+    }
+}
+
+// Get day totals, inserted if not found (NULL if older than all days kept)
+static StatsDay *GetSummaryDay(StatsSummary *stats, int day)
+{
+    int index = FindSummaryDay(stats, day);
+    if ((index < stats->dayCount) && (stats->days[index].day == day)) return &stats->days[index];
+
+    if (stats->dayCount == MAX_STATS_DAYS)
+    {
+        if (index == 0) return NULL;
+
+        // Oldest day dropped
+        memmove(&stats->days[0], &stats->days[1], (stats->dayCount - 1)*sizeof(StatsDay));
+        stats->dayCount--;
+        index--;
+    }
+
+    memmove(&stats->days[index + 1], &stats->days[index], (stats->dayCount - index)*sizeof(StatsDay));
+    stats->days[index] = (StatsDay){ .day = day, .bestDelta = -1.0f };
+    stats->dayCount++;
+
+    return &stats->days[index];
+}
+
+// Find first day index not before day (binary search)
+static int FindSummaryDay(const StatsSummary *stats, int day)
+{
+    int low = 0;
+    int high = stats->dayCount;
+
+    while (low < high)
+    {
+        const int middle = (low + high)/2;
+
+        if (stats->days[middle].day < day) low = middle + 1;
+        else high = middle;
+    }
+
+    return low;
+}
+
+// Load file data (memory must be freed)
+static unsigned char *LoadStatsFileData(const char *fileName, int *dataSize)
+{
+    unsigned char *data = NULL;
+    FILE *file = fopen(fileName, "rb");
+    *dataSize = 0;
+
+    if (file != NULL)
+    {
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        if (size > 0)
+        {
+            data = (unsigned char *)malloc(size);
+
+            if ((data != NULL) && (fread(data, 1, size, file) == (size_t)size)) *dataSize = (int)size;
+            else
+            {
+                free(data);
+                data = NULL;
+            }
+        }
+
+        fclose(file);
+    }
+
+    return data;
+}
+
+// Load summary from index file data
+static bool LoadStatsIndex(StatsSummary *stats, const unsigned char *data, int dataSize)
+{
+    if ((dataSize < STATS_INDEX_HEADER_SIZE) || (memcmp(data, "STPI", 4) != 0) || (data[4] != STATS_FILE_VERSION)) return false;
+
+    stats->lastSequence = ReadUInt(data + 5);
+    stats->sessionCount = (int)ReadUInt(data + 9);
+    stats->roundCount = (int)ReadUInt(data + 13);
+    stats->currentHits = (int)ReadUInt(data + 17);
+    stats->currentBestDelta = ReadFloat(data + 21);
+    stats->topCount = data[25];
+    stats->dayCount = data[26] | (data[27] << 8);
+
+    if ((stats->topCount > MAX_STATS_TOP_SESSIONS) || (stats->dayCount > MAX_STATS_DAYS) ||
+        (dataSize < STATS_INDEX_HEADER_SIZE + stats->topCount*STATS_TOP_SESSION_SIZE + stats->dayCount*STATS_DAY_SIZE)) return false;
+
+    const unsigned char *buffer = data + STATS_INDEX_HEADER_SIZE;
+
+    for (int i = 0; i < stats->topCount; i++, buffer += STATS_TOP_SESSION_SIZE)
+    {
+        stats->top[i].day = (int)ReadUInt(buffer);
+        stats->top[i].rounds = (int)ReadUInt(buffer + 4);
+        stats->top[i].score = ReadFloat(buffer + 8);
+        stats->top[i].hits = (int)ReadUInt(buffer + 12);
+        stats->top[i].bestDelta = ReadFloat(buffer + 16);
+    }
+
+    for (int i = 0; i < stats->dayCount; i++, buffer += STATS_DAY_SIZE)
+    {
+        stats->days[i].day = (int)ReadUInt(buffer);
+        stats->days[i].sessions = (int)ReadUInt(buffer + 4);
+        stats->days[i].rounds = (int)ReadUInt(buffer + 8);
+        stats->days[i].hits = (int)ReadUInt(buffer + 12);
+        stats->days[i].bestDelta = ReadFloat(buffer + 16);
+        stats->days[i].pumpTimeSum = ReadFloat(buffer + 20);
+        stats->days[i].stopLatencySum = ReadFloat(buffer + 24);
+    }
+
+    return true;
+}
+
+// Export summary to index file data, returns size
+static int ExportStatsIndex(const StatsSummary *stats, unsigned char *data)
+{
+    memcpy(data, "STPI", 4);
+    data[4] = STATS_FILE_VERSION;
+    WriteUInt(data + 5, stats->lastSequence);
+    WriteUInt(data + 9, (unsigned int)stats->sessionCount);
+    WriteUInt(data + 13, (unsigned int)stats->roundCount);
+    WriteUInt(data + 17, (unsigned int)stats->currentHits);
+    WriteFloat(data + 21, stats->currentBestDelta);
+    data[25] = (unsigned char)stats->topCount;
+    data[26] = (unsigned char)(stats->dayCount & 0xff);
+    data[27] = (unsigned char)(stats->dayCount >> 8);
+
+    unsigned char *buffer = data + STATS_INDEX_HEADER_SIZE;
+
+    for (int i = 0; i < stats->topCount; i++, buffer += STATS_TOP_SESSION_SIZE)
+    {
+        WriteUInt(buffer, (unsigned int)stats->top[i].day);
+        WriteUInt(buffer + 4, (unsigned int)stats->top[i].rounds);
+        WriteFloat(buffer + 8, stats->top[i].score);
+        WriteUInt(buffer + 12, (unsigned int)stats->top[i].hits);
+        WriteFloat(buffer + 16, stats->top[i].bestDelta);
+    }
+
+    for (int i = 0; i < stats->dayCount; i++, buffer += STATS_DAY_SIZE)
+    {
+        WriteUInt(buffer, (unsigned int)stats->days[i].day);
+        WriteUInt(buffer + 4, (unsigned int)stats->days[i].sessions);
+        WriteUInt(buffer + 8, (unsigned int)stats->days[i].rounds);
+        WriteUInt(buffer + 12, (unsigned int)stats->days[i].hits);
+        WriteFloat(buffer + 16, stats->days[i].bestDelta);
+        WriteFloat(buffer + 20, stats->days[i].pumpTimeSum);
+        WriteFloat(buffer + 24, stats->days[i].stopLatencySum);
+    }
+
+    return (int)(buffer - data);
+}
+
+// Write log record
+static void WriteStatsRecord(unsigned char *buffer, const StatsRecord *record)
+{
+    const int round = (record->round < 0)? 0 : (record->round > 0xffff)? 0xffff : record->round;
+
+    WriteUInt(buffer, record->sequence);
+    buffer[4] = (unsigned char)record->type;
+    buffer[5] = record->hit? 1 : 0;
+    buffer[6] = (unsigned char)(round & 0xff);
+    buffer[7] = (unsigned char)(round >> 8);
+    WriteUInt(buffer + 8, (unsigned int)record->day);
+    for (int i = 0; i < 4; i++) WriteFloat(buffer + 12 + 4*i, record->values[i]);
+    WriteUInt(buffer + 28, GetStatsChecksum(buffer, 28));
+}
+
+// Read log record, false if corrupted
+static bool ReadStatsRecord(const unsigned char *buffer, StatsRecord *record)
+{
+    if (ReadUInt(buffer + 28) != GetStatsChecksum(buffer, 28)) return false;
+
+    record->sequence = ReadUInt(buffer);
+    record->type = buffer[4];
+    record->hit = (buffer[5] != 0);
+    record->round = buffer[6] | (buffer[7] << 8);
+    record->day = (int)ReadUInt(buffer + 8);
+    for (int i = 0; i < 4; i++) record->values[i] = ReadFloat(buffer + 12 + 4*i);
+
+    return (record->sequence > 0) && ((record->type == STATS_RECORD_ROUND) || (record->type == STATS_RECORD_SESSION));
+}
+
+// Compute FNV-1a checksum
+static unsigned int GetStatsChecksum(const unsigned char *data, int size)
+{
+    unsigned int hash = 2166136261u;
+
+    for (int i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+// Write unsigned int as little-endian bytes
+static void WriteUInt(unsigned char *buffer, unsigned int value)
+{
+    for (int i = 0; i < 4; i++) buffer[i] = (unsigned char)(value >> (8*i));
+}
+
+// Read unsigned int from little-endian bytes
+static unsigned int ReadUInt(const unsigned char *buffer)
+{
+    return (unsigned int)buffer[0] | ((unsigned int)buffer[1] << 8) | ((unsigned int)buffer[2] << 16) | ((unsigned int)buffer[3] << 24);
+}
+
+// Write float as little-endian bytes
+static void WriteFloat(unsigned char *buffer, float value)
+{
+    unsigned int bits = 0;
+    memcpy(&bits, &value, sizeof(float));
+
+    WriteUInt(buffer, bits);
+}
+
+// Read float from little-endian bytes
+static float ReadFloat(const unsigned char *buffer)
+{
+    unsigned int bits = ReadUInt(buffer);
+    float value = 0.0f;
+    memcpy(&value, &bits, sizeof(float));
+
+    return value;
+}
@@ -0,0 +1,92 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Statistics store
+*
+*   Persistent per-round results and high scores. Results are applied right away to an in
+*   memory summary (top sessions and per-day totals, queried without I/O) and queued to be
+*   appended to a binary log by a writer thread, so the render thread never waits on files.
+*   The writer compacts the log in the background into a small indexed file (the summary
+*   itself, days sorted for binary search) once it grows, and when the store is closed.
+*
+*   Log file format (stats.log, little-endian), fixed size records:
+*       uint32 sequence, uint8 type, uint8 hit, uint16 round, int32 day (YYYYMMDD, local time)
+*       float32 target price, stop price, pump time, stop latency (session records: score, 0, 0, 0)
+*       uint32 checksum of previous bytes (torn or corrupted records are ignored)
+*
+*   Index file format (stats.idx, little-endian):
+*       "STPI" magic, version byte, uint32 last sequence compacted (log records up to it are skipped)
+*       uint32 sessions, rounds, current session hits, float32 current session best delta
+*       uint8 top sessions count, uint16 days count, top sessions records, days records
+*
+*   NOTE: On web, files are stored in an IndexedDB backed directory (IDBFS), loaded
+*   asynchronously at startup and synchronized back after writes, without threads
+*
+**********************************************************************************************/
+
+#ifndef STATS_STORE_H
+#define STATS_STORE_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define STATS_FILE_VERSION          1
+#define MAX_STATS_TOP_SESSIONS      10          // High scores kept
+#define MAX_STATS_DAYS              366         // Days kept, oldest dropped first
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Round result
+typedef struct StatsRound {
+    int round;                  // Round number in session
+    float targetPrice;
+    float stopPrice;            // Price the pump was stopped at
+    float pumpTime;             // Time the trigger was held (seconds)
+    float stopLatency;          // Time from trigger release to the stop being processed (seconds)
+    bool hit;
+} StatsRound;
+
+// Session result, high scores entry
+typedef struct StatsSession {
+    int day;                    // Session date, YYYYMMDD (local time)
+    int rounds;                 // Rounds survived
+    float score;
+    int hits;
+    float bestDelta;            // Smallest stop distance to target price
+} StatsSession;
+
+// Day totals
+typedef struct StatsDay {
+    int day;                    // YYYYMMDD (local time)
+    int sessions;
+    int rounds;
+    int hits;
+    float bestDelta;            // Smallest stop distance to target price
+    float pumpTimeSum;          // Total trigger hold time, average is sum/rounds (seconds)
+    float stopLatencySum;       // Total stop latency, average is sum/rounds (seconds)
+} StatsDay;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Statistics Store Functions Declaration
+//----------------------------------------------------------------------------------
+bool InitStatsStore(void);                              // Load statistics and start writer thread
+void CloseStatsStore(void);                             // Write pending records and compact log, waits for the writer
+void UpdateStatsStore(void);                            // Write pending records without writer thread, synchronizes files on web
+void AddStatsRound(StatsRound round);                   // Add round result to current session
+void EndStatsSession(int rounds, float score);          // End current session, adding it to high scores
+int GetStatsTopSessions(StatsSession *sessions, int count); // Get best sessions (most rounds first), returns number of sessions
+bool GetStatsDay(int day, StatsDay *stats);             // Get day totals, false if nothing recorded that day
+int GetStatsToday(void);                                // Get today date as YYYYMMDD (local time)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STATS_STORE_H
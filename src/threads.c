@@ -0,0 +1,241 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Threads
+*
+*   Minimal portable threads, mutexes and condition variables (pthreads or Win32).
+*
+**********************************************************************************************/
+
+#include "threads.h"
+
+#include <stdlib.h>     // Required for: malloc(), free()
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <unistd.h>     // Required for: sysconf()
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct Thread {
+#if defined(_WIN32)
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    ThreadFunction function;
+    void *userData;
+};
+
+struct Mutex {
+#if defined(_WIN32)
+    CRITICAL_SECTION section;
+#else
+    pthread_mutex_t mutex;
+#endif
+};
+
+struct Condition {
+#if defined(_WIN32)
+    CONDITION_VARIABLE variable;
+#else
+    pthread_cond_t cond;
+#endif
+};
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+#if defined(_WIN32)
+static DWORD WINAPI ThreadEntry(LPVOID param);
+#else
+static void *ThreadEntry(void *param);
+#endif
+
+//----------------------------------------------------------------------------------
+// Threads Functions Definition
+//----------------------------------------------------------------------------------
+
+// Start new thread running function, NULL on failure
+Thread *StartThread(ThreadFunction function, void *userData)
+{
+    Thread *thread = (Thread *)malloc(sizeof(Thread));
+    thread->function = function;
+    thread->userData = userData;
+
+#if defined(_WIN32)
+    thread->handle = CreateThread(NULL, 0, ThreadEntry, thread, 0, NULL);
+    bool started = (thread->handle != NULL);
+#else
+    bool started = (pthread_create(&thread->handle, NULL, ThreadEntry, thread) == 0);
+#endif
+
+    if (!started)
+    {
+        free(thread);
+        thread = NULL;
+    }
+
+    return thread;
+}
+
+// Wait for thread to finish and free it
+void JoinThread(Thread *thread)
+{
+    if (thread == NULL) return;
+
+#if defined(_WIN32)
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+
+    free(thread);
+}
+
+// Get number of logical processors available
+int GetProcessorCount(void)
+{
+    int count = 1;
+
+#if defined(_WIN32)
+    SYSTEM_INFO info = { 0 };
+    GetSystemInfo(&info);
+    count = (int)info.dwNumberOfProcessors;
+#else
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online > 0) count = (int)online;
+#endif
+
+    return count;
+}
+
+// Create mutex
+Mutex *LoadMutex(void)
+{
+    Mutex *mutex = (Mutex *)malloc(sizeof(Mutex));
+
+#if defined(_WIN32)
+    InitializeCriticalSection(&mutex->section);
+#else
+    pthread_mutex_init(&mutex->mutex, NULL);
+#endif
+
+    return mutex;
+}
+
+// Destroy mutex
+void UnloadMutex(Mutex *mutex)
+{
+    if (mutex == NULL) return;
+
+#if defined(_WIN32)
+    DeleteCriticalSection(&mutex->section);
+#else
+    pthread_mutex_destroy(&mutex->mutex);
+#endif
+
+    free(mutex);
+}
+
+// Lock mutex
+void LockMutex(Mutex *mutex)
+{
+#if defined(_WIN32)
+    EnterCriticalSection(&mutex->section);
+#else
+    pthread_mutex_lock(&mutex->mutex);
+#endif
+}
+
+// Unlock mutex
+void UnlockMutex(Mutex *mutex)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(&mutex->section);
+#else
+    pthread_mutex_unlock(&mutex->mutex);
+#endif
+}
+
+// Create condition variable
+Condition *LoadCondition(void)
+{
+    Condition *condition = (Condition *)malloc(sizeof(Condition));
+
+#if defined(_WIN32)
+    InitializeConditionVariable(&condition->variable);
+#else
+    pthread_cond_init(&condition->cond, NULL);
+#endif
+
+    return condition;
+}
+
+// Destroy condition variable
+void UnloadCondition(Condition *condition)
+{
+    if (condition == NULL) return;
+
+#if !defined(_WIN32)
+    pthread_cond_destroy(&condition->cond);
+#endif
+
+    free(condition);
+}
+
+// Wait on condition variable (mutex must be locked)
+void WaitCondition(Condition *condition, Mutex *mutex)
+{
+#if defined(_WIN32)
+    SleepConditionVariableCS(&condition->variable, &mutex->section, INFINITE);
+#else
+    pthread_cond_wait(&condition->cond, &mutex->mutex);
+#endif
+}
+
+// Wake one thread waiting on condition variable
+void SignalCondition(Condition *condition)
+{
+#if defined(_WIN32)
+    WakeConditionVariable(&condition->variable);
+#else
+    pthread_cond_signal(&condition->cond);
+#endif
+}
+
+// Wake all threads waiting on condition variable
+void BroadcastCondition(Condition *condition)
+{
+#if defined(_WIN32)
+    WakeAllConditionVariable(&condition->variable);
+#else
+    pthread_cond_broadcast(&condition->cond);
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Thread entry point, runs user function
+#if defined(_WIN32)
+static DWORD WINAPI ThreadEntry(LPVOID param)
+{
+    Thread *thread = (Thread *)param;
+    thread->function(thread->userData);
+    return 0;
+}
+#else
+static void *ThreadEntry(void *param)
+{
+    Thread *thread = (Thread *)param;
+    thread->function(thread->userData);
+    return NULL;
+}
+#endif
@@ -0,0 +1,51 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Threads
+*
+*   Minimal portable threads, mutexes and condition variables (pthreads or Win32).
+*
+*   NOTE: Implementation includes <windows.h> on Windows, so it must not include raylib.h
+*
+**********************************************************************************************/
+
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Thread Thread;           // Opaque thread handle
+typedef struct Mutex Mutex;             // Opaque mutex
+typedef struct Condition Condition;     // Opaque condition variable
+
+typedef void (*ThreadFunction)(void *userData);
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Threads Functions Declaration
+//----------------------------------------------------------------------------------
+Thread *StartThread(ThreadFunction function, void *userData);  // Start new thread running function, NULL on failure
+void JoinThread(Thread *thread);                                // Wait for thread to finish and free it
+int GetProcessorCount(void);                                    // Get number of logical processors available
+
+Mutex *LoadMutex(void);                                         // Create mutex
+void UnloadMutex(Mutex *mutex);                                 // Destroy mutex
+void LockMutex(Mutex *mutex);                                   // Lock mutex
+void UnlockMutex(Mutex *mutex);                                 // Unlock mutex
+
+Condition *LoadCondition(void);                                 // Create condition variable
+void UnloadCondition(Condition *condition);                     // Destroy condition variable
+void WaitCondition(Condition *condition, Mutex *mutex);         // Wait on condition variable (mutex must be locked)
+void SignalCondition(Condition *condition);                     // Wake one thread waiting on condition variable
+void BroadcastCondition(Condition *condition);                  // Wake all threads waiting on condition variable
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THREADS_H
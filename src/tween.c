@@ -0,0 +1,128 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Tweens and timelines
+*
+*   Time-based animation helpers.
+*
+**********************************************************************************************/
+
+#include "tween.h"
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static float ClampAnimationStep(float deltaTime);   // Clamp delta time to [0.0f..MAX_ANIMATION_STEP]
+static float ApplyEase(TweenEase ease, float t);    // Apply easing function to normalized time
+
+//----------------------------------------------------------------------------------
+// Tween Functions Definition
+//----------------------------------------------------------------------------------
+
+// Create tween, starting at from value
+Tween CreateTween(float from, float to, float duration, TweenEase ease)
+{
+    Tween tween = { 0 };
+
+    tween.from = from;
+    tween.to = to;
+    tween.duration = duration;
+    tween.ease = ease;
+
+    return tween;
+}
+
+// Advance tween by delta time (seconds)
+void UpdateTween(Tween *tween, float deltaTime)
+{
+    tween->time += ClampAnimationStep(deltaTime);
+    if (tween->time > tween->duration) tween->time = tween->duration;
+}
+
+// Get tween current value
+float GetTweenValue(Tween tween)
+{
+    const float t = (tween.duration > 0.0f)? tween.time/tween.duration : 1.0f;
+
+    return tween.from + (tween.to - tween.from)*ApplyEase(tween.ease, t);
+}
+
+// Check if tween reached its end value
+bool IsTweenFinished(Tween tween)
+{
+    return (tween.time >= tween.duration);
+}
+
+// Create timeline from stage durations (seconds)
+Timeline CreateTimeline(const float *durations, int stageCount)
+{
+    Timeline timeline = { 0 };
+
+    if (stageCount > MAX_TIMELINE_STAGES) stageCount = MAX_TIMELINE_STAGES;
+    for (int i = 0; i < stageCount; i++) timeline.durations[i] = durations[i];
+    timeline.stageCount = stageCount;
+
+    return timeline;
+}
+
+// Advance timeline by delta time (seconds), moving through stages
+// NOTE: Leftover time of a finished stage is carried over to the next one
+void UpdateTimeline(Timeline *timeline, float deltaTime)
+{
+    if (timeline->stage >= timeline->stageCount) return;
+
+    timeline->stageTime += ClampAnimationStep(deltaTime);
+
+    while ((timeline->stage < timeline->stageCount) && (timeline->stageTime >= timeline->durations[timeline->stage]))
+    {
+        timeline->stageTime -= timeline->durations[timeline->stage];
+        timeline->stage++;
+    }
+
+    if (timeline->stage >= timeline->stageCount) timeline->stageTime = 0.0f;
+}
+
+// Get current stage progress [0.0f..1.0f]
+float GetTimelineProgress(Timeline timeline)
+{
+    if (timeline.stage >= timeline.stageCount) return 1.0f;
+
+    const float duration = timeline.durations[timeline.stage];
+
+    return (duration > 0.0f)? timeline.stageTime/duration : 1.0f;
+}
+
+// Check if timeline went through all its stages
+bool IsTimelineFinished(Timeline timeline)
+{
+    return (timeline.stage >= timeline.stageCount);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Clamp delta time to [0.0f..MAX_ANIMATION_STEP]
+static float ClampAnimationStep(float deltaTime)
+{
+    if (deltaTime < 0.0f) return 0.0f;
+    if (deltaTime > MAX_ANIMATION_STEP) return MAX_ANIMATION_STEP;
+
+    return deltaTime;
+}
+
+// Apply easing function to normalized time
+static float ApplyEase(TweenEase ease, float t)
+{
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+
+    switch (ease)
+    {
+        case TWEEN_EASE_IN: return t*t;
+        case TWEEN_EASE_OUT: return t*(2.0f - t);
+        case TWEEN_EASE_IN_OUT: return (t < 0.5f)? 2.0f*t*t : -1.0f + (4.0f - 2.0f*t)*t;
+        default: break;
+    }
+
+    return t;
+}
@@ -0,0 +1,76 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Tweens and timelines
+*
+*   Time-based animation helpers, so animations look the same at any frame rate:
+*     - Tween: value interpolated from/to over a duration, with easing
+*     - Timeline: sequence of stages with fixed durations, leftover time carries over to
+*       the next stage, so a long frame lands on the same stage a few short ones would
+*
+*   NOTE: Delta time is clamped to MAX_ANIMATION_STEP, so a long hitch (i.e. assets upload)
+*   slows animations down for a frame instead of skipping whole stages
+*
+**********************************************************************************************/
+
+#ifndef TWEEN_H
+#define TWEEN_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_TIMELINE_STAGES     8
+#define MAX_ANIMATION_STEP      0.1f        // Maximum delta time per update (seconds)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Tween easing functions
+typedef enum TweenEase {
+    TWEEN_LINEAR = 0,
+    TWEEN_EASE_IN,              // Quadratic, slow start
+    TWEEN_EASE_OUT,             // Quadratic, slow end
+    TWEEN_EASE_IN_OUT           // Quadratic, slow start and end
+} TweenEase;
+
+// Tween, value interpolated over time
+typedef struct Tween {
+    float from;
+    float to;
+    float duration;             // Seconds
+    float time;                 // Elapsed time (seconds)
+    TweenEase ease;
+} Tween;
+
+// Timeline, sequence of stages with fixed durations
+typedef struct Timeline {
+    float durations[MAX_TIMELINE_STAGES];   // Stage durations (seconds)
+    int stageCount;
+    int stage;                  // Current stage, stageCount once finished
+    float stageTime;            // Elapsed time on current stage (seconds)
+} Timeline;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Tween Functions Declaration
+//----------------------------------------------------------------------------------
+Tween CreateTween(float from, float to, float duration, TweenEase ease);    // Create tween, starting at from value
+void UpdateTween(Tween *tween, float deltaTime);                            // Advance tween by delta time (seconds)
+float GetTweenValue(Tween tween);                                           // Get tween current value
+bool IsTweenFinished(Tween tween);                                          // Check if tween reached its end value
+
+Timeline CreateTimeline(const float *durations, int stageCount);            // Create timeline from stage durations (seconds)
+void UpdateTimeline(Timeline *timeline, float deltaTime);                   // Advance timeline by delta time (seconds), moving through stages
+float GetTimelineProgress(Timeline timeline);                               // Get current stage progress [0.0f..1.0f]
+bool IsTimelineFinished(Timeline timeline);                                 // Check if timeline went through all its stages
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TWEEN_H
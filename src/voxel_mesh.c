@@ -0,0 +1,764 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Voxel mesh loader
+*
+*   Greedy meshing of MagicaVoxel .vox models, levels of detail and a baked binary mesh cache.
+*
+*   Lighting is baked into vertex colors at mesh generation: per-vertex voxel ambient occlusion
+*   (neighbour voxels around every face corner) and a fixed directional light, so lit models
+*   are drawn with the default (unlit) shaders at no per-frame cost.
+*
+*   Voxel mesh cache file layout (.vxm, little-endian, every array 16-byte aligned so the file
+*   can be used directly from a memory mapping):
+*
+*     VoxelMeshFileHeader     magic "VXM0", version, levels count, per level counts and arrays offsets
+*     For every level of detail:
+*       float vertices[vertexCount*3]
+*       float normals[vertexCount*3]
+*       unsigned char colors[vertexCount*4]
+*       unsigned short indices[triangleCount*3]
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "raymath.h"
+#include "voxel_mesh.h"
+
+#include <stdlib.h>     // Required for: malloc(), calloc(), realloc(), free()
+#include <string.h>     // Required for: memcpy(), memcmp(), memset(), strrchr(), strlen()
+#include <math.h>       // Required for: tanf(), log2f(), floorf()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define VOXEL_MESH_FILE_VERSION     3       // Increase when mesh generation changes to invalidate baked caches
+#define VOXEL_MESH_FILE_ALIGNMENT   16
+
+#define MAX_VOXEL_MESH_VERTICES     65535   // Mesh indices are unsigned short
+
+#define VOXEL_LOD_PIXEL_SIZE        3.0f    // Level is used once its voxels project smaller than this (pixels)
+#define VOXEL_LOD_FADE_RANGE        0.25f   // Fade to next level over the last part of a level range (log2 units)
+
+#define VOXEL_LIGHT_AMBIENT         0.5f    // Baked light on faces facing away from the light
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Voxel grid in raylib space (Y-up), voxel value is palette index + 1, 0 means empty
+typedef struct VoxelGrid {
+    int sizeX;
+    int sizeY;
+    int sizeZ;
+    unsigned char *voxels;
+    Color palette[256];
+} VoxelGrid;
+
+// Greedy meshing output quad, plane at position[axis] spanning width along axis+1 and height along axis+2
+typedef struct VoxelQuad {
+    int position[3];
+    int axis;
+    int width;
+    int height;
+    bool backFace;              // Normal pointing towards negative axis
+    unsigned char colorIndex;
+    unsigned char occlusion;    // Corners ambient occlusion, 2 bits per corner (3: not occluded)
+} VoxelQuad;
+
+// Voxel mesh cache file level of detail
+typedef struct VoxelMeshFileLevel {
+    unsigned int vertexCount;
+    unsigned int triangleCount;
+    unsigned int verticesOffset;
+    unsigned int normalsOffset;
+    unsigned int colorsOffset;
+    unsigned int indicesOffset;
+} VoxelMeshFileLevel;
+
+// Voxel mesh cache file header
+typedef struct VoxelMeshFileHeader {
+    char magic[4];
+    unsigned int version;
+    unsigned int lodCount;
+    VoxelMeshFileLevel levels[VOXEL_LOD_COUNT];
+} VoxelMeshFileHeader;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const Vector3 lightDirection = { 0.37f, 0.74f, 0.56f };     // Normalized, towards the light: above, front right
+static const float occlusionLight[4] = { 0.55f, 0.7f, 0.85f, 1.0f };  // Light by corner occlusion value
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static bool LoadVoxelGrid(const unsigned char *fileData, int dataSize, VoxelGrid *grid, int *voxelCount);
+static unsigned char GetVoxel(VoxelGrid grid, int x, int y, int z);
+static VoxelGrid DownsampleVoxelGrid(VoxelGrid grid, int factor);
+static int GetVoxelFaceOcclusion(VoxelGrid grid, const int air[3], int u, int v);
+static VoxelQuad *GenVoxelQuads(VoxelGrid grid, int *quadCount, int *faceCount);
+static Mesh GenMeshFromVoxelQuads(VoxelGrid grid, const VoxelQuad *quads, int quadCount, float voxelSize);
+static unsigned int AlignOffset(unsigned int offset);
+
+//----------------------------------------------------------------------------------
+// Voxel Mesh Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load voxel mesh levels of detail from .vox file or its baked cache (not uploaded to GPU), returns levels loaded
+// NOTE: Cache file is written next to the source file, changing extension to .vxm
+// Cache file name is composed locally (no raylib static text buffers), so it can be called from loader threads
+int LoadVoxelMeshLods(const char *fileName, Mesh *lods)
+{
+    char cacheFileName[512] = { 0 };
+    const char *extension = strrchr(fileName, '.');
+    int nameLength = (extension != NULL)? (int)(extension - fileName) : (int)strlen(fileName);
+    if (nameLength > (int)sizeof(cacheFileName) - 5) nameLength = (int)sizeof(cacheFileName) - 5;
+    memcpy(cacheFileName, fileName, nameLength);
+    memcpy(cacheFileName + nameLength, ".vxm", 5);
+
+    if (FileExists(cacheFileName) && (GetFileModTime(cacheFileName) >= GetFileModTime(fileName)))
+    {
+        const int lodCount = LoadVoxelMeshCache(cacheFileName, lods);
+        if (lodCount > 0) return lodCount;
+    }
+
+    int dataSize = 0;
+    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    if (fileData == NULL) return 0;
+
+    VoxelMeshStats stats = { 0 };
+    const int lodCount = GenMeshVoxelLodsFromMemory(fileData, dataSize, lods, &stats);
+    UnloadFileData(fileData);
+
+    if (lodCount > 0)
+    {
+        TraceLog(LOG_INFO, "VOXEL: [%s] Greedy mesh generated: %i voxels, triangles: %i (naive) -> %i (culled) -> %i (greedy), vertices: %i",
+            fileName, stats.voxelCount, stats.naiveTriangles, stats.culledTriangles, stats.greedyTriangles, stats.greedyVertices);
+        for (int i = 1; i < lodCount; i++) TraceLog(LOG_INFO, "VOXEL: [%s] Level of detail %i (%ix downsampled): %i triangles", fileName, i, 1 << i, stats.lodTriangles[i]);
+
+        if (!ExportVoxelMeshCache(lods, lodCount, cacheFileName)) TraceLog(LOG_WARNING, "VOXEL: [%s] Failed to bake mesh cache", cacheFileName);
+    }
+
+    return lodCount;
+}
+
+// Generate greedy voxel mesh levels of detail from .vox file data, returns levels generated
+// NOTE: Every level is downsampled from the full resolution grid, level i voxels are 2^i times
+// bigger, so all levels keep the same world size and origin
+int GenMeshVoxelLodsFromMemory(const unsigned char *fileData, int dataSize, Mesh *lods, VoxelMeshStats *stats)
+{
+    VoxelGrid grid = { 0 };
+    int voxelCount = 0;
+
+    if (!LoadVoxelGrid(fileData, dataSize, &grid, &voxelCount)) return 0;
+
+    int lodCount = 0;
+
+    for (int lod = 0; lod < VOXEL_LOD_COUNT; lod++)
+    {
+        const int factor = 1 << lod;
+        VoxelGrid lodGrid = (lod == 0)? grid : DownsampleVoxelGrid(grid, factor);
+
+        int quadCount = 0;
+        int faceCount = 0;
+        VoxelQuad *quads = GenVoxelQuads(lodGrid, &quadCount, &faceCount);
+        Mesh mesh = { 0 };
+
+        if (quadCount*4 > MAX_VOXEL_MESH_VERTICES) TraceLog(LOG_WARNING, "VOXEL: Greedy mesh exceeds %i vertices, mesh not generated", MAX_VOXEL_MESH_VERTICES);
+        else mesh = GenMeshFromVoxelQuads(lodGrid, quads, quadCount, VOXEL_MESH_SCALE*factor);
+
+        if (stats != NULL)
+        {
+            if (lod == 0)
+            {
+                stats->voxelCount = voxelCount;
+                stats->naiveTriangles = voxelCount*6*2;
+                stats->culledTriangles = faceCount*2;
+                stats->greedyTriangles = mesh.triangleCount;
+                stats->greedyVertices = mesh.vertexCount;
+            }
+
+            stats->lodTriangles[lod] = mesh.triangleCount;
+        }
+
+        RL_FREE(quads);
+        if (lod > 0) RL_FREE(lodGrid.voxels);
+
+        // NOTE: Chain stops at the first level failing, coarser levels would be left without a fallback
+        if (mesh.vertexCount == 0)
+        {
+            UnloadMesh(mesh);
+            break;
+        }
+
+        lods[lodCount] = mesh;
+        lodCount++;
+    }
+
+    RL_FREE(grid.voxels);
+
+    return lodCount;
+}
+
+// Load voxel model, levels of detail uploaded to GPU
+Model LoadVoxelModel(const char *fileName)
+{
+    Mesh lods[VOXEL_LOD_COUNT] = { 0 };
+    const int lodCount = LoadVoxelMeshLods(fileName, lods);
+
+    return LoadModelFromVoxelMeshLods(lods, lodCount);
+}
+
+// Load voxel model from levels of detail meshes (uploaded to GPU, owned by model)
+// NOTE: Every level is a model mesh, all sharing the default material
+Model LoadModelFromVoxelMeshLods(Mesh *lods, int lodCount)
+{
+    Model model = { 0 };
+
+    if (lodCount <= 0) return model;
+
+    model.transform = MatrixIdentity();
+    model.meshCount = lodCount;
+    model.meshes = (Mesh *)RL_CALLOC(lodCount, sizeof(Mesh));
+    model.materialCount = 1;
+    model.materials = (Material *)RL_CALLOC(1, sizeof(Material));
+    model.materials[0] = LoadMaterialDefault();
+    model.meshMaterial = (int *)RL_CALLOC(lodCount, sizeof(int));
+
+    for (int i = 0; i < lodCount; i++)
+    {
+        UploadMesh(&lods[i], false);
+        model.meshes[i] = lods[i];
+    }
+
+    return model;
+}
+
+// Export levels of detail meshes to binary voxel mesh cache file
+bool ExportVoxelMeshCache(const Mesh *lods, int lodCount, const char *fileName)
+{
+    if ((lodCount <= 0) || (lodCount > VOXEL_LOD_COUNT)) return false;
+
+    VoxelMeshFileHeader header = { 0 };
+    memcpy(header.magic, "VXM0", 4);
+    header.version = VOXEL_MESH_FILE_VERSION;
+    header.lodCount = lodCount;
+
+    unsigned int dataSize = sizeof(VoxelMeshFileHeader);
+
+    for (int i = 0; i < lodCount; i++)
+    {
+        const Mesh mesh = lods[i];
+        VoxelMeshFileLevel *level = &header.levels[i];
+
+        if ((mesh.vertices == NULL) || (mesh.normals == NULL) || (mesh.colors == NULL) || (mesh.indices == NULL)) return false;
+
+        level->vertexCount = mesh.vertexCount;
+        level->triangleCount = mesh.triangleCount;
+        level->verticesOffset = AlignOffset(dataSize);
+        level->normalsOffset = AlignOffset(level->verticesOffset + mesh.vertexCount*3*sizeof(float));
+        level->colorsOffset = AlignOffset(level->normalsOffset + mesh.vertexCount*3*sizeof(float));
+        level->indicesOffset = AlignOffset(level->colorsOffset + mesh.vertexCount*4*sizeof(unsigned char));
+        dataSize = level->indicesOffset + mesh.triangleCount*3*sizeof(unsigned short);
+    }
+
+    unsigned char *data = (unsigned char *)RL_CALLOC(dataSize, 1);
+
+    memcpy(data, &header, sizeof(VoxelMeshFileHeader));
+
+    for (int i = 0; i < lodCount; i++)
+    {
+        const Mesh mesh = lods[i];
+        const VoxelMeshFileLevel *level = &header.levels[i];
+
+        memcpy(data + level->verticesOffset, mesh.vertices, mesh.vertexCount*3*sizeof(float));
+        memcpy(data + level->normalsOffset, mesh.normals, mesh.vertexCount*3*sizeof(float));
+        memcpy(data + level->colorsOffset, mesh.colors, mesh.vertexCount*4*sizeof(unsigned char));
+        memcpy(data + level->indicesOffset, mesh.indices, mesh.triangleCount*3*sizeof(unsigned short));
+    }
+
+    bool success = SaveFileData(fileName, data, dataSize);
+    RL_FREE(data);
+
+    return success;
+}
+
+// Load levels of detail meshes from binary voxel mesh cache file, returns levels loaded
+int LoadVoxelMeshCache(const char *fileName, Mesh *lods)
+{
+    int dataSize = 0;
+    unsigned char *data = LoadFileData(fileName, &dataSize);
+
+    if (data == NULL) return 0;
+
+    VoxelMeshFileHeader header = { 0 };
+    if (dataSize >= (int)sizeof(VoxelMeshFileHeader)) memcpy(&header, data, sizeof(VoxelMeshFileHeader));
+
+    bool valid = (memcmp(header.magic, "VXM0", 4) == 0) && (header.version == VOXEL_MESH_FILE_VERSION) &&
+        (header.lodCount > 0) && (header.lodCount <= VOXEL_LOD_COUNT);
+
+    for (unsigned int i = 0; valid && (i < header.lodCount); i++)
+    {
+        const VoxelMeshFileLevel *level = &header.levels[i];
+        if ((level->vertexCount == 0) || ((unsigned int)dataSize < level->indicesOffset + level->triangleCount*3*sizeof(unsigned short))) valid = false;
+    }
+
+    if (!valid)
+    {
+        TraceLog(LOG_INFO, "VOXEL: [%s] Mesh cache is outdated or invalid, ignored", fileName);
+        UnloadFileData(data);
+        return 0;
+    }
+
+    for (unsigned int i = 0; i < header.lodCount; i++)
+    {
+        const VoxelMeshFileLevel *level = &header.levels[i];
+        Mesh mesh = { 0 };
+
+        mesh.vertexCount = level->vertexCount;
+        mesh.triangleCount = level->triangleCount;
+        mesh.vertices = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
+        mesh.normals = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
+        mesh.colors = (unsigned char *)RL_MALLOC(mesh.vertexCount*4*sizeof(unsigned char));
+        mesh.indices = (unsigned short *)RL_MALLOC(mesh.triangleCount*3*sizeof(unsigned short));
+
+        memcpy(mesh.vertices, data + level->verticesOffset, mesh.vertexCount*3*sizeof(float));
+        memcpy(mesh.normals, data + level->normalsOffset, mesh.vertexCount*3*sizeof(float));
+        memcpy(mesh.colors, data + level->colorsOffset, mesh.vertexCount*4*sizeof(unsigned char));
+        memcpy(mesh.indices, data + level->indicesOffset, mesh.triangleCount*3*sizeof(unsigned short));
+
+        lods[i] = mesh;
+    }
+
+    UnloadFileData(data);
+
+    TraceLog(LOG_INFO, "VOXEL: [%s] Mesh cache loaded: %i levels of detail, %i triangles, %i vertices (full resolution)", fileName, header.lodCount, header.levels[0].triangleCount, header.levels[0].vertexCount);
+
+    return (int)header.lodCount;
+}
+
+// Get level of detail for voxels at position (unscaled model), fade [0..1] towards next level
+// NOTE: Level i is used once its voxels project smaller than VOXEL_LOD_PIXEL_SIZE, fading to
+// level i + 1 over the last VOXEL_LOD_FADE_RANGE of the range (log2 of projected size)
+int GetVoxelLod(Camera camera, Vector3 position, int lodCount, float *fade)
+{
+    // View height in world units at position distance
+    float viewHeight = camera.fovy;
+    if (camera.projection == CAMERA_PERSPECTIVE) viewHeight = 2.0f*Vector3Distance(camera.position, position)*tanf(camera.fovy*0.5f*DEG2RAD);
+
+    const float voxelPixels = (viewHeight > 0.0f)? VOXEL_MESH_SCALE*GetScreenHeight()/viewHeight : 0.0f;
+    const float level = (voxelPixels > 0.0f)? log2f(VOXEL_LOD_PIXEL_SIZE/voxelPixels) : (float)lodCount;
+
+    int lod = (int)floorf(level);
+    float lodFade = Clamp((level - lod - (1.0f - VOXEL_LOD_FADE_RANGE))/VOXEL_LOD_FADE_RANGE, 0.0f, 1.0f);
+
+    if (lod < 0)
+    {
+        lod = 0;
+        lodFade = 0.0f;
+    }
+    else if (lod >= lodCount - 1)
+    {
+        lod = (lodCount > 0)? lodCount - 1 : 0;
+        lodFade = 0.0f;
+    }
+
+    if (fade != NULL) *fade = lodFade;
+
+    return lod;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Load voxel grid from .vox file data (first model only)
+// NOTE: MagicaVoxel is Z-up, voxels are converted to Y-up with Z pointing to the model front,
+// the same convention used by raylib LoadModel() so existing draw positions stay valid
+static bool LoadVoxelGrid(const unsigned char *fileData, int dataSize, VoxelGrid *grid, int *voxelCount)
+{
+    if ((fileData == NULL) || (dataSize < 8) || (memcmp(fileData, "VOX ", 4) != 0))
+    {
+        TraceLog(LOG_WARNING, "VOXEL: Invalid .vox file data");
+        return false;
+    }
+
+    const unsigned char *xyziData = NULL;
+    int xyziCount = 0;
+    int sizeX = 0, sizeY = 0, sizeZ = 0;
+    bool hasPalette = false;
+
+    int offset = 8;     // Skip "VOX " and version
+
+    // NOTE: MAIN chunk has no content, its children follow the chunk header, so chunks are read linearly
+    while (offset + 12 <= dataSize)
+    {
+        const unsigned char *chunk = fileData + offset;
+        int contentSize = 0;
+        int childrenSize = 0;
+        memcpy(&contentSize, chunk + 4, sizeof(int));
+        memcpy(&childrenSize, chunk + 8, sizeof(int));
+
+        const unsigned char *content = chunk + 12;
+        if ((contentSize < 0) || (offset + 12 + contentSize > dataSize)) break;
+
+        if ((memcmp(chunk, "SIZE", 4) == 0) && (sizeX == 0) && (contentSize >= 12))
+        {
+            memcpy(&sizeX, content, sizeof(int));
+            memcpy(&sizeY, content + 4, sizeof(int));
+            memcpy(&sizeZ, content + 8, sizeof(int));
+        }
+        else if ((memcmp(chunk, "XYZI", 4) == 0) && (xyziData == NULL) && (contentSize >= 4))
+        {
+            memcpy(&xyziCount, content, sizeof(int));
+            if ((xyziCount < 0) || (4 + xyziCount*4 > contentSize)) xyziCount = 0;
+            xyziData = content + 4;
+        }
+        else if ((memcmp(chunk, "RGBA", 4) == 0) && (contentSize >= 256*4))
+        {
+            // NOTE: Palette entry i maps to color index i + 1
+            for (int i = 0; i < 255; i++) grid->palette[i + 1] = (Color){ content[i*4], content[i*4 + 1], content[i*4 + 2], content[i*4 + 3] };
+            hasPalette = true;
+        }
+
+        // MAIN chunk children are parsed in place, everything else is skipped entirely
+        if (memcmp(chunk, "MAIN", 4) == 0) offset += 12 + contentSize;
+        else offset += 12 + contentSize + childrenSize;
+    }
+
+    if ((sizeX <= 0) || (sizeY <= 0) || (sizeZ <= 0) || (xyziData == NULL))
+    {
+        TraceLog(LOG_WARNING, "VOXEL: .vox file data has no model");
+        return false;
+    }
+
+    if (!hasPalette)
+    {
+        TraceLog(LOG_WARNING, "VOXEL: .vox file data has no palette, using gray");
+        for (int i = 1; i < 256; i++) grid->palette[i] = GRAY;
+    }
+
+    grid->sizeX = sizeX;
+    grid->sizeY = sizeZ;
+    grid->sizeZ = sizeY;
+    grid->voxels = (unsigned char *)RL_CALLOC(grid->sizeX*grid->sizeY*grid->sizeZ, 1);
+
+    *voxelCount = 0;
+
+    for (int i = 0; i < xyziCount; i++)
+    {
+        const unsigned char *voxel = xyziData + i*4;
+        int x = voxel[0];
+        int y = voxel[2];
+        int z = sizeY - voxel[1] - 1;
+
+        if ((x >= grid->sizeX) || (y >= grid->sizeY) || (z < 0) || (voxel[3] == 0)) continue;
+
+        unsigned char *cell = &grid->voxels[(z*grid->sizeY + y)*grid->sizeX + x];
+        if (*cell == 0) (*voxelCount)++;
+        *cell = voxel[3];
+    }
+
+    return true;
+}
+
+// Get voxel color index at grid position, 0 when empty or out of bounds
+static unsigned char GetVoxel(VoxelGrid grid, int x, int y, int z)
+{
+    if ((x < 0) || (y < 0) || (z < 0) || (x >= grid.sizeX) || (y >= grid.sizeY) || (z >= grid.sizeZ)) return 0;
+
+    return grid.voxels[(z*grid.sizeY + y)*grid.sizeX + x];
+}
+
+// Get ambient occlusion of face corners (2 bits per corner, 3: not occluded), air is the empty
+// cell the face looks into and u, v the face plane axes. Corners order: (0, 0), (1, 0), (1, 1), (0, 1)
+// NOTE: Corner with both sides solid is fully occluded, whatever the diagonal voxel is
+static int GetVoxelFaceOcclusion(VoxelGrid grid, const int air[3], int u, int v)
+{
+    int occlusion = 0;
+
+    for (int c = 0; c < 4; c++)
+    {
+        int side1[3] = { air[0], air[1], air[2] };
+        int side2[3] = { air[0], air[1], air[2] };
+        side1[u] += ((c == 1) || (c == 2))? 1 : -1;
+        side2[v] += ((c == 2) || (c == 3))? 1 : -1;
+
+        const int corner[3] = { side1[0] + side2[0] - air[0], side1[1] + side2[1] - air[1], side1[2] + side2[2] - air[2] };
+        const int solid1 = (GetVoxel(grid, side1[0], side1[1], side1[2]) != 0);
+        const int solid2 = (GetVoxel(grid, side2[0], side2[1], side2[2]) != 0);
+        const int solidCorner = (GetVoxel(grid, corner[0], corner[1], corner[2]) != 0);
+
+        const int value = (solid1 && solid2)? 0 : 3 - (solid1 + solid2 + solidCorner);
+        occlusion |= value << (c*2);
+    }
+
+    return occlusion;
+}
+
+// Downsample voxel grid, every block of factor^3 voxels becomes one voxel
+// NOTE: Block is solid when at least a quarter of it is, so thin parts (hoses, frames) survive
+// a level or two, and it takes the most frequent color index of its solid voxels
+static VoxelGrid DownsampleVoxelGrid(VoxelGrid grid, int factor)
+{
+    VoxelGrid lod = { 0 };
+    lod.sizeX = (grid.sizeX + factor - 1)/factor;
+    lod.sizeY = (grid.sizeY + factor - 1)/factor;
+    lod.sizeZ = (grid.sizeZ + factor - 1)/factor;
+    lod.voxels = (unsigned char *)RL_CALLOC(lod.sizeX*lod.sizeY*lod.sizeZ, 1);
+    memcpy(lod.palette, grid.palette, sizeof(grid.palette));
+
+    const int blockVolume = factor*factor*factor;
+    int colorCounts[256] = { 0 };
+
+    for (int z = 0; z < lod.sizeZ; z++)
+    {
+        for (int y = 0; y < lod.sizeY; y++)
+        {
+            for (int x = 0; x < lod.sizeX; x++)
+            {
+                int solidCount = 0;
+                unsigned char colorIndex = 0;       // NOTE: colorCounts[0] stays 0, any solid voxel beats it
+                memset(colorCounts, 0, sizeof(colorCounts));
+
+                for (int k = 0; k < factor; k++)
+                {
+                    for (int j = 0; j < factor; j++)
+                    {
+                        for (int i = 0; i < factor; i++)
+                        {
+                            const unsigned char voxel = GetVoxel(grid, x*factor + i, y*factor + j, z*factor + k);
+                            if (voxel == 0) continue;
+
+                            solidCount++;
+                            colorCounts[voxel]++;
+                            if (colorCounts[voxel] > colorCounts[colorIndex]) colorIndex = voxel;
+                        }
+                    }
+                }
+
+                if (solidCount*4 >= blockVolume) lod.voxels[(z*lod.sizeY + y)*lod.sizeX + x] = colorIndex;
+            }
+        }
+    }
+
+    return lod;
+}
+
+// Generate greedy meshed quads for voxel grid
+// NOTE: For every axis, each slice between two voxel layers gets a mask of visible faces
+// (signed by facing) that is merged into maximal rectangles of the same color, facing and
+// corners occlusion. Faces only merge along a direction their occlusion does not change,
+// so merged quads interpolate the same values the separate faces would
+static VoxelQuad *GenVoxelQuads(VoxelGrid grid, int *quadCount, int *faceCount)
+{
+    const int size[3] = { grid.sizeX, grid.sizeY, grid.sizeZ };
+
+    int maxSliceArea = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        int area = size[(axis + 1)%3]*size[(axis + 2)%3];
+        if (area > maxSliceArea) maxSliceArea = area;
+    }
+
+    int *mask = (int *)RL_MALLOC(maxSliceArea*sizeof(int));
+    int quadCapacity = 256;
+    VoxelQuad *quads = (VoxelQuad *)RL_MALLOC(quadCapacity*sizeof(VoxelQuad));
+
+    *quadCount = 0;
+    *faceCount = 0;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const int u = (axis + 1)%3;
+        const int v = (axis + 2)%3;
+        int pos[3] = { 0 };
+        int step[3] = { 0 };
+        step[axis] = 1;
+
+        for (pos[axis] = -1; pos[axis] < size[axis];)
+        {
+            // Compute faces mask for the slice between layer pos[axis] and pos[axis] + 1
+            int n = 0;
+            for (pos[v] = 0; pos[v] < size[v]; pos[v]++)
+            {
+                for (pos[u] = 0; pos[u] < size[u]; pos[u]++, n++)
+                {
+                    int a = GetVoxel(grid, pos[0], pos[1], pos[2]);
+                    int b = GetVoxel(grid, pos[0] + step[0], pos[1] + step[1], pos[2] + step[2]);
+
+                    if ((a != 0) == (b != 0))
+                    {
+                        mask[n] = 0;
+                        continue;
+                    }
+
+                    // Occlusion is sampled on the empty layer the face looks into
+                    int air[3] = { pos[0], pos[1], pos[2] };
+                    if (a != 0) air[axis]++;
+
+                    const int occlusion = GetVoxelFaceOcclusion(grid, air, u, v) << 8;
+
+                    if (a != 0) mask[n] = a | occlusion;        // Face of voxel a, pointing to positive axis
+                    else mask[n] = -(b | occlusion);            // Face of voxel b, pointing to negative axis
+
+                    (*faceCount)++;
+                }
+            }
+
+            pos[axis]++;
+
+            // Merge mask into maximal rectangles
+            n = 0;
+            for (int j = 0; j < size[v]; j++)
+            {
+                for (int i = 0; i < size[u];)
+                {
+                    int value = mask[n];
+
+                    if (value == 0)
+                    {
+                        i++;
+                        n++;
+                        continue;
+                    }
+
+                    // Corners 0-1 and 3-2 are along u, corners 0-3 and 1-2 along v
+                    const int occlusion = ((value < 0)? -value : value) >> 8;
+                    const int corners[4] = { occlusion & 3, (occlusion >> 2) & 3, (occlusion >> 4) & 3, (occlusion >> 6) & 3 };
+                    const bool mergeU = (corners[0] == corners[1]) && (corners[3] == corners[2]);
+                    const bool mergeV = (corners[0] == corners[3]) && (corners[1] == corners[2]);
+
+                    int width = 1;
+                    while (mergeU && (i + width < size[u]) && (mask[n + width] == value)) width++;
+
+                    int height = 1;
+                    for (; mergeV && (j + height < size[v]); height++)
+                    {
+                        bool rowMatches = true;
+                        for (int k = 0; k < width; k++)
+                        {
+                            if (mask[n + k + height*size[u]] != value) { rowMatches = false; break; }
+                        }
+                        if (!rowMatches) break;
+                    }
+
+                    if (*quadCount == quadCapacity)
+                    {
+                        quadCapacity *= 2;
+                        quads = (VoxelQuad *)RL_REALLOC(quads, quadCapacity*sizeof(VoxelQuad));
+                    }
+
+                    VoxelQuad *quad = &quads[*quadCount];
+                    quad->position[axis] = pos[axis];
+                    quad->position[u] = i;
+                    quad->position[v] = j;
+                    quad->axis = axis;
+                    quad->width = width;
+                    quad->height = height;
+                    quad->backFace = (value < 0);
+                    quad->colorIndex = (unsigned char)(((value < 0)? -value : value) & 0xff);
+                    quad->occlusion = (unsigned char)occlusion;
+                    (*quadCount)++;
+
+                    for (int l = 0; l < height; l++)
+                    {
+                        for (int k = 0; k < width; k++) mask[n + k + l*size[u]] = 0;
+                    }
+
+                    i += width;
+                    n += width;
+                }
+            }
+        }
+    }
+
+    RL_FREE(mask);
+
+    return quads;
+}
+
+// Generate indexed mesh from voxel quads, 4 vertices and 2 triangles per quad
+// NOTE: Vertex colors are palette colors with baked directional light and corner occlusion
+static Mesh GenMeshFromVoxelQuads(VoxelGrid grid, const VoxelQuad *quads, int quadCount, float voxelSize)
+{
+    Mesh mesh = { 0 };
+    mesh.vertexCount = quadCount*4;
+    mesh.triangleCount = quadCount*2;
+    mesh.vertices = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
+    mesh.normals = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
+    mesh.colors = (unsigned char *)RL_MALLOC(mesh.vertexCount*4*sizeof(unsigned char));
+    mesh.indices = (unsigned short *)RL_MALLOC(mesh.triangleCount*3*sizeof(unsigned short));
+
+    for (int q = 0; q < quadCount; q++)
+    {
+        const VoxelQuad *quad = &quads[q];
+        const int u = (quad->axis + 1)%3;
+        const int v = (quad->axis + 2)%3;
+
+        float corners[4][3] = { 0 };
+        for (int c = 0; c < 4; c++)
+        {
+            corners[c][0] = (float)quad->position[0];
+            corners[c][1] = (float)quad->position[1];
+            corners[c][2] = (float)quad->position[2];
+        }
+        corners[1][u] += quad->width;
+        corners[2][u] += quad->width;
+        corners[2][v] += quad->height;
+        corners[3][v] += quad->height;
+
+        float normal[3] = { 0 };
+        normal[quad->axis] = quad->backFace? -1.0f : 1.0f;
+
+        Color color = grid.palette[quad->colorIndex];
+        const float diffuse = normal[0]*lightDirection.x + normal[1]*lightDirection.y + normal[2]*lightDirection.z;
+        const float light = VOXEL_LIGHT_AMBIENT + (1.0f - VOXEL_LIGHT_AMBIENT)*((diffuse > 0.0f)? diffuse : 0.0f);
+
+        int occlusion[4] = { 0 };
+        for (int c = 0; c < 4; c++) occlusion[c] = (quad->occlusion >> (c*2)) & 3;
+
+        for (int c = 0; c < 4; c++)
+        {
+            int vertex = q*4 + c;
+            for (int k = 0; k < 3; k++)
+            {
+                mesh.vertices[vertex*3 + k] = corners[c][k]*voxelSize;
+                mesh.normals[vertex*3 + k] = normal[k];
+            }
+
+            const float shade = light*occlusionLight[occlusion[c]];
+            mesh.colors[vertex*4] = (unsigned char)(color.r*shade);
+            mesh.colors[vertex*4 + 1] = (unsigned char)(color.g*shade);
+            mesh.colors[vertex*4 + 2] = (unsigned char)(color.b*shade);
+            mesh.colors[vertex*4 + 3] = color.a;
+        }
+
+        // NOTE: Corners are counter-clockwise around +axis (u x v = axis), flip winding for back faces.
+        // Quad is split along the diagonal joining its less occluded corners, so a dark corner stays
+        // within one triangle and shading is symmetric
+        unsigned short base = (unsigned short)(q*4);
+        unsigned short *index = &mesh.indices[q*6];
+        const int rotation = (occlusion[0] + occlusion[2] < occlusion[1] + occlusion[3])? 1 : 0;
+        unsigned short corner[4] = { 0 };
+        for (int c = 0; c < 4; c++) corner[c] = base + (unsigned short)((c + rotation)%4);
+        if (!quad->backFace)
+        {
+            index[0] = corner[0]; index[1] = corner[1]; index[2] = corner[2];
+            index[3] = corner[0]; index[4] = corner[2]; index[5] = corner[3];
+        }
+        else
+        {
+            index[0] = corner[0]; index[1] = corner[2]; index[2] = corner[1];
+            index[3] = corner[0]; index[4] = corner[3]; index[5] = corner[2];
+        }
+    }
+
+    return mesh;
+}
+
+// Align file offset to voxel mesh cache alignment
+static unsigned int AlignOffset(unsigned int offset)
+{
+    return (offset + VOXEL_MESH_FILE_ALIGNMENT - 1) & ~(unsigned int)(VOXEL_MESH_FILE_ALIGNMENT - 1);
+}
@@ -0,0 +1,63 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Voxel mesh loader
+*
+*   Loads MagicaVoxel .vox files into greedy-meshed raylib meshes (hidden faces culled,
+*   coplanar faces of the same color merged) and bakes the result into a binary mesh cache
+*   (.vxm) next to the source file. The cache is reused while it is newer than the .vox.
+*
+*   Voxel ambient occlusion and a fixed directional light are baked into vertex colors, so
+*   models look lit when drawn with unlit shaders (DrawModel(), mesh instancing).
+*
+*   Every model gets a chain of levels of detail: full resolution, then the voxel grid
+*   downsampled 2x and 4x, all with the same world size. Level is chosen per draw from the
+*   voxels projected size (GetVoxelLod()), fading between levels over a short range.
+*
+*   NOTE: Voxel models hold their levels of detail as meshes, drawing them with DrawModel()
+*   draws every level, use mesh_instancing LodInstances instead
+*
+**********************************************************************************************/
+
+#ifndef VOXEL_MESH_H
+#define VOXEL_MESH_H
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define VOXEL_MESH_SCALE        0.25f       // World units per voxel, matches raylib LoadModel() for .vox
+#define VOXEL_LOD_COUNT         3           // Levels of detail: full resolution, 2x and 4x downsampled
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Voxel mesh build statistics
+typedef struct VoxelMeshStats {
+    int voxelCount;             // Solid voxels in source file
+    int naiveTriangles;         // Triangles emitting every voxel face
+    int culledTriangles;        // Triangles emitting only visible faces (one quad per face)
+    int greedyTriangles;        // Triangles after greedy meshing
+    int greedyVertices;         // Vertices after greedy meshing
+    int lodTriangles[VOXEL_LOD_COUNT];  // Triangles per level of detail, full resolution first
+} VoxelMeshStats;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Voxel Mesh Functions Declaration
+//----------------------------------------------------------------------------------
+int LoadVoxelMeshLods(const char *fileName, Mesh *lods);    // Load voxel mesh levels of detail from .vox file or its baked cache (not uploaded to GPU), returns levels loaded
+int GenMeshVoxelLodsFromMemory(const unsigned char *fileData, int dataSize, Mesh *lods, VoxelMeshStats *stats); // Generate greedy voxel mesh levels of detail from .vox file data, returns levels generated
+Model LoadVoxelModel(const char *fileName);                 // Load voxel model, levels of detail uploaded to GPU
+Model LoadModelFromVoxelMeshLods(Mesh *lods, int lodCount); // Load voxel model from levels of detail meshes (uploaded to GPU, owned by model)
+bool ExportVoxelMeshCache(const Mesh *lods, int lodCount, const char *fileName);    // Export levels of detail meshes to binary voxel mesh cache file
+int LoadVoxelMeshCache(const char *fileName, Mesh *lods);   // Load levels of detail meshes from binary voxel mesh cache file, returns levels loaded
+int GetVoxelLod(Camera camera, Vector3 position, int lodCount, float *fade);    // Get level of detail for voxels at position (unscaled model), fade [0..1] towards next level
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VOXEL_MESH_H
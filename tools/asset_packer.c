@@ -0,0 +1,332 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Assets packer
+*
+*   Packs resource files into a single indexed archive (.pak) loaded by the game at startup,
+*   see asset_pack.h for the archive layout. Entries are named by their path relative to the
+*   base directory (i.e. "resources/coin.wav"), so the game requests them with the same names
+*   used for loose files. Several base directories can be given, so files generated at build
+*   time (i.e. baked fonts in the build directory) are named as if they were in the sources.
+*   With --lz4, entries are stored LZ4 compressed if that saves at least 10% (already
+*   compressed formats like .ogg and .png are usually kept stored, so they load in place from
+*   the mapped archive).
+*
+*   USAGE: StopThePumpPack [--lz4] [--base dir ...] --output file.pak file [file ...]
+*   Returns 0 if the archive was written, 1 otherwise.
+*
+**********************************************************************************************/
+
+#include "asset_pack.h"
+
+#include <stdio.h>      // Required for: printf(), fprintf(), fopen(), fread(), fwrite()
+#include <stdlib.h>     // Required for: malloc(), calloc(), free(), qsort()
+#include <string.h>     // Required for: strcmp(), strcpy(), strlen(), strncmp(), memcpy(), memcmp()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define LZ4_HASH_BITS           12
+#define LZ4_MIN_MATCH           4
+#define LZ4_MAX_OFFSET          65535
+#define LZ4_LAST_LITERALS       5           // Block must end with at least 5 literals
+#define LZ4_MATCH_LIMIT         12          // Last match must start at least 12 bytes before block end
+
+#define MAX_BASE_DIRS           4
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Packed file, loaded and compressed before writing
+typedef struct PackFile {
+    AssetPackEntry entry;
+    unsigned char *data;            // Stored data (compressed or raw)
+} PackFile;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+static unsigned char *LoadFile(const char *fileName, unsigned int *size);
+static int CompressLZ4(const unsigned char *src, int srcSize, unsigned char *dst, int dstCapacity);
+static int CompareEntryNames(const void *a, const void *b);
+static unsigned int AlignOffset(unsigned int offset);
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    bool compress = false;
+    const char *baseDirs[MAX_BASE_DIRS] = { 0 };
+    int baseDirCount = 0;
+    const char *outputFileName = NULL;
+
+    PackFile *files = (PackFile *)calloc(argc, sizeof(PackFile));
+    int fileCount = 0;
+    bool failed = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--lz4") == 0) compress = true;
+        else if ((strcmp(argv[i], "--base") == 0) && (i + 1 < argc))
+        {
+            if (baseDirCount < MAX_BASE_DIRS) baseDirs[baseDirCount++] = argv[i + 1];
+            else fprintf(stderr, "%s: Too many base directories, ignored\n", argv[i + 1]);
+            i++;
+        }
+        else if ((strcmp(argv[i], "--output") == 0) && (i + 1 < argc)) outputFileName = argv[++i];
+        else
+        {
+            // Entry name is path relative to first matching base directory, with '/' separators
+            const char *name = argv[i];
+            for (int b = 0; (b < baseDirCount) && (name == argv[i]); b++)
+            {
+                const size_t baseLength = strlen(baseDirs[b]);
+                if ((baseLength > 0) && (strncmp(name, baseDirs[b], baseLength) == 0) && ((name[baseLength] == '/') || (name[baseLength] == '\\'))) name += baseLength + 1;
+            }
+
+            if (strlen(name) >= MAX_ASSET_PACK_NAME_LENGTH)
+            {
+                fprintf(stderr, "%s: Name too long for archive index\n", argv[i]);
+                failed = true;
+                continue;
+            }
+
+            PackFile *file = &files[fileCount];
+            strcpy(file->entry.name, name);
+            for (char *c = file->entry.name; *c != '\0'; c++) if (*c == '\\') *c = '/';
+
+            file->data = LoadFile(argv[i], &file->entry.rawSize);
+            if (file->data == NULL)
+            {
+                fprintf(stderr, "%s: FAILED to read file\n", argv[i]);
+                failed = true;
+                continue;
+            }
+
+            file->entry.size = file->entry.rawSize;
+            fileCount++;
+        }
+    }
+
+    if ((outputFileName == NULL) || (fileCount == 0) || failed)
+    {
+        if ((outputFileName == NULL) || (fileCount == 0)) printf("USAGE: StopThePumpPack [--lz4] [--base dir ...] --output file.pak file [file ...]\n");
+        for (int i = 0; i < fileCount; i++) free(files[i].data);
+        free(files);
+        return 1;
+    }
+
+    // Compress entries, every compressed entry is decompressed back and checked
+    for (int i = 0; compress && (i < fileCount); i++)
+    {
+        PackFile *file = &files[i];
+        const int rawSize = (int)file->entry.rawSize;
+        const int capacity = rawSize + rawSize/255 + 16;
+        unsigned char *compressed = (unsigned char *)malloc(capacity);
+        const int compressedSize = CompressLZ4(file->data, rawSize, compressed, capacity);
+
+        if ((compressedSize > 0) && (compressedSize < rawSize - rawSize/10))
+        {
+            unsigned char *check = (unsigned char *)malloc(rawSize);
+            const bool valid = (DecompressLZ4(compressed, compressedSize, check, rawSize) == rawSize) && (memcmp(check, file->data, rawSize) == 0);
+            free(check);
+
+            if (!valid)
+            {
+                fprintf(stderr, "%s: FAILED to compress entry, check failed\n", file->entry.name);
+                failed = true;
+            }
+
+            free(file->data);
+            file->data = compressed;
+            file->entry.size = (unsigned int)compressedSize;
+            file->entry.flags |= ASSET_PACK_FLAG_LZ4;
+        }
+        else free(compressed);
+    }
+
+    // NOTE: Index sorted by name, game looks up entries with binary search
+    qsort(files, fileCount, sizeof(PackFile), CompareEntryNames);
+
+    for (int i = 1; i < fileCount; i++)
+    {
+        if (strcmp(files[i - 1].entry.name, files[i].entry.name) == 0)
+        {
+            fprintf(stderr, "%s: Duplicated archive entry\n", files[i].entry.name);
+            failed = true;
+        }
+    }
+
+    AssetPackHeader header = { 0 };
+    memcpy(header.magic, "STPK", 4);
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = (unsigned int)fileCount;
+    header.indexOffset = sizeof(AssetPackHeader);
+
+    unsigned int offset = AlignOffset(header.indexOffset + fileCount*sizeof(AssetPackEntry));
+    for (int i = 0; i < fileCount; i++)
+    {
+        files[i].entry.offset = offset;
+        offset = AlignOffset(offset + files[i].entry.size);
+    }
+
+    FILE *output = failed? NULL : fopen(outputFileName, "wb");
+    if (output != NULL)
+    {
+        static const unsigned char padding[ASSET_PACK_ALIGNMENT] = { 0 };
+        unsigned int written = 0;
+
+        written += (unsigned int)fwrite(&header, 1, sizeof(AssetPackHeader), output);
+        for (int i = 0; i < fileCount; i++) written += (unsigned int)fwrite(&files[i].entry, 1, sizeof(AssetPackEntry), output);
+
+        for (int i = 0; i < fileCount; i++)
+        {
+            written += (unsigned int)fwrite(padding, 1, files[i].entry.offset - written, output);
+            written += (unsigned int)fwrite(files[i].data, 1, files[i].entry.size, output);
+        }
+
+        if (fclose(output) != 0) failed = true;
+        if (written != files[fileCount - 1].entry.offset + files[fileCount - 1].entry.size) failed = true;
+    }
+    else failed = true;
+
+    if (!failed)
+    {
+        unsigned int rawSize = 0;
+        for (int i = 0; i < fileCount; i++)
+        {
+            printf("  %-40s %8u -> %8u bytes%s\n", files[i].entry.name, files[i].entry.rawSize, files[i].entry.size, (files[i].entry.flags & ASSET_PACK_FLAG_LZ4)? " (lz4)" : "");
+            rawSize += files[i].entry.rawSize;
+        }
+
+        printf("%s: %i entries, %u bytes (%u bytes unpacked)\n", outputFileName, fileCount, files[fileCount - 1].entry.offset + files[fileCount - 1].entry.size, rawSize);
+    }
+    else fprintf(stderr, "%s: FAILED to write archive\n", outputFileName);
+
+    for (int i = 0; i < fileCount; i++) free(files[i].data);
+    free(files);
+
+    return failed? 1 : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load whole file into memory
+static unsigned char *LoadFile(const char *fileName, unsigned int *size)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    // NOTE: Empty files get a 1 byte buffer, so they can still be packed
+    unsigned char *data = (length >= 0)? (unsigned char *)malloc(length + 1) : NULL;
+    if ((data != NULL) && (fread(data, 1, length, file) != (size_t)length))
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    *size = (unsigned int)length;
+
+    return data;
+}
+
+// Compress LZ4 block (greedy, single hash probe), returns compressed size or -1 if it does not fit
+static int CompressLZ4(const unsigned char *src, int srcSize, unsigned char *dst, int dstCapacity)
+{
+    int hashTable[1 << LZ4_HASH_BITS];
+    for (int i = 0; i < (1 << LZ4_HASH_BITS); i++) hashTable[i] = -1;
+
+    int anchor = 0;             // Start of pending literals
+    int position = 0;
+    int output = 0;
+
+    while (position < srcSize - LZ4_MATCH_LIMIT)
+    {
+        unsigned int sequence = 0;
+        memcpy(&sequence, src + position, sizeof(unsigned int));
+        const unsigned int hash = (sequence*2654435761u) >> (32 - LZ4_HASH_BITS);
+        const int reference = hashTable[hash];
+        hashTable[hash] = position;
+
+        unsigned int referenceSequence = 0;
+        if (reference >= 0) memcpy(&referenceSequence, src + reference, sizeof(unsigned int));
+
+        if ((reference < 0) || ((position - reference) > LZ4_MAX_OFFSET) || (referenceSequence != sequence))
+        {
+            position++;
+            continue;
+        }
+
+        int matchLength = LZ4_MIN_MATCH;
+        while ((position + matchLength < srcSize - LZ4_LAST_LITERALS) && (src[reference + matchLength] == src[position + matchLength])) matchLength++;
+
+        // Sequence: token, literals length, literals, offset, match length
+        const int literalLength = position - anchor;
+        if (output + 1 + literalLength/255 + 1 + literalLength + 2 + matchLength/255 + 1 > dstCapacity) return -1;
+
+        unsigned char *token = &dst[output++];
+        *token = (unsigned char)(((literalLength < 15)? literalLength : 15) << 4);
+        if (literalLength >= 15)
+        {
+            int length = literalLength - 15;
+            for (; length >= 255; length -= 255) dst[output++] = 255;
+            dst[output++] = (unsigned char)length;
+        }
+
+        memcpy(dst + output, src + anchor, literalLength);
+        output += literalLength;
+
+        const int offset = position - reference;
+        dst[output++] = (unsigned char)(offset & 0xff);
+        dst[output++] = (unsigned char)(offset >> 8);
+
+        const int extraLength = matchLength - LZ4_MIN_MATCH;
+        *token |= (unsigned char)((extraLength < 15)? extraLength : 15);
+        if (extraLength >= 15)
+        {
+            int length = extraLength - 15;
+            for (; length >= 255; length -= 255) dst[output++] = 255;
+            dst[output++] = (unsigned char)length;
+        }
+
+        position += matchLength;
+        anchor = position;
+    }
+
+    // Last sequence, literals only
+    const int literalLength = srcSize - anchor;
+    if (output + 1 + literalLength/255 + 1 + literalLength > dstCapacity) return -1;
+
+    dst[output++] = (unsigned char)(((literalLength < 15)? literalLength : 15) << 4);
+    if (literalLength >= 15)
+    {
+        int length = literalLength - 15;
+        for (; length >= 255; length -= 255) dst[output++] = 255;
+        dst[output++] = (unsigned char)length;
+    }
+
+    memcpy(dst + output, src + anchor, literalLength);
+    output += literalLength;
+
+    return output;
+}
+
+// Compare archive entries by name, used for sorting
+static int CompareEntryNames(const void *a, const void *b)
+{
+    return strcmp(((const PackFile *)a)->entry.name, ((const PackFile *)b)->entry.name);
+}
+
+// Align offset to entries data alignment
+static unsigned int AlignOffset(unsigned int offset)
+{
+    return (offset + ASSET_PACK_ALIGNMENT - 1) & ~(unsigned int)(ASSET_PACK_ALIGNMENT - 1);
+}
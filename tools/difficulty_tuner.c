@@ -0,0 +1,410 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Difficulty tuner
+*
+*   Headless Monte Carlo simulation of the gameplay rules (game_state.c) played by parametric
+*   bot players. Every combination of the provided parameter lists is simulated on all cores
+*   and the distribution of rounds survived is reported per parameter set.
+*
+*   Bot model: the bot aims to release when price reaches target, its release error is its
+*   reaction time, sampled from a normal distribution, minus a fixed anticipation.
+*
+*   USAGE: StopThePumpTuner [options], lists are comma separated (i.e. --speed 0.15,0.3,0.45)
+*
+**********************************************************************************************/
+
+#include "game_state.h"
+#include "job_pool.h"
+
+#include <math.h>       // Required for: sqrtf(), logf(), cosf()
+#include <stdio.h>      // Required for: printf(), fprintf(), fopen()
+#include <stdlib.h>     // Required for: calloc(), free(), strtod()
+#include <string.h>     // Required for: strcmp()
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>    // Required for: QueryPerformanceCounter()
+#else
+    #include <time.h>       // Required for: clock_gettime()
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_PARAMETER_VALUES    16          // Maximum values per swept parameter
+#define GAMES_PER_JOB           8192        // Games simulated by every job
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Swept parameter values
+typedef struct ParameterList {
+    const char *name;
+    float values[MAX_PARAMETER_VALUES];
+    int count;
+} ParameterList;
+
+enum {
+    PARAM_MIN_CENTS = 0,
+    PARAM_MAX_CENTS,
+    PARAM_SPEED,
+    PARAM_TOLERANCE,
+    PARAM_REACTION_MEAN,
+    PARAM_REACTION_SD,
+    PARAM_ANTICIPATION,
+    PARAM_COUNT
+};
+
+// Bot player parameters (milliseconds)
+typedef struct BotParameters {
+    float reactionMean;
+    float reactionDeviation;
+    float anticipation;
+} BotParameters;
+
+// Simulated parameter set and its merged results
+typedef struct ParameterSet {
+    GameRules rules;
+    BotParameters bot;
+    int *histogram;                 // Games count per rounds survived [0..maxRounds]
+    long long hits;
+    long long rounds;
+} ParameterSet;
+
+// Simulation job, a batch of games of one parameter set
+typedef struct SimulationJob {
+    const ParameterSet *set;
+    int setIndex;
+    int firstGame;
+    int gameCount;
+    int *histogram;                 // Job local results, merged once all jobs finish
+    long long hits;
+    long long rounds;
+} SimulationJob;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static int maxRounds = 200;
+static unsigned long long baseSeed = 0x5354500000000001ULL;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+static unsigned long long SplitMix64(unsigned long long value);
+static unsigned int NextRandom(unsigned long long *state);
+static float NextNormal(unsigned long long *state, float mean, float deviation);
+static void SimulateGames(void *userData);
+static int GetHistogramPercentile(const int *histogram, long long games, float percentile);
+static bool ParseParameterList(ParameterList *list, const char *text);
+static double GetTimeSeconds(void);
+static void PrintUsage(void);
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const GameRules defaultRules = GetDefaultGameRules();
+
+    ParameterList params[PARAM_COUNT] = {
+        { "min-cents", { (float)defaultRules.priceRangeMinCents }, 1 },
+        { "max-cents", { (float)defaultRules.priceRangeMaxCents }, 1 },
+        { "speed", { (float)defaultRules.pumpSpeed/GAME_DOLLAR }, 1 },
+        { "tolerance", { (float)defaultRules.hitTolerance/GAME_DOLLAR }, 1 },
+        { "reaction-mean", { 200.0f }, 1 },
+        { "reaction-sd", { 40.0f }, 1 },
+        { "anticipation", { 200.0f }, 1 },
+    };
+
+    int gamesPerSet = 100000;
+    int threadCount = 0;
+    const char *csvFileName = NULL;
+
+    // Parse command line
+    for (int i = 1; i < argc; i++)
+    {
+        bool parsed = false;
+        const char *value = (i + 1 < argc)? argv[i + 1] : NULL;
+
+        if ((strcmp(argv[i], "--help") == 0) || (strcmp(argv[i], "-h") == 0)) { PrintUsage(); return 0; }
+        else if (value == NULL) parsed = false;
+        else if (strcmp(argv[i], "--games") == 0) { gamesPerSet = atoi(value); parsed = (gamesPerSet > 0); }
+        else if (strcmp(argv[i], "--threads") == 0) { threadCount = atoi(value); parsed = (threadCount >= 0); }
+        else if (strcmp(argv[i], "--max-rounds") == 0) { maxRounds = atoi(value); parsed = (maxRounds > 0); }
+        else if (strcmp(argv[i], "--seed") == 0) { baseSeed = strtoull(value, NULL, 0); parsed = true; }
+        else if (strcmp(argv[i], "--csv") == 0) { csvFileName = value; parsed = true; }
+        else
+        {
+            for (int p = 0; p < PARAM_COUNT; p++)
+            {
+                if ((strncmp(argv[i], "--", 2) == 0) && (strcmp(argv[i] + 2, params[p].name) == 0)) parsed = ParseParameterList(&params[p], value);
+            }
+        }
+
+        if (!parsed)
+        {
+            fprintf(stderr, "Invalid argument: %s\n\n", argv[i]);
+            PrintUsage();
+            return 1;
+        }
+
+        i++;
+    }
+
+    // Build parameter sets as the cartesian product of all parameter lists
+    int setCount = 1;
+    for (int p = 0; p < PARAM_COUNT; p++) setCount *= params[p].count;
+
+    ParameterSet *sets = (ParameterSet *)calloc(setCount, sizeof(ParameterSet));
+
+    for (int s = 0; s < setCount; s++)
+    {
+        float value[PARAM_COUNT] = { 0 };
+        int remainder = s;
+        for (int p = PARAM_COUNT - 1; p >= 0; p--)
+        {
+            value[p] = params[p].values[remainder%params[p].count];
+            remainder /= params[p].count;
+        }
+
+        sets[s].rules = defaultRules;
+        sets[s].rules.priceRangeMinCents = (int)value[PARAM_MIN_CENTS];
+        sets[s].rules.priceRangeMaxCents = (int)value[PARAM_MAX_CENTS];
+        sets[s].rules.pumpSpeed = (int)(value[PARAM_SPEED]*GAME_DOLLAR + 0.5f);         // NOTE: Dollars on command line
+        sets[s].rules.hitTolerance = (int)(value[PARAM_TOLERANCE]*GAME_DOLLAR + 0.5f);
+        sets[s].bot.reactionMean = value[PARAM_REACTION_MEAN];
+        sets[s].bot.reactionDeviation = value[PARAM_REACTION_SD];
+        sets[s].bot.anticipation = value[PARAM_ANTICIPATION];
+        sets[s].histogram = (int *)calloc(maxRounds + 1, sizeof(int));
+    }
+
+    // Split games in jobs and run them on the work-stealing pool
+    int jobsPerSet = (gamesPerSet + GAMES_PER_JOB - 1)/GAMES_PER_JOB;
+    int jobCount = setCount*jobsPerSet;
+    SimulationJob *jobs = (SimulationJob *)calloc(jobCount, sizeof(SimulationJob));
+
+    JobPool *pool = LoadJobPool(threadCount);
+
+    printf("Simulating %i parameter sets x %i games on %i threads...\n", setCount, gamesPerSet, GetJobPoolWorkerCount(pool));
+    double startTime = GetTimeSeconds();
+
+    for (int j = 0; j < jobCount; j++)
+    {
+        SimulationJob *job = &jobs[j];
+        job->setIndex = j/jobsPerSet;
+        job->set = &sets[job->setIndex];
+        job->firstGame = (j%jobsPerSet)*GAMES_PER_JOB;
+        job->gameCount = (job->firstGame + GAMES_PER_JOB <= gamesPerSet)? GAMES_PER_JOB : gamesPerSet - job->firstGame;
+        job->histogram = (int *)calloc(maxRounds + 1, sizeof(int));
+
+        SubmitJob(pool, SimulateGames, job);
+    }
+
+    WaitJobs(pool);
+
+    double elapsedTime = GetTimeSeconds() - startTime;
+    UnloadJobPool(pool);
+
+    // Merge job results, independent of scheduling so results only depend on seed
+    for (int j = 0; j < jobCount; j++)
+    {
+        ParameterSet *set = &sets[jobs[j].setIndex];
+        for (int r = 0; r <= maxRounds; r++) set->histogram[r] += jobs[j].histogram[r];
+        set->hits += jobs[j].hits;
+        set->rounds += jobs[j].rounds;
+        free(jobs[j].histogram);
+    }
+
+    printf("Simulated %lld games in %.2f s (%.0f games/s)\n\n", (long long)setCount*gamesPerSet, elapsedTime, (double)setCount*gamesPerSet/elapsedTime);
+
+    // Report rounds survived distribution per parameter set
+    printf("%4s %5s %5s %6s %6s %6s %6s %6s | %7s %4s %4s %4s %4s %6s %7s\n",
+        "set", "min", "max", "speed", "tol", "react", "sd", "antic", "mean", "p10", "p50", "p90", "max", "hit%", "capped");
+
+    for (int s = 0; s < setCount; s++)
+    {
+        const ParameterSet *set = &sets[s];
+        int maxSurvived = 0;
+        for (int r = 0; r <= maxRounds; r++) if (set->histogram[r] > 0) maxSurvived = r;
+
+        printf("%4i %5i %5i %6.3f %6.3f %6.0f %6.0f %6.0f | %7.2f %4i %4i %4i %4i %6.1f %7i\n", s,
+            set->rules.priceRangeMinCents, set->rules.priceRangeMaxCents, (float)set->rules.pumpSpeed/GAME_DOLLAR, (float)set->rules.hitTolerance/GAME_DOLLAR,
+            set->bot.reactionMean, set->bot.reactionDeviation, set->bot.anticipation,
+            (double)set->rounds/gamesPerSet,
+            GetHistogramPercentile(set->histogram, gamesPerSet, 0.1f),
+            GetHistogramPercentile(set->histogram, gamesPerSet, 0.5f),
+            GetHistogramPercentile(set->histogram, gamesPerSet, 0.9f),
+            maxSurvived, (set->rounds > 0)? 100.0*set->hits/set->rounds : 0.0, set->histogram[maxRounds]);
+    }
+
+    if (csvFileName != NULL)
+    {
+        FILE *csvFile = fopen(csvFileName, "wt");
+
+        if (csvFile != NULL)
+        {
+            fprintf(csvFile, "set,min_cents,max_cents,speed,tolerance,reaction_mean,reaction_sd,anticipation,rounds,games\n");
+
+            for (int s = 0; s < setCount; s++)
+            {
+                const ParameterSet *set = &sets[s];
+                for (int r = 0; r <= maxRounds; r++)
+                {
+                    if (set->histogram[r] == 0) continue;
+
+                    fprintf(csvFile, "%i,%i,%i,%.4f,%.4f,%.1f,%.1f,%.1f,%i,%i\n", s,
+                        set->rules.priceRangeMinCents, set->rules.priceRangeMaxCents, (float)set->rules.pumpSpeed/GAME_DOLLAR, (float)set->rules.hitTolerance/GAME_DOLLAR,
+                        set->bot.reactionMean, set->bot.reactionDeviation, set->bot.anticipation, r, set->histogram[r]);
+                }
+            }
+
+            fclose(csvFile);
+            printf("\nHistograms written to %s\n", csvFileName);
+        }
+        else fprintf(stderr, "Failed to open %s\n", csvFileName);
+    }
+
+    for (int s = 0; s < setCount; s++) free(sets[s].histogram);
+    free(sets);
+    free(jobs);
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// SplitMix64 hash, used to derive independent per-game random seeds
+static unsigned long long SplitMix64(unsigned long long value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30))*0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27))*0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Get next random value (xorshift64*)
+static unsigned int NextRandom(unsigned long long *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (unsigned int)((*state*0x2545F4914F6CDD1DULL) >> 32);
+}
+
+// Get next normal distributed random value (Box-Muller)
+static float NextNormal(unsigned long long *state, float mean, float deviation)
+{
+    float u1 = (NextRandom(state) + 1.0f)/4294967296.0f;
+    float u2 = NextRandom(state)/4294967296.0f;
+
+    return mean + deviation*sqrtf(-2.0f*logf(u1))*cosf(6.28318531f*u2);
+}
+
+// Simulate a batch of games, job function
+static void SimulateGames(void *userData)
+{
+    SimulationJob *job = (SimulationJob *)userData;
+    const GameRules rules = job->set->rules;
+    const BotParameters bot = job->set->bot;
+
+    for (int g = 0; g < job->gameCount; g++)
+    {
+        unsigned long long rng = SplitMix64(baseSeed ^ SplitMix64(((unsigned long long)job->setIndex << 32) | (unsigned int)(job->firstGame + g)));
+
+        GameState state = { 0 };
+        InitGameState(&state, rules, NextRandom(&rng));
+
+        while (state.gameRunning && (state.rounds < maxRounds))
+        {
+            // Bot holds the trigger from round start until its reaction-delayed release
+            float reaction = NextNormal(&rng, bot.reactionMean, bot.reactionDeviation);
+            if (reaction < 0.0f) reaction = 0.0f;
+
+            double releaseTime = (double)state.targetPrice/rules.pumpSpeed + (reaction - bot.anticipation)/1000.0;
+            int holdSteps = (int)(releaseTime*GAME_STEP_RATE + 0.5);
+            if (holdSteps < 1) holdSteps = 1;
+
+            UpdateGameStateSteps(&state, (GameInput){ .pumpDown = true }, holdSteps);
+            GameEvent event = UpdateGameState(&state, (GameInput){ .pumpDown = false });
+
+            if (event == GAME_EVENT_ROUND_HIT) job->hits++;
+        }
+
+        job->histogram[state.rounds]++;
+        job->rounds += state.rounds;
+    }
+}
+
+// Get rounds survived at percentile from histogram
+static int GetHistogramPercentile(const int *histogram, long long games, float percentile)
+{
+    long long threshold = (long long)(games*percentile);
+    long long accumulated = 0;
+
+    for (int r = 0; r <= maxRounds; r++)
+    {
+        accumulated += histogram[r];
+        if (accumulated > threshold) return r;
+    }
+
+    return maxRounds;
+}
+
+// Parse comma separated parameter values list
+static bool ParseParameterList(ParameterList *list, const char *text)
+{
+    list->count = 0;
+
+    while ((*text != '\0') && (list->count < MAX_PARAMETER_VALUES))
+    {
+        char *end = NULL;
+        list->values[list->count] = (float)strtod(text, &end);
+        if (end == text) return false;
+
+        list->count++;
+        text = end;
+        if (*text == ',') text++;
+    }
+
+    return (list->count > 0) && (*text == '\0');
+}
+
+// Get monotonic wall clock time in seconds
+static double GetTimeSeconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter = { 0 };
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec now = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+#endif
+}
+
+// Print command line usage
+static void PrintUsage(void)
+{
+    printf("USAGE: StopThePumpTuner [options]\n\n"
+        "Parameter lists (comma separated, every combination is simulated):\n"
+        "    --min-cents LIST        Target price range minimum in cents\n"
+        "    --max-cents LIST        Target price range maximum in cents\n"
+        "    --speed LIST            Pump speed in dollars per second\n"
+        "    --tolerance LIST        Hit tolerance in dollars\n"
+        "    --reaction-mean LIST    Bot reaction time mean in ms\n"
+        "    --reaction-sd LIST      Bot reaction time standard deviation in ms\n"
+        "    --anticipation LIST     Bot anticipation in ms, released ahead of reaching target\n\n"
+        "Options:\n"
+        "    --games N               Games simulated per parameter set (default 100000)\n"
+        "    --threads N             Worker threads (default one per processor)\n"
+        "    --max-rounds N          Rounds cap per game (default 200)\n"
+        "    --seed N                Random seed\n"
+        "    --csv FILE              Write rounds survived histograms as CSV\n");
+}
@@ -0,0 +1,68 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - SDF font baker
+*
+*   Bakes a raylib image font (glyphs separated by magenta key color, i.e. resources/mecha.png)
+*   into a signed distance field font file (.sdf, see sdf_font.c for the layout), loaded by the
+*   game as a regular font asset and drawn with the SDF text shader at any size.
+*
+*   NOTE: Only raylib image loading is used (CPU side), no window or GPU context is created
+*
+*   USAGE: StopThePumpFontBaker [--first codepoint] --output file.sdf image.png
+*   Returns 0 if the font was written, 1 otherwise.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "sdf_font.h"
+
+#include <stdio.h>      // Required for: printf(), fprintf()
+#include <stdlib.h>     // Required for: atoi()
+#include <string.h>     // Required for: strcmp()
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const char *inputFileName = NULL;
+    const char *outputFileName = NULL;
+    int firstChar = 32;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--first") == 0) && (i + 1 < argc)) firstChar = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--output") == 0) && (i + 1 < argc)) outputFileName = argv[++i];
+        else inputFileName = argv[i];
+    }
+
+    if ((inputFileName == NULL) || (outputFileName == NULL))
+    {
+        printf("USAGE: StopThePumpFontBaker [--first codepoint] --output file.sdf image.png\n");
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    Image image = LoadImage(inputFileName);
+    if (image.data == NULL)
+    {
+        fprintf(stderr, "%s: FAILED to load image font\n", inputFileName);
+        return 1;
+    }
+
+    Image atlas = { 0 };
+    Font font = GenFontSdfFromImage(image, MAGENTA, firstChar, &atlas);
+    UnloadImage(image);
+
+    const bool success = (font.glyphCount > 0) && ExportFontSdf(font, atlas, outputFileName);
+
+    if (success) printf("%s: %i glyphs, base size %i, atlas %ix%i\n", outputFileName, font.glyphCount, font.baseSize, atlas.width, atlas.height);
+    else fprintf(stderr, "%s: FAILED to bake SDF font\n", outputFileName);
+
+    UnloadFontData(font.glyphs, font.glyphCount);
+    RL_FREE(font.recs);
+    UnloadImage(atlas);
+
+    return success? 0 : 1;
+}
@@ -0,0 +1,163 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Game state test
+*
+*   Headless checks over gameplay rules, no window or GPU required. Sessions with random
+*   pump speeds and hold times are played step by step and checked against:
+*     - Displayed price: cents shown by the pump display at every step are the ones scored
+*       if the pump is stopped on that step
+*     - Bulk update: UpdateGameStateSteps() gives the same state as single steps
+*     - Replays: recorded sessions survive export/load and simulate to the same outcome
+*
+*   USAGE: StopThePumpGameStateTest [sessions]
+*   Returns 0 if all checks pass, 1 otherwise.
+*
+**********************************************************************************************/
+
+#include "game_state.h"
+#include "replay.h"
+
+#include <stdio.h>      // Required for: printf(), fprintf()
+#include <stdlib.h>     // Required for: atoi(), abs(), free()
+#include <string.h>     // Required for: memcmp()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define DEFAULT_SESSIONS        500         // Sessions played if not set by command line
+#define MAX_HOLD_STEPS          3000        // Maximum pump trigger hold per round (steps)
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static int failedCount = 0;
+static unsigned int randomState = 1;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+static void Check(bool condition, const char *check, unsigned int seed, int round);
+static int GetTestRandomValue(int min, int max);   // Test inputs random generator, independent of session ones
+static bool IsSameGameState(const GameState *a, const GameState *b);
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const int sessions = (argc > 1)? atoi(argv[1]) : DEFAULT_SESSIONS;
+    int roundCount = 0;
+
+    for (unsigned int seed = 1; seed <= (unsigned int)sessions; seed++)
+    {
+        // NOTE: Pump speed from 1x to 5x default, so pump steps cover many fixed-point fractions
+        GameRules rules = GetDefaultGameRules();
+        rules.pumpSpeed = rules.pumpSpeed*(int)(10 + seed%41)/10;
+
+        GameState stepped = { 0 };
+        GameState bulk = { 0 };
+        InitGameState(&stepped, rules, seed);
+        InitGameState(&bulk, rules, seed);
+
+        GameReplay replay = { 0 };
+        InitReplayRecording(&replay, seed, rules);
+        randomState = seed;
+
+        while (stepped.gameRunning)
+        {
+            const int holdSteps = GetTestRandomValue(1, MAX_HOLD_STEPS);
+            const GameInput pump = { .pumpDown = true };
+            const GameInput stop = { .pumpDown = false };
+
+            for (int i = 0; i < holdSteps; i++)
+            {
+                UpdateGameState(&stepped, pump);
+                RecordReplayStep(&replay, pump);
+
+                // Displayed cents at the end of the step (interpolation alpha 1.0) must be the scored ones,
+                // checked on a copy stopped right now
+                const int displayedCents = GetGamePriceCents(GetGameStatePrice(&stepped, 1.0f));
+                GameState stopped = stepped;
+                UpdateGameState(&stopped, stop);
+                Check(abs(displayedCents*GAME_CENT - stepped.targetPrice) == stopped.lastRoundDelta, "displayed price", seed, stepped.rounds);
+
+                // Interpolated price never shows cents outside the last step
+                const int halfStepCents = GetGamePriceCents(GetGameStatePrice(&stepped, 0.5f));
+                Check((halfStepCents >= GetGamePriceCents(stepped.previousPrice)) && (halfStepCents <= displayedCents), "interpolated price", seed, stepped.rounds);
+            }
+
+            UpdateGameStateSteps(&bulk, pump, holdSteps);
+            Check(IsSameGameState(&stepped, &bulk), "bulk pumping", seed, stepped.rounds);
+
+            const int shownCents = GetGamePriceCents(stepped.currentPrice);
+            const int targetPrice = stepped.targetPrice;     // NOTE: Next round target is drawn on stop
+            const int previousScore = stepped.score;
+            const GameEvent event = UpdateGameState(&stepped, stop);
+            RecordReplayStep(&replay, stop);
+            UpdateGameStateSteps(&bulk, stop, 1);
+            roundCount++;
+
+            const int roundDelta = abs(shownCents*GAME_CENT - targetPrice);
+            const int expectedScore = ((event == GAME_EVENT_ROUND_HIT)? (((previousScore - rules.hitReward) > 0)? previousScore - rules.hitReward : 0) : previousScore) + roundDelta;
+            Check((event == GAME_EVENT_ROUND_HIT) == (roundDelta < rules.hitTolerance), "round hit", seed, stepped.rounds);
+            Check(stepped.score == expectedScore, "round score", seed, stepped.rounds);
+            Check(IsSameGameState(&stepped, &bulk), "bulk stop", seed, stepped.rounds);
+        }
+
+        EndReplayRecording(&replay, &stepped);
+
+        int dataSize = 0;
+        unsigned char *data = ExportReplayToMemory(&replay, &dataSize);
+        GameReplay loaded = LoadReplayFromMemory(data, dataSize);
+        free(data);
+
+        Check(IsReplayValid(loaded), "replay load", seed, stepped.rounds);
+        if (IsReplayValid(loaded))
+        {
+            Check((loaded.seed == replay.seed) && (memcmp(&loaded.rules, &replay.rules, sizeof(GameRules)) == 0) &&
+                (loaded.endTick == replay.endTick) && (loaded.rounds == replay.rounds) && (loaded.score == replay.score), "replay header", seed, stepped.rounds);
+
+            const GameState simulated = SimulateReplay(&loaded);
+            Check((simulated.rounds == stepped.rounds) && (simulated.score == stepped.score), "replay outcome", seed, stepped.rounds);
+        }
+
+        UnloadReplay(&loaded);
+        UnloadReplay(&replay);
+    }
+
+    printf("%i sessions, %i rounds, %i checks failed\n", sessions, roundCount, failedCount);
+
+    return (failedCount > 0)? 1 : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Check condition, reporting first failures
+static void Check(bool condition, const char *check, unsigned int seed, int round)
+{
+    if (condition) return;
+
+    if (failedCount < 20) fprintf(stderr, "FAILED: %s, seed %u, round %i\n", check, seed, round);
+    failedCount++;
+}
+
+// Get random value between min and max (both included), xorshift32
+static int GetTestRandomValue(int min, int max)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return min + (int)(randomState%(unsigned int)(max - min + 1));
+}
+
+// Check if game states are the same, field by field (padding is not compared)
+static bool IsSameGameState(const GameState *a, const GameState *b)
+{
+    return (a->randomState == b->randomState) && (a->tick == b->tick) && (a->priceFraction == b->priceFraction) &&
+        (a->currentPrice == b->currentPrice) && (a->previousPrice == b->previousPrice) && (a->targetPrice == b->targetPrice) &&
+        (a->lastRoundDelta == b->lastRoundDelta) && (a->score == b->score) && (a->rounds == b->rounds) &&
+        (a->isPumping == b->isPumping) && (a->gameRunning == b->gameRunning);
+}
@@ -0,0 +1,242 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Particle kernels benchmark
+*
+*   Headless microbenchmark of the particle update kernels (particle_kernels.c): the scalar
+*   and SIMD kernels update the same particles for a number of frames, time per update is
+*   reported for both, and the final particles are compared so both kernels are known to
+*   produce the same results.
+*
+*   NOTE: Particles never die during the run (no floor, long life), so every frame updates
+*   the full count. Compaction is timed separately, on a frame killing a tenth of them.
+*
+*   USAGE: StopThePumpParticleBench [--count N] [--frames N]
+*
+**********************************************************************************************/
+
+#include "particle_kernels.h"
+
+#include <math.h>       // Required for: fabsf()
+#include <stdio.h>      // Required for: printf(), fprintf()
+#include <stdlib.h>     // Required for: atoi()
+#include <string.h>     // Required for: strcmp()
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>    // Required for: QueryPerformanceCounter()
+#else
+    #include <time.h>       // Required for: clock_gettime()
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define WARMUP_FRAMES           10          // Frames updated before timing, caches and clocks settle
+#define UPDATE_BUDGET_MS        1.0         // Update time budget per frame (milliseconds)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef void (*UpdateKernel)(ParticleArrays *particles, ParticleForces forces, float deltaTime);
+
+// Kernel timing results (milliseconds per update)
+typedef struct KernelTiming {
+    double average;
+    double minimum;
+    double maximum;
+} KernelTiming;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//----------------------------------------------------------------------------------
+static void InitBenchParticles(ParticleArrays *particles, int count);  // Fill particles with a fixed pseudo-random state
+static KernelTiming TimeKernel(UpdateKernel kernel, ParticleArrays *particles, ParticleForces forces, int frames);  // Time kernel updates
+static double TimeCompaction(ParticleArrays *particles);                // Time compaction of a frame killing a tenth of particles
+static float GetMaxDifference(const ParticleArrays *a, const ParticleArrays *b);  // Get maximum absolute difference of positions and velocities
+static double GetTimeSeconds(void);                                    // Get monotonic wall clock time in seconds
+static void PrintUsage(void);                                           // Print command line usage
+
+//----------------------------------------------------------------------------------
+// Program main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int count = 100000;
+    int frames = 1000;
+
+    // Parse command line
+    for (int i = 1; i < argc; i++)
+    {
+        bool parsed = false;
+        const char *value = (i + 1 < argc)? argv[i + 1] : NULL;
+
+        if ((strcmp(argv[i], "--help") == 0) || (strcmp(argv[i], "-h") == 0)) { PrintUsage(); return 0; }
+        else if (value == NULL) parsed = false;
+        else if (strcmp(argv[i], "--count") == 0) { count = atoi(value); parsed = (count > 0); }
+        else if (strcmp(argv[i], "--frames") == 0) { frames = atoi(value); parsed = (frames > 0); }
+
+        if (!parsed)
+        {
+            fprintf(stderr, "Invalid argument: %s\n\n", argv[i]);
+            PrintUsage();
+            return 1;
+        }
+
+        i++;
+    }
+
+    ParticleArrays scalar = { 0 };
+    ParticleArrays simd = { 0 };
+
+    if (!LoadParticleArrays(&scalar, count) || !LoadParticleArrays(&simd, count))
+    {
+        fprintf(stderr, "Failed to allocate %i particles\n", count);
+        UnloadParticleArrays(&scalar);
+        UnloadParticleArrays(&simd);
+        return 1;
+    }
+
+    InitBenchParticles(&scalar, count);
+    InitBenchParticles(&simd, count);
+
+    const ParticleForces forces = { 9.8f, 0.5f, -1e30f };
+
+    printf("Particle kernels: %i particles, %i frames, SIMD kernel: %s\n\n", count, frames, GetParticleKernelName());
+
+    const KernelTiming scalarTiming = TimeKernel(UpdateParticlesScalar, &scalar, forces, frames);
+    const KernelTiming simdTiming = TimeKernel(UpdateParticlesSimd, &simd, forces, frames);
+
+    printf("%-8s %12s %12s %12s %14s\n", "kernel", "avg (ms)", "min (ms)", "max (ms)", "Mparticles/s");
+    printf("%-8s %12.4f %12.4f %12.4f %14.1f\n", "scalar", scalarTiming.average, scalarTiming.minimum, scalarTiming.maximum, count/(scalarTiming.average*1000.0));
+    printf("%-8s %12.4f %12.4f %12.4f %14.1f\n", GetParticleKernelName(), simdTiming.average, simdTiming.minimum, simdTiming.maximum, count/(simdTiming.average*1000.0));
+    printf("\nSpeedup: %.2fx\n", scalarTiming.average/simdTiming.average);
+
+    // NOTE: Both kernels run the same operations in the same order, results only differ if the
+    // compiler contracted scalar multiply-adds into fused ones
+    const float difference = GetMaxDifference(&scalar, &simd);
+    printf("Max difference scalar vs %s: %g\n", GetParticleKernelName(), difference);
+
+    const double compactionTime = TimeCompaction(&simd);
+    const double frameTime = simdTiming.average + compactionTime;
+    printf("Compaction (10%% dead): %.4f ms\n", compactionTime);
+    printf("Update + compaction: %.4f ms, budget %.1f ms: %s\n", frameTime, UPDATE_BUDGET_MS, (frameTime < UPDATE_BUDGET_MS)? "OK" : "OVER BUDGET");
+
+    UnloadParticleArrays(&scalar);
+    UnloadParticleArrays(&simd);
+
+    return (frameTime < UPDATE_BUDGET_MS)? 0 : 2;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition (local)
+//----------------------------------------------------------------------------------
+
+// Fill particles with a fixed pseudo-random state
+static void InitBenchParticles(ParticleArrays *particles, int count)
+{
+    unsigned int state = 0x2545f491u;
+
+    for (int i = 0; i < count; i++)
+    {
+        float values[6] = { 0 };
+        for (int k = 0; k < 6; k++)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            values[k] = (float)(state >> 8)/16777216.0f*2.0f - 1.0f;
+        }
+
+        particles->positionX[i] = values[0]*10.0f;
+        particles->positionY[i] = values[1]*10.0f + 10.0f;
+        particles->positionZ[i] = values[2]*10.0f;
+        particles->velocityX[i] = values[3]*2.0f;
+        particles->velocityY[i] = values[4]*2.0f + 3.0f;
+        particles->velocityZ[i] = values[5]*2.0f;
+        particles->life[i] = 1e9f;
+        particles->size[i] = 0.05f;
+        particles->color[i] = 0xff28b4ffu;
+    }
+
+    particles->count = count;
+}
+
+// Time kernel updates, one timing per frame (60 Hz steps)
+static KernelTiming TimeKernel(UpdateKernel kernel, ParticleArrays *particles, ParticleForces forces, int frames)
+{
+    KernelTiming timing = { 0.0, 1e30, 0.0 };
+
+    for (int i = 0; i < WARMUP_FRAMES; i++) kernel(particles, forces, 1.0f/60.0f);
+
+    double total = 0.0;
+
+    for (int i = 0; i < frames; i++)
+    {
+        const double start = GetTimeSeconds();
+        kernel(particles, forces, 1.0f/60.0f);
+        const double time = (GetTimeSeconds() - start)*1000.0;
+
+        total += time;
+        if (time < timing.minimum) timing.minimum = time;
+        if (time > timing.maximum) timing.maximum = time;
+    }
+
+    timing.average = total/frames;
+
+    return timing;
+}
+
+// Time compaction of a frame killing a tenth of particles
+static double TimeCompaction(ParticleArrays *particles)
+{
+    for (int i = 0; i < particles->count; i += 10) particles->life[i] = 0.0f;
+
+    const double start = GetTimeSeconds();
+    CompactParticles(particles);
+
+    return (GetTimeSeconds() - start)*1000.0;
+}
+
+// Get maximum absolute difference of positions and velocities
+static float GetMaxDifference(const ParticleArrays *a, const ParticleArrays *b)
+{
+    const float *arraysA[6] = { a->positionX, a->positionY, a->positionZ, a->velocityX, a->velocityY, a->velocityZ };
+    const float *arraysB[6] = { b->positionX, b->positionY, b->positionZ, b->velocityX, b->velocityY, b->velocityZ };
+    float difference = 0.0f;
+
+    for (int k = 0; k < 6; k++)
+    {
+        for (int i = 0; i < a->count; i++)
+        {
+            const float d = fabsf(arraysA[k][i] - arraysB[k][i]);
+            if (d > difference) difference = d;
+        }
+    }
+
+    return difference;
+}
+
+// Get monotonic wall clock time in seconds
+static double GetTimeSeconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter = { 0 };
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec now = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+#endif
+}
+
+// Print command line usage
+static void PrintUsage(void)
+{
+    printf("USAGE: StopThePumpParticleBench [options]\n\n"
+        "Options:\n"
+        "    --count N               Particles updated every frame (default 100000)\n"
+        "    --frames N              Frames timed per kernel (default 1000)\n");
+}
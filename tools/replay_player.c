@@ -0,0 +1,109 @@
+/**********************************************************************************************
+*
+*   Stop the Pump - Replay player
+*
+*   Headless playback of recorded sessions (.stpr), no window or GPU required. Every replay
+*   is fast-forwarded through the gameplay simulation and its outcome checked against the
+*   recorded one, so a corpus of sessions can be used as regression test over game rules.
+*
+*   USAGE: StopThePumpReplay [--verbose] file.stpr [file.stpr ...]
+*   Returns 0 if all replays reproduce their recorded outcome, 1 otherwise.
+*
+**********************************************************************************************/
+
+#include "game_state.h"
+#include "replay.h"
+
+#include <stdio.h>      // Required for: printf(), fprintf()
+#include <string.h>     // Required for: strcmp()
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>    // Required for: QueryPerformanceCounter()
+#else
+    #include <time.h>       // Required for: clock_gettime()
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetTimeSeconds(void);
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    bool verbose = false;
+    int replayCount = 0;
+    int failedCount = 0;
+    double simulatedTime = 0.0;
+    double elapsedTime = 0.0;
+
+    if (argc < 2)
+    {
+        printf("USAGE: StopThePumpReplay [--verbose] file.stpr [file.stpr ...]\n");
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--verbose") == 0) { verbose = true; continue; }
+
+        GameReplay replay = LoadReplay(argv[i]);
+        replayCount++;
+
+        if (!IsReplayValid(replay))
+        {
+            fprintf(stderr, "%s: FAILED to load replay\n", argv[i]);
+            failedCount++;
+            continue;
+        }
+
+        const double startTime = GetTimeSeconds();
+        const GameState state = SimulateReplay(&replay);
+        elapsedTime += GetTimeSeconds() - startTime;
+        simulatedTime += (double)state.tick*GAME_STEP_TIME;
+
+        // NOTE: Simulation is bit-exact, so outcome must match exactly
+        const bool matches = (state.rounds == replay.rounds) && (state.score == replay.score);
+        if (!matches) failedCount++;
+
+        if (verbose || !matches)
+        {
+            printf("%s: %s seed %u, speed %.3f, %u steps (%.1f s), rounds %i, score $%.2f",
+                argv[i], matches? "OK" : "MISMATCH", replay.seed, (float)replay.rules.pumpSpeed/GAME_DOLLAR,
+                state.tick, state.tick*GAME_STEP_TIME, state.rounds, (float)state.score/GAME_DOLLAR);
+
+            if (!matches) printf(" (recorded rounds %i, score $%.2f)", replay.rounds, (float)replay.score/GAME_DOLLAR);
+            printf("\n");
+        }
+
+        UnloadReplay(&replay);
+    }
+
+    printf("%i replays, %i failed, %.1f s of gameplay simulated in %.3f ms (%.0fx real time)\n",
+        replayCount, failedCount, simulatedTime, elapsedTime*1000.0, (elapsedTime > 0.0)? simulatedTime/elapsedTime : 0.0);
+
+    return (failedCount > 0)? 1 : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Get monotonic wall clock time in seconds
+static double GetTimeSeconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter = { 0 };
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec now = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+#endif
+}